@@ -0,0 +1,12 @@
+#pragma once
+
+namespace cc {
+
+//NOTE: bulk copies are limited to types without padding, whose bytes are all value. Float members
+// rule out std::has_unique_object_representations, so a padding free type holding them (vec, mat)
+// opts in by specializing this to true. The specialization goes next to the type, every user of
+// the serializer has to see it. Kept apart from serializer.hpp so that costs no more than this
+template<typename T>
+inline constexpr bool enable_bulk_copy = false;
+
+} // namespace cc
@@ -4,6 +4,7 @@
 #include <concepts>
 #include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <type_traits>
 
@@ -28,9 +29,11 @@ concept writer = requires(T t, std::span<const std::byte> buf) {
     { t.is_open() } -> std::convertible_to<bool>;
 };
 
+//NOTE: read_line() either returns an owned line or a view valid until the next read
 template<typename T>
 concept line_reader = reader<T> && requires(T t) {
-    { t.read_line() } -> std::same_as<result<std::string>>;
+    requires std::same_as<decltype(t.read_line()), result<std::string>> ||
+             std::same_as<decltype(t.read_line()), result<std::string_view>>;
 };
 
 template<typename T>
@@ -6,6 +6,17 @@
 #include "error.hpp"
 #include "result.hpp"
 #include "concepts.hpp"
+#include "serializer.hpp"
+#include "memory.hpp"
+#include "jobs.hpp"
+#include "profiler.hpp"
+#include "metrics.hpp"
+#include "handle.hpp"
+#include "name_id.hpp"
+#include "small_vector.hpp"
+#include "flat_map.hpp"
+#include "hash_map.hpp"
+#include "cpu.hpp"
 // IWYU pragma: end_exports
 
 
@@ -0,0 +1,161 @@
+#pragma once
+#include "types.hpp"
+#include "result.hpp"
+#include <atomic>
+#include <cassert>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CBOX_CPU_X86 1
+#else
+#define CBOX_CPU_X86 0
+#endif
+
+//NOTE: marks a function as compiled for a wider ISA than the translation unit, so one file can
+// hold every variant of a kernel. MSVC accepts intrinsics anywhere and needs no attribute
+#if CBOX_CPU_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CBOX_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define CBOX_TARGET_AVX2 __attribute__((target("avx2,fma,bmi,bmi2,f16c")))
+#define CBOX_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx512cd,avx2,fma,bmi,bmi2,f16c")))
+#else
+#define CBOX_TARGET_SSE42
+#define CBOX_TARGET_AVX2
+#define CBOX_TARGET_AVX512
+#endif
+
+namespace cc::cpu {
+
+//NOTE: dispatch levels, each one implies every level below it
+enum class isa : u8 {
+    scalar,
+    sse2,
+    sse42,  // + sse3, ssse3, sse4.1, popcnt
+    avx2,   // + avx, fma, bmi1, bmi2, f16c with ymm state enabled by the OS
+    avx512  // + avx512 f/bw/dq/vl/cd with zmm state enabled by the OS
+};
+
+struct features {
+    std::string vendor;
+    std::string brand;
+
+    bool sse2{false};
+    bool sse3{false};
+    bool ssse3{false};
+    bool sse41{false};
+    bool sse42{false};
+    bool popcnt{false};
+    bool avx{false};
+    bool avx2{false};
+    bool fma{false};
+    bool bmi1{false};
+    bool bmi2{false};
+    bool f16c{false};
+    bool avx512f{false};
+    bool avx512bw{false};
+    bool avx512dq{false};
+    bool avx512vl{false};
+    bool avx512cd{false};
+
+    //NOTE: xgetbv, the OS saves these register files on context switch
+    bool os_ymm{false};
+    bool os_zmm{false};
+};
+
+//NOTE: cpuid/xgetbv results, probed once on first use
+[[nodiscard]] const features& info() noexcept;
+
+//NOTE: highest level the hardware and OS support
+[[nodiscard]] isa best() noexcept;
+
+//NOTE: level dispatchers select for, best() capped by force(). The CBOX_FORCE_ISA environment
+// variable (scalar, sse2, sse42, avx2, avx512) applies a cap at startup
+[[nodiscard]] isa active() noexcept;
+
+[[nodiscard]] inline bool supported(isa level) noexcept { return level <= best(); }
+
+//NOTE: caps the active level and re-resolves every dispatcher, meant for exercising each kernel
+// variant in tests and benchmarks. Fails when the machine cannot run `level`
+result<void> force(isa level);
+
+//NOTE: drops the cap, active() returns to best()
+void clear_force();
+
+[[nodiscard]] std::string_view to_string(isa level) noexcept;
+[[nodiscard]] std::optional<isa> parse_isa(std::string_view text) noexcept;
+
+namespace detail {
+
+class dispatch_node {
+public:
+    virtual void resolve(isa level) noexcept = 0;
+
+protected:
+    ~dispatch_node() = default;
+};
+
+//NOTE: resolves `node` against the active level and keeps it for force() to re-resolve
+void register_dispatch(dispatch_node* node);
+void unregister_dispatch(dispatch_node* node) noexcept;
+
+} // namespace detail
+
+template <typename Fn>
+class dispatch;
+
+//NOTE: function pointer picked from per-ISA variants when the dispatcher is built, a call is one
+// relaxed load and an indirect call. Missing variants fall back to the next lower one, `scalar`
+// is required. Meant to be a namespace scope or function local static:
+//
+//   static cc::cpu::dispatch<void(const f32*, f32*, size_t)> g_scale({
+//       .scalar = scale_scalar, .avx2 = scale_avx2});
+template <typename R, typename... Args>
+class dispatch<R(Args...)> final : detail::dispatch_node {
+public:
+    using function = R (*)(Args...);
+
+    struct variants {
+        function scalar{nullptr};
+        function sse2{nullptr};
+        function sse42{nullptr};
+        function avx2{nullptr};
+        function avx512{nullptr};
+    };
+
+    explicit dispatch(const variants& v) : variants_(v) {
+        assert(v.scalar != nullptr && "dispatch needs a scalar fallback");
+        detail::register_dispatch(this);
+    }
+
+    ~dispatch() { detail::unregister_dispatch(this); }
+
+    dispatch(const dispatch&) = delete;
+    dispatch& operator=(const dispatch&) = delete;
+
+    R operator()(Args... args) const { return fn_.load(std::memory_order_relaxed)(static_cast<Args>(args)...); }
+
+    [[nodiscard]] function get() const noexcept { return fn_.load(std::memory_order_relaxed); }
+
+    //NOTE: level of the variant in use, can be below active() when no variant exists for it
+    [[nodiscard]] isa selected() const noexcept { return selected_.load(std::memory_order_relaxed); }
+
+private:
+    void resolve(isa level) noexcept override {
+        const function table[] = {variants_.scalar, variants_.sse2, variants_.sse42, variants_.avx2,
+                                  variants_.avx512};
+        for (i32 i = static_cast<i32>(level); i >= 0; --i) {
+            if (table[i] != nullptr) {
+                selected_.store(static_cast<isa>(i), std::memory_order_relaxed);
+                fn_.store(table[i], std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    variants variants_;
+    std::atomic<function> fn_{nullptr};
+    std::atomic<isa> selected_{isa::scalar};
+};
+
+} // namespace cc::cpu
@@ -42,15 +42,136 @@ enum class error_code : u16 {
     unknown_error = 999
 };
 
+//NOTE: message argument of cc::error. Constant strings (literals) are kept by pointer, runtime
+// strings (std::string, std::string_view) are copied into the error when it is built
+class error_message {
+    const char* data_;
+    size_t size_;
+    bool literal_;
+
+public:
+    consteval error_message(const char* text) noexcept
+    : data_(text), size_(std::char_traits<char>::length(text)), literal_(true) {}
+
+    constexpr error_message(std::string_view text) noexcept
+    : data_(text.data()), size_(text.size()), literal_(false) {}
+
+    constexpr error_message(const std::string& text) noexcept
+    : error_message(std::string_view(text)) {}
+
+    [[nodiscard]] constexpr std::string_view view() const noexcept { return {data_, size_}; }
+    [[nodiscard]] constexpr bool is_literal() const noexcept { return literal_; }
+};
+
+//NOTE: building, copying and destroying an error does not allocate unless a runtime message is
+// longer than inline_capacity, same 48 bytes as the former std::string based layout. All of it is
+// constexpr, so cc::result stays a literal type; during constant evaluation a runtime message
+// always takes the (transient) heap path, the union never switches to inline_ there
 class error {
-    error_code code_;
-    std::string message_;
+public:
+    static constexpr size_t inline_capacity = 32;
+
+private:
+    enum class storage : u8 {
+        literal,
+        inline_buffer,
+        heap
+    };
+
     std::source_location location_;
+    union {
+        const char* external_;
+        char inline_[inline_capacity];
+    };
+    u32 size_ = 0;
+    error_code code_;
+    storage storage_ = storage::literal;
+
+    void store(std::string_view msg) noexcept;
+
+    constexpr void assign(std::string_view msg) noexcept {
+        if !consteval {
+            store(msg);
+            return;
+        }
+        char* data = new char[msg.size() + 1];
+        std::char_traits<char>::copy(data, msg.data(), msg.size());
+        storage_ = storage::heap;
+        external_ = data;
+        size_ = static_cast<u32>(msg.size());
+    }
+
+    constexpr void copy_from(const error& other) noexcept {
+        code_ = other.code_;
+        location_ = other.location_;
+        if (other.storage_ == storage::heap) {
+            assign(other.message());
+            return;
+        }
+        storage_ = other.storage_;
+        size_ = other.size_;
+        if (storage_ == storage::literal) {
+            external_ = other.external_;
+        } else {
+            std::char_traits<char>::copy(inline_, other.inline_, size_);
+        }
+    }
+
+    constexpr void move_from(error& other) noexcept {
+        if (other.storage_ != storage::heap) {
+            copy_from(other);
+            return;
+        }
+        code_ = other.code_;
+        location_ = other.location_;
+        storage_ = storage::heap;
+        external_ = other.external_;
+        size_ = other.size_;
+        other.storage_ = storage::literal;
+        other.external_ = "";
+        other.size_ = 0;
+    }
+
+    constexpr void release() noexcept {
+        if (storage_ == storage::heap) {
+            delete[] external_;
+            storage_ = storage::literal;
+        }
+    }
 
 public:
-    constexpr error(error_code code, std::string_view msg,
-                    std::source_location loc = std::source_location::current()) noexcept
-    : code_(code), message_(msg), location_(loc) {}
+    constexpr error(error_code code, error_message msg,
+          std::source_location loc = std::source_location::current()) noexcept
+    : location_(loc), external_(nullptr), code_(code) {
+        if (msg.is_literal()) {
+            external_ = msg.view().data();
+            size_ = static_cast<u32>(msg.view().size());
+        } else {
+            assign(msg.view());
+        }
+    }
+
+    constexpr error(const error& other) noexcept : external_(nullptr) { copy_from(other); }
+
+    constexpr error(error&& other) noexcept : external_(nullptr) { move_from(other); }
+
+    constexpr error& operator=(const error& other) noexcept {
+        if (this != &other) {
+            release();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    constexpr error& operator=(error&& other) noexcept {
+        if (this != &other) {
+            release();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    constexpr ~error() { release(); }
 
     [[nodiscard]] constexpr error_code code() const noexcept { return code_; }
     [[nodiscard]] constexpr error_category category() const noexcept {
@@ -62,13 +183,15 @@ public:
         return error_category::core;
     }
 
-    [[nodiscard]] constexpr std::string_view message() const noexcept { return message_; }
+    [[nodiscard]] constexpr std::string_view message() const noexcept {
+        return storage_ == storage::inline_buffer ? std::string_view(inline_, size_) : std::string_view(external_, size_);
+    }
     [[nodiscard]] constexpr const std::source_location& location() const noexcept { return location_; }
 
-    [[nodiscard]] bool is_file_error() const noexcept { return category() == error_category::file_system; }
-    [[nodiscard]] bool is_network_error() const noexcept { return category() == error_category::network; }
-    [[nodiscard]] bool is_parse_error() const noexcept { return category() == error_category::parse; }
-    [[nodiscard]] bool is_validation_error() const noexcept { return category() == error_category::validation; }
+    [[nodiscard]] constexpr bool is_file_error() const noexcept { return category() == error_category::file_system; }
+    [[nodiscard]] constexpr bool is_network_error() const noexcept { return category() == error_category::network; }
+    [[nodiscard]] constexpr bool is_parse_error() const noexcept { return category() == error_category::parse; }
+    [[nodiscard]] constexpr bool is_validation_error() const noexcept { return category() == error_category::validation; }
 
     [[nodiscard]] std::string format() const;
     [[nodiscard]] const char* code_string() const noexcept;
@@ -0,0 +1,165 @@
+#pragma once
+#include "types.hpp"
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+//NOTE: map over a vector of pairs kept sorted by key. Lookups are a binary search over one
+// contiguous block and iteration is a linear walk, which beats node based maps for the small
+// tables that are read far more often than they are written. Inserting or erasing moves the tail
+// and invalidates iterators and references. Keys must not be modified through an iterator
+template <typename K, typename V, typename Compare = std::less<>,
+          typename Container = std::vector<std::pair<K, V>>>
+class flat_map {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using container_type = Container;
+    using size_type = size_t;
+    using iterator = typename Container::iterator;
+    using const_iterator = typename Container::const_iterator;
+
+    flat_map() = default;
+
+    explicit flat_map(const Compare& compare) : compare_(compare) {}
+
+    template <typename Alloc>
+        requires std::uses_allocator_v<Container, Alloc>
+    explicit flat_map(const Alloc& alloc) : values_(alloc) {}
+
+    flat_map(std::initializer_list<value_type> init) {
+        values_.reserve(init.size());
+        for (const auto& value : init) {
+            insert_or_assign(value.first, value.second);
+        }
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return values_.begin(); }
+    [[nodiscard]] iterator end() noexcept { return values_.end(); }
+    [[nodiscard]] const_iterator begin() const noexcept { return values_.begin(); }
+    [[nodiscard]] const_iterator end() const noexcept { return values_.end(); }
+
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+    [[nodiscard]] size_t size() const noexcept { return values_.size(); }
+
+    void reserve(size_t count) { values_.reserve(count); }
+    void clear() noexcept { values_.clear(); }
+
+    [[nodiscard]] const Container& values() const noexcept { return values_; }
+
+    template <typename Key>
+    [[nodiscard]] iterator lower_bound(const Key& key) {
+        return std::lower_bound(values_.begin(), values_.end(), key,
+                                [this](const value_type& v, const Key& k) { return compare_(v.first, k); });
+    }
+
+    template <typename Key>
+    [[nodiscard]] const_iterator lower_bound(const Key& key) const {
+        return std::lower_bound(values_.begin(), values_.end(), key,
+                                [this](const value_type& v, const Key& k) { return compare_(v.first, k); });
+    }
+
+    template <typename Key>
+    [[nodiscard]] iterator find(const Key& key) {
+        auto it = lower_bound(key);
+        return it != values_.end() && !compare_(key, it->first) ? it : values_.end();
+    }
+
+    template <typename Key>
+    [[nodiscard]] const_iterator find(const Key& key) const {
+        auto it = lower_bound(key);
+        return it != values_.end() && !compare_(key, it->first) ? it : values_.end();
+    }
+
+    template <typename Key>
+    [[nodiscard]] bool contains(const Key& key) const {
+        return find(key) != values_.end();
+    }
+
+    template <typename Key>
+    [[nodiscard]] V& at(const Key& key) {
+        auto it = find(key);
+        if (it == values_.end()) {
+            throw std::out_of_range("flat_map::at");
+        }
+        return it->second;
+    }
+
+    template <typename Key>
+    [[nodiscard]] const V& at(const Key& key) const {
+        auto it = find(key);
+        if (it == values_.end()) {
+            throw std::out_of_range("flat_map::at");
+        }
+        return it->second;
+    }
+
+    //NOTE: `key` may be any type K is constructible from and Compare accepts, e.g. a string_view
+    template <typename Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        auto it = lower_bound(key);
+        if (it != values_.end() && !compare_(key, it->first)) {
+            return {it, false};
+        }
+        it = values_.emplace(it, std::piecewise_construct, std::forward_as_tuple(K(std::forward<Key>(key))),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return {it, true};
+    }
+
+    template <typename Key, typename M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value) {
+        auto [it, inserted] = try_emplace(std::forward<Key>(key), std::forward<M>(value));
+        if (!inserted) {
+            it->second = std::forward<M>(value);
+        }
+        return {it, inserted};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename Key>
+    V& operator[](Key&& key) {
+        return try_emplace(std::forward<Key>(key)).first->second;
+    }
+
+    iterator erase(iterator pos) { return values_.erase(pos); }
+    iterator erase(const_iterator pos) { return values_.erase(pos); }
+
+    //NOTE: as with std::map, a key convertible to an iterator selects the overloads above
+    template <typename Key>
+        requires(!std::is_convertible_v<const Key&, iterator> && !std::is_convertible_v<const Key&, const_iterator>)
+    size_t erase(const Key& key) {
+        auto it = find(key);
+        if (it == values_.end()) {
+            return 0;
+        }
+        values_.erase(it);
+        return 1;
+    }
+
+    friend bool operator==(const flat_map& a, const flat_map& b) { return a.values_ == b.values_; }
+
+private:
+    Container values_;
+    [[no_unique_address]] Compare compare_;
+};
+
+namespace pmr {
+
+template <typename K, typename V, typename Compare = std::less<>>
+using flat_map = cc::flat_map<K, V, Compare, std::pmr::vector<std::pair<K, V>>>;
+
+} // namespace pmr
+
+} // namespace cc
@@ -0,0 +1,156 @@
+#pragma once
+#include "types.hpp"
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+//NOTE: index into a slot_map plus the generation of the slot when the handle was issued. A
+// generation of 0 is never issued, so a value initialized handle is null
+template <typename Tag>
+struct handle {
+    u32 index{0};
+    u32 generation{0};
+
+    [[nodiscard]] constexpr bool is_null() const noexcept { return generation == 0; }
+    constexpr explicit operator bool() const noexcept { return generation != 0; }
+
+    friend constexpr bool operator==(handle, handle) noexcept = default;
+};
+
+//NOTE: values are packed in a dense array that is iterated directly, slots map a handle to its
+// dense position and hold the generation checked on every lookup. Erasing swaps the last value
+// into the hole and bumps the slot generation so stale handles stop resolving
+template <typename T, typename Tag = T>
+class slot_map {
+public:
+    using value_type = T;
+    using handle_type = handle<Tag>;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    slot_map() = default;
+
+    template <typename... Args>
+    handle_type emplace(Args&&... args) {
+        values_.emplace_back(std::forward<Args>(args)...);
+
+        u32 index;
+        if (free_head_ != npos) {
+            index = free_head_;
+            free_head_ = slots_[index].target;
+        } else {
+            assert(slots_.size() < npos && "slot_map is full");
+            index = static_cast<u32>(slots_.size());
+            slots_.push_back(slot{0, 1});
+        }
+
+        u32 position = static_cast<u32>(values_.size() - 1);
+        slots_[index].target = position;
+        owners_.push_back(index);
+        return handle_type{index, slots_[index].generation};
+    }
+
+    handle_type insert(const T& value) { return emplace(value); }
+    handle_type insert(T&& value) { return emplace(std::move(value)); }
+
+    bool erase(handle_type h) {
+        if (!contains(h)) {
+            return false;
+        }
+
+        u32 position = slots_[h.index].target;
+        u32 last = static_cast<u32>(values_.size() - 1);
+        if (position != last) {
+            values_[position] = std::move(values_[last]);
+            owners_[position] = owners_[last];
+            slots_[owners_[position]].target = position;
+        }
+        values_.pop_back();
+        owners_.pop_back();
+
+        slot& s = slots_[h.index];
+        s.generation = s.generation == std::numeric_limits<u32>::max() ? 1 : s.generation + 1;
+        s.target = free_head_;
+        free_head_ = h.index;
+        return true;
+    }
+
+    [[nodiscard]] bool contains(handle_type h) const noexcept {
+        return h.index < slots_.size() && h.generation != 0 && slots_[h.index].generation == h.generation &&
+               slot_in_use(h.index);
+    }
+
+    [[nodiscard]] T* get(handle_type h) noexcept {
+        return contains(h) ? &values_[slots_[h.index].target] : nullptr;
+    }
+
+    [[nodiscard]] const T* get(handle_type h) const noexcept {
+        return contains(h) ? &values_[slots_[h.index].target] : nullptr;
+    }
+
+    void clear() {
+        for (u32 index : owners_) {
+            slot& s = slots_[index];
+            s.generation = s.generation == std::numeric_limits<u32>::max() ? 1 : s.generation + 1;
+            s.target = free_head_;
+            free_head_ = index;
+        }
+        values_.clear();
+        owners_.clear();
+    }
+
+    void reserve(size_t n) {
+        values_.reserve(n);
+        owners_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    //NOTE: handle of the value at dense position `position`, for use while iterating
+    [[nodiscard]] handle_type handle_at(size_t position) const noexcept {
+        u32 index = owners_[position];
+        return handle_type{index, slots_[index].generation};
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return values_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+
+    [[nodiscard]] T* data() noexcept { return values_.data(); }
+    [[nodiscard]] const T* data() const noexcept { return values_.data(); }
+
+    iterator begin() noexcept { return values_.begin(); }
+    iterator end() noexcept { return values_.end(); }
+    const_iterator begin() const noexcept { return values_.begin(); }
+    const_iterator end() const noexcept { return values_.end(); }
+
+private:
+    static constexpr u32 npos = std::numeric_limits<u32>::max();
+
+    //NOTE: `target` is the dense position while the slot is live and the next free slot otherwise
+    struct slot {
+        u32 target;
+        u32 generation;
+    };
+
+    [[nodiscard]] bool slot_in_use(u32 index) const noexcept {
+        u32 position = slots_[index].target;
+        return position < owners_.size() && owners_[position] == index;
+    }
+
+    std::vector<T> values_;
+    std::vector<u32> owners_;
+    std::vector<slot> slots_;
+    u32 free_head_{npos};
+};
+
+} // namespace cc
+
+template <typename Tag>
+struct std::hash<cc::handle<Tag>> {
+    size_t operator()(cc::handle<Tag> h) const noexcept {
+        return std::hash<cc::u64>{}((static_cast<cc::u64>(h.generation) << 32) | h.index);
+    }
+};
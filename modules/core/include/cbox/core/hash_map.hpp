@@ -0,0 +1,668 @@
+#pragma once
+#include "types.hpp"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CBOX_HASH_MAP_SSE2 1
+#else
+#define CBOX_HASH_MAP_SSE2 0
+#endif
+
+namespace cc {
+
+namespace detail {
+
+//NOTE: multiply-xorshift over 8 byte words. Much cheaper than std::hash for the short identifiers
+// used as keys (uniform, marker and camera names), the table mixes the result again
+[[nodiscard]] inline u64 hash_bytes(const char* p, size_t size) noexcept {
+    u64 h = 0x9e3779b97f4a7c15ull ^ (size * 0xff51afd7ed558ccdull);
+    for (; size >= 8; p += 8, size -= 8) {
+        u64 w;
+        std::memcpy(&w, p, 8);
+        h = (h ^ w) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 29;
+    }
+    if (size != 0) {
+        u64 w = 0;
+        if (size >= 4) {
+            u32 lo;
+            u32 hi;
+            std::memcpy(&lo, p, 4);
+            std::memcpy(&hi, p + size - 4, 4);
+            w = (static_cast<u64>(hi) << 32) | lo;
+        } else {
+            w = static_cast<u64>(static_cast<u8>(p[0])) | (static_cast<u64>(static_cast<u8>(p[size / 2])) << 8) |
+                (static_cast<u64>(static_cast<u8>(p[size - 1])) << 16);
+        }
+        h = (h ^ w) * 0x94d049bb133111ebull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+} // namespace detail
+
+//NOTE: transparent hash so string keyed maps can be probed with a string_view or a literal
+// without building a temporary std::string
+struct string_hash {
+    using is_transparent = void;
+
+    [[nodiscard]] size_t operator()(std::string_view s) const noexcept {
+        return static_cast<size_t>(detail::hash_bytes(s.data(), s.size()));
+    }
+};
+
+template <typename K>
+struct default_hash : std::hash<K> {};
+
+template <>
+struct default_hash<std::string> : string_hash {};
+
+template <>
+struct default_hash<std::pmr::string> : string_hash {};
+
+namespace detail {
+
+//NOTE: control byte per slot. Full slots store the low 7 bits of the hash, so a probe compares
+// 16 candidates per instruction and only touches slots whose tag matches
+enum ctrl : i8 {
+    ctrl_empty = -128,
+    ctrl_deleted = -2,
+    ctrl_sentinel = -1
+};
+
+struct ctrl_group {
+    static constexpr size_t width = 16;
+
+#if CBOX_HASH_MAP_SSE2
+    explicit ctrl_group(const i8* p) noexcept
+    : bits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    [[nodiscard]] u32 match(i8 tag) const noexcept {
+        return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), bits)));
+    }
+
+    [[nodiscard]] u32 match_empty() const noexcept { return match(ctrl_empty); }
+
+    //NOTE: empty and deleted are the only control values below the sentinel
+    [[nodiscard]] u32 match_empty_or_deleted() const noexcept {
+        return static_cast<u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), bits)));
+    }
+
+    __m128i bits;
+#else
+    explicit ctrl_group(const i8* p) noexcept { std::memcpy(bytes, p, width); }
+
+    [[nodiscard]] u32 match(i8 tag) const noexcept {
+        u32 mask = 0;
+        for (size_t i = 0; i < width; ++i) {
+            mask |= static_cast<u32>(bytes[i] == tag) << i;
+        }
+        return mask;
+    }
+
+    [[nodiscard]] u32 match_empty() const noexcept { return match(ctrl_empty); }
+
+    [[nodiscard]] u32 match_empty_or_deleted() const noexcept {
+        u32 mask = 0;
+        for (size_t i = 0; i < width; ++i) {
+            mask |= static_cast<u32>(bytes[i] < ctrl_sentinel) << i;
+        }
+        return mask;
+    }
+
+    i8 bytes[width];
+#endif
+};
+
+//NOTE: std::hash of integers is the identity on the common standard libraries, spread the bits
+// so both the probe start and the 7 bit tag are usable
+[[nodiscard]] constexpr u64 mix_hash(u64 h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace detail
+
+//NOTE: open addressing map in the SwissTable layout: one control byte per slot, probed a group of
+// 16 at a time, slots stored in a separate flat array and at most 7/8 full. With a transparent
+// Hash and KeyEqual (the default for string keys) find/contains/erase/try_emplace accept any
+// comparable key such as a string_view. Rehashing moves elements, so iterators and references are
+// invalidated by any insertion that grows the table. Keys must not be modified through an iterator
+template <typename K, typename V, typename Hash = default_hash<K>, typename KeyEqual = std::equal_to<>,
+          typename Allocator = std::allocator<std::pair<K, V>>>
+class hash_map {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+
+private:
+    using traits = std::allocator_traits<Allocator>;
+    using ctrl_allocator = typename traits::template rebind_alloc<i8>;
+    using ctrl_traits = std::allocator_traits<ctrl_allocator>;
+
+    static constexpr size_t group_width = detail::ctrl_group::width;
+
+    template <typename Key>
+    static constexpr bool is_lookup_key =
+        std::is_same_v<std::remove_cvref_t<Key>, K> ||
+        (requires { typename Hash::is_transparent; } && requires { typename KeyEqual::is_transparent; });
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = hash_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        basic_iterator() noexcept = default;
+
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+        : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+        reference operator*() const noexcept { return *slot_; }
+        pointer operator->() const noexcept { return slot_; }
+
+        basic_iterator& operator++() noexcept {
+            ++ctrl_;
+            ++slot_;
+            skip_free();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.slot_ == b.slot_;
+        }
+
+    private:
+        friend class hash_map;
+        template <bool>
+        friend class basic_iterator;
+
+        basic_iterator(const i8* ctrl, pointer slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+        //NOTE: the sentinel after the last slot stops the walk
+        void skip_free() noexcept {
+            while (*ctrl_ < detail::ctrl_sentinel) {
+                ++ctrl_;
+                ++slot_;
+            }
+            if (*ctrl_ == detail::ctrl_sentinel) {
+                slot_ = nullptr;
+            }
+        }
+
+        const i8* ctrl_{nullptr};
+        pointer slot_{nullptr};
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    hash_map() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+    explicit hash_map(const Allocator& alloc) noexcept : alloc_(alloc) {}
+
+    explicit hash_map(size_t capacity, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        reserve(capacity);
+    }
+
+    hash_map(std::initializer_list<value_type> init, const Allocator& alloc = Allocator()) : alloc_(alloc) {
+        reserve(init.size());
+        for (const auto& value : init) {
+            try_emplace(value.first, value.second);
+        }
+    }
+
+    hash_map(const hash_map& other)
+    : hash_(other.hash_), equal_(other.equal_), alloc_(traits::select_on_container_copy_construction(other.alloc_)) {
+        copy_from(other);
+    }
+
+    hash_map(hash_map&& other) noexcept
+    : hash_(std::move(other.hash_)), equal_(std::move(other.equal_)), alloc_(std::move(other.alloc_)) {
+        steal(other);
+    }
+
+    hash_map& operator=(const hash_map& other) {
+        if (this != &other) {
+            clear();
+            if constexpr (traits::propagate_on_container_copy_assignment::value) {
+                if (alloc_ != other.alloc_) {
+                    release();
+                }
+                alloc_ = other.alloc_;
+            }
+            hash_ = other.hash_;
+            equal_ = other.equal_;
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    hash_map& operator=(hash_map&& other) noexcept(traits::propagate_on_container_move_assignment::value ||
+                                                    traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        hash_ = std::move(other.hash_);
+        equal_ = std::move(other.equal_);
+        if constexpr (traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc_ = std::move(other.alloc_);
+            steal(other);
+        } else if (alloc_ == other.alloc_) {
+            release();
+            steal(other);
+        } else {
+            //NOTE: memory from another resource can't be adopted, move element by element
+            reserve(other.size());
+            for (auto& value : other) {
+                emplace_unique(std::move(value.first), std::move(value.second));
+            }
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~hash_map() {
+        clear();
+        release();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return alloc_; }
+
+    [[nodiscard]] iterator begin() noexcept {
+        if (size_ == 0) {
+            return end();
+        }
+        iterator it(ctrl_, slots_);
+        it.skip_free();
+        return it;
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        if (size_ == 0) {
+            return end();
+        }
+        const_iterator it(ctrl_, slots_);
+        it.skip_free();
+        return it;
+    }
+
+    [[nodiscard]] iterator end() noexcept { return iterator(nullptr, nullptr); }
+    [[nodiscard]] const_iterator end() const noexcept { return const_iterator(nullptr, nullptr); }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    void clear() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] >= 0) {
+                    traits::destroy(alloc_, slots_ + i);
+                }
+            }
+        }
+        reset_ctrl();
+        size_ = 0;
+    }
+
+    //NOTE: makes room for `count` elements without a rehash
+    void reserve(size_t count) {
+        size_t required = capacity_for(count);
+        if (required > capacity_) {
+            rehash(required);
+        }
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] iterator find(const Key& key) {
+        size_t i = find_index(key);
+        return i != npos ? iterator(ctrl_ + i, slots_ + i) : end();
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] const_iterator find(const Key& key) const {
+        size_t i = find_index(key);
+        return i != npos ? const_iterator(ctrl_ + i, slots_ + i) : end();
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] bool contains(const Key& key) const {
+        return find_index(key) != npos;
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] size_t count(const Key& key) const {
+        return find_index(key) != npos ? 1 : 0;
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] V& at(const Key& key) {
+        size_t i = find_index(key);
+        if (i == npos) {
+            throw std::out_of_range("hash_map::at");
+        }
+        return slots_[i].second;
+    }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    [[nodiscard]] const V& at(const Key& key) const {
+        size_t i = find_index(key);
+        if (i == npos) {
+            throw std::out_of_range("hash_map::at");
+        }
+        return slots_[i].second;
+    }
+
+    //NOTE: K is only constructed from `key` when the key is not present yet
+    template <typename Key, typename... Args>
+        requires is_lookup_key<Key> && std::is_constructible_v<K, Key&&>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        u64 h = hash_of(key);
+        if (size_t i = find_index(key, h); i != npos) {
+            return {iterator(ctrl_ + i, slots_ + i), false};
+        }
+        size_t i = insert_index(h);
+        traits::construct(alloc_, slots_ + i, std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        commit(i, h);
+        return {iterator(ctrl_ + i, slots_ + i), true};
+    }
+
+    template <typename Key, typename M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value) {
+        auto [it, inserted] = try_emplace(std::forward<Key>(key), std::forward<M>(value));
+        if (!inserted) {
+            it->second = std::forward<M>(value);
+        }
+        return {it, inserted};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename Key>
+    V& operator[](Key&& key) {
+        return try_emplace(std::forward<Key>(key)).first->second;
+    }
+
+    void erase(const_iterator pos) { erase_index(static_cast<size_t>(pos.slot_ - slots_)); }
+    void erase(iterator pos) { erase_index(static_cast<size_t>(pos.slot_ - slots_)); }
+
+    template <typename Key>
+        requires is_lookup_key<Key>
+    size_t erase(const Key& key) {
+        size_t i = find_index(key);
+        if (i == npos) {
+            return 0;
+        }
+        erase_index(i);
+        return 1;
+    }
+
+    friend bool operator==(const hash_map& a, const hash_map& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (const auto& [key, value] : a) {
+            auto it = b.find(key);
+            if (it == b.end() || !(it->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t npos = ~size_t{0};
+
+    //NOTE: capacity is always 2^n - 1 so it doubles as the probe mask, and at least one group
+    [[nodiscard]] static size_t capacity_for(size_t count) noexcept {
+        if (count == 0) {
+            return 0;
+        }
+        size_t slots = count + (count + 6) / 7;
+        return std::max(group_width, std::bit_ceil(slots + 1)) - 1;
+    }
+
+    [[nodiscard]] size_t growth_limit() const noexcept { return capacity_ - capacity_ / 8; }
+
+    template <typename Key>
+    [[nodiscard]] u64 hash_of(const Key& key) const {
+        return detail::mix_hash(static_cast<u64>(hash_(key)));
+    }
+
+    [[nodiscard]] static i8 tag_of(u64 h) noexcept { return static_cast<i8>(h & 0x7f); }
+
+    template <typename Key>
+    [[nodiscard]] size_t find_index(const Key& key) const {
+        return size_ != 0 ? find_index(key, hash_of(key)) : npos;
+    }
+
+    //NOTE: triangular probing over groups visits every group once when the group count is a power
+    // of two, and the table always keeps an empty slot so a miss terminates
+    template <typename Key>
+    [[nodiscard]] size_t find_index(const Key& key, u64 h) const {
+        if (capacity_ == 0) {
+            return npos;
+        }
+        size_t mask = capacity_;
+        size_t pos = static_cast<size_t>(h >> 7) & mask;
+        i8 tag = tag_of(h);
+        for (size_t step = group_width;; step += group_width) {
+            detail::ctrl_group group(ctrl_ + pos);
+            for (u32 bits = group.match(tag); bits != 0; bits &= bits - 1) {
+                size_t i = (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+                if (equal_(slots_[i].first, key)) {
+                    return i;
+                }
+            }
+            if (group.match_empty() != 0) {
+                return npos;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    //NOTE: first empty or deleted slot on the probe sequence of `h`, growing the table first when
+    // taking an empty slot would pass the load factor
+    size_t insert_index(u64 h) {
+        if (capacity_ == 0 || size_ + deleted_ + 1 > growth_limit()) {
+            //NOTE: when tombstones make up half the load, rehashing at the same size reclaims them
+            rehash(std::max(capacity_for(size_ + 1), deleted_ >= size_ ? capacity_ : capacity_ * 2 + 1));
+        }
+
+        size_t mask = capacity_;
+        size_t pos = static_cast<size_t>(h >> 7) & mask;
+        for (size_t step = group_width;; step += group_width) {
+            detail::ctrl_group group(ctrl_ + pos);
+            if (u32 bits = group.match_empty_or_deleted(); bits != 0) {
+                return (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    //NOTE: the first group_width - 1 control bytes are mirrored after the sentinel so a group load
+    // starting near the end of the table reads the wrapped around slots, `(pos + k) & mask` maps a
+    // mirrored byte back onto its slot and the sentinel never matches
+    void set_ctrl(size_t i, i8 value) noexcept {
+        ctrl_[i] = value;
+        if (i < group_width - 1) {
+            ctrl_[capacity_ + 1 + i] = value;
+        }
+    }
+
+    void commit(size_t i, u64 h) noexcept {
+        if (ctrl_[i] == detail::ctrl_deleted) {
+            --deleted_;
+        }
+        set_ctrl(i, tag_of(h));
+        ++size_;
+    }
+
+    void erase_index(size_t i) noexcept {
+        traits::destroy(alloc_, slots_ + i);
+        set_ctrl(i, detail::ctrl_deleted);
+        --size_;
+        ++deleted_;
+    }
+
+    [[nodiscard]] size_t ctrl_size() const noexcept { return capacity_ + group_width; }
+
+    void reset_ctrl() noexcept {
+        std::memset(ctrl_, static_cast<u8>(detail::ctrl_empty), ctrl_size());
+        ctrl_[capacity_] = detail::ctrl_sentinel;
+        deleted_ = 0;
+    }
+
+    void rehash(size_t new_capacity) {
+        i8* old_ctrl = ctrl_;
+        value_type* old_slots = slots_;
+        size_t old_capacity = capacity_;
+
+        ctrl_allocator ctrl_alloc(alloc_);
+        ctrl_ = ctrl_traits::allocate(ctrl_alloc, new_capacity + group_width);
+        try {
+            slots_ = traits::allocate(alloc_, new_capacity);
+        } catch (...) {
+            ctrl_traits::deallocate(ctrl_alloc, ctrl_, new_capacity + group_width);
+            ctrl_ = old_ctrl;
+            throw;
+        }
+        capacity_ = new_capacity;
+        reset_ctrl();
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                u64 h = hash_of(old_slots[i].first);
+                size_t mask = capacity_;
+                size_t pos = static_cast<size_t>(h >> 7) & mask;
+                for (size_t step = group_width;; step += group_width) {
+                    detail::ctrl_group group(ctrl_ + pos);
+                    if (u32 bits = group.match_empty(); bits != 0) {
+                        size_t j = (pos + static_cast<size_t>(std::countr_zero(bits))) & mask;
+                        traits::construct(alloc_, slots_ + j, std::move(old_slots[i]));
+                        traits::destroy(alloc_, old_slots + i);
+                        set_ctrl(j, tag_of(h));
+                        break;
+                    }
+                    pos = (pos + step) & mask;
+                }
+            }
+        }
+
+        if (old_capacity != 0) {
+            ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_capacity + group_width);
+            traits::deallocate(alloc_, old_slots, old_capacity);
+        }
+    }
+
+    void release() noexcept {
+        if (capacity_ != 0) {
+            ctrl_allocator ctrl_alloc(alloc_);
+            ctrl_traits::deallocate(ctrl_alloc, ctrl_, ctrl_size());
+            traits::deallocate(alloc_, slots_, capacity_);
+        }
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        deleted_ = 0;
+    }
+
+    void steal(hash_map& other) noexcept {
+        ctrl_ = std::exchange(other.ctrl_, nullptr);
+        slots_ = std::exchange(other.slots_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        size_ = std::exchange(other.size_, 0);
+        deleted_ = std::exchange(other.deleted_, 0);
+    }
+
+    void copy_from(const hash_map& other) {
+        reserve(other.size());
+        for (const auto& value : other) {
+            emplace_unique(value.first, value.second);
+        }
+    }
+
+    //NOTE: insertion of a key known to be absent, skips the lookup
+    template <typename Key, typename M>
+    void emplace_unique(Key&& key, M&& value) {
+        u64 h = hash_of(key);
+        size_t i = insert_index(h);
+        traits::construct(alloc_, slots_ + i, std::forward<Key>(key), std::forward<M>(value));
+        commit(i, h);
+    }
+
+    i8* ctrl_{nullptr};
+    value_type* slots_{nullptr};
+    size_t capacity_{0};
+    size_t size_{0};
+    size_t deleted_{0};
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+    [[no_unique_address]] Allocator alloc_;
+};
+
+namespace pmr {
+
+template <typename K, typename V, typename Hash = default_hash<K>, typename KeyEqual = std::equal_to<>>
+using hash_map = cc::hash_map<K, V, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<K, V>>>;
+
+} // namespace pmr
+
+} // namespace cc
@@ -0,0 +1,466 @@
+#pragma once
+#include "types.hpp"
+#include "result.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+namespace detail {
+
+//NOTE: Chase-Lev work stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013). The owner pushes and
+// pops at the bottom, thieves take from the top. Grown arrays are kept until destruction since a
+// thief may still be reading the old one
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class work_deque {
+    struct ring {
+        explicit ring(size_t capacity)
+        : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        [[nodiscard]] size_t capacity() const noexcept { return mask + 1; }
+        [[nodiscard]] T get(i64 i) const noexcept { return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed); }
+        void put(i64 i, T value) noexcept { slots[static_cast<size_t>(i) & mask].store(value, std::memory_order_relaxed); }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+public:
+    explicit work_deque(size_t capacity = 256) {
+        rings_.push_back(std::make_unique<ring>(std::bit_ceil(std::max<size_t>(capacity, 2))));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    work_deque(const work_deque&) = delete;
+    work_deque& operator=(const work_deque&) = delete;
+
+    //NOTE: owner thread only
+    void push(T value) {
+        i64 b = bottom_.load(std::memory_order_relaxed);
+        i64 t = top_.load(std::memory_order_acquire);
+        ring* r = ring_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<i64>(r->capacity()) - 1) {
+            r = grow(r, t, b);
+        }
+        r->put(b, value);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    //NOTE: owner thread only
+    [[nodiscard]] std::optional<T> pop() noexcept {
+        i64 b = bottom_.load(std::memory_order_relaxed) - 1;
+        ring* r = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        T value = r->get(b);
+        if (t == b) {
+            //NOTE: last element, race the thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    //NOTE: any thread
+    [[nodiscard]] std::optional<T> steal() noexcept {
+        i64 t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        i64 b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+
+        ring* r = ring_.load(std::memory_order_acquire);
+        T value = r->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        i64 b = bottom_.load(std::memory_order_relaxed);
+        i64 t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+private:
+    ring* grow(ring* old, i64 top, i64 bottom) {
+        auto next = std::make_unique<ring>(old->capacity() * 2);
+        for (i64 i = top; i < bottom; ++i) {
+            next->put(i, old->get(i));
+        }
+        ring* r = next.get();
+        rings_.push_back(std::move(next));
+        ring_.store(r, std::memory_order_release);
+        return r;
+    }
+
+    alignas(64) std::atomic<i64> top_{0};
+    alignas(64) std::atomic<i64> bottom_{0};
+    std::atomic<ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<ring>> rings_;
+};
+
+template<typename R>
+struct as_result {
+    using type = cc::result<R>;
+};
+
+template<typename U>
+struct as_result<std::expected<U, cc::error>> {
+    using type = cc::result<U>;
+};
+
+template<typename F, typename... Args>
+using job_result_t = typename as_result<std::invoke_result_t<F, Args...>>::type;
+
+//NOTE: runs `f` and folds its outcome into a cc::result, plain values are wrapped, results pass
+// through and exceptions become unknown_error
+template<typename F, typename... Args>
+[[nodiscard]] job_result_t<F, Args...> invoke_as_result(F& f, Args&&... args) noexcept {
+    using R = std::invoke_result_t<F, Args...>;
+    try {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(f, std::forward<Args>(args)...);
+            return cc::ok();
+        } else {
+            return std::invoke(f, std::forward<Args>(args)...);
+        }
+    } catch (const std::exception& e) {
+        return cc::err(cc::error_code::unknown_error, std::string_view(e.what()));
+    } catch (...) {
+        return cc::err(cc::error_code::unknown_error, "Job threw a non standard exception");
+    }
+}
+
+template<typename T, typename F>
+struct continuation_result {
+    using type = job_result_t<F, const T&>;
+};
+
+template<typename F>
+struct continuation_result<void, F> {
+    using type = job_result_t<F>;
+};
+
+template<typename T>
+struct job_state {
+    std::mutex mutex;
+    std::atomic<bool> ready{false};
+    std::optional<cc::result<T>> value;
+    std::vector<std::move_only_function<void()>> continuations;
+};
+
+} // namespace detail
+
+template<typename T>
+class job;
+
+//NOTE: work stealing pool, one Chase-Lev deque per worker. Tasks spawned from a worker go to its
+// own deque, tasks from other threads to a shared injection queue. Idle workers steal from a
+// random victim and sleep when nothing is queued
+class job_system {
+public:
+    using task = std::move_only_function<void()>;
+
+    //NOTE: 0 picks hardware_concurrency - 1 workers, the waiting thread helps as the last one
+    explicit job_system(size_t threads = 0);
+    ~job_system();
+
+    job_system(const job_system&) = delete;
+    job_system& operator=(const job_system&) = delete;
+
+    [[nodiscard]] static job_system& global();
+
+    [[nodiscard]] size_t thread_count() const noexcept { return workers_.size(); }
+
+    template<typename F>
+        requires std::invocable<F&>
+    void spawn(F&& f) {
+        submit(new task(std::forward<F>(f)));
+    }
+
+    template<typename F>
+        requires std::invocable<F&>
+    [[nodiscard]] auto async(F&& f) -> job<typename detail::job_result_t<std::decay_t<F>&>::value_type>;
+
+    //NOTE: runs one queued task on the calling thread, returns false when none was found. Used by
+    // waits so a blocked thread keeps the pool busy instead of sleeping
+    bool run_one();
+
+private:
+    struct worker {
+        explicit worker(u64 s) noexcept : seed(s) {}
+
+        detail::work_deque<task*> deque;
+        u64 seed;
+    };
+
+    void submit(task* t);
+    [[nodiscard]] task* find_task(worker* self);
+    void worker_loop(size_t index, std::stop_token stop);
+    void wake_one();
+
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::vector<std::jthread> threads_;
+
+    std::mutex inject_mutex_;
+    std::deque<task*> inject_;
+    std::atomic<size_t> inject_size_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<u64> epoch_{0};
+    std::atomic<u32> sleeping_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+//NOTE: handle to the value of an async task. then() chains a continuation that receives the value
+// and is skipped (forwarding the error) when the task failed. get() waits while helping the pool
+template<typename T>
+class job {
+public:
+    job() = default;
+
+    [[nodiscard]] bool valid() const noexcept { return state_ != nullptr; }
+    [[nodiscard]] bool ready() const noexcept { return state_->ready.load(std::memory_order_acquire); }
+
+    const cc::result<T>& get() const {
+        while (!ready()) {
+            if (!system_->run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        return *state_->value;
+    }
+
+    template<typename F>
+    [[nodiscard]] auto then(F&& f) {
+        using U = typename detail::continuation_result<T, std::decay_t<F>&>::type::value_type;
+
+        auto next = std::make_shared<detail::job_state<U>>();
+        job_system* system = system_;
+        auto continuation = [prev = state_, next, system, fn = std::forward<F>(f)]() mutable {
+            const cc::result<T>& in = *prev->value;
+            if (!in) {
+                job<U>::complete(*next, *system, std::unexpected(in.error()));
+            } else if constexpr (std::is_void_v<T>) {
+                job<U>::complete(*next, *system, detail::invoke_as_result(fn));
+            } else {
+                job<U>::complete(*next, *system, detail::invoke_as_result(fn, *in));
+            }
+        };
+
+        std::unique_lock lock(state_->mutex);
+        if (state_->value) {
+            lock.unlock();
+            system_->spawn(std::move(continuation));
+        } else {
+            state_->continuations.emplace_back(std::move(continuation));
+        }
+        return job<U>(std::move(next), system_);
+    }
+
+private:
+    friend class job_system;
+    template<typename>
+    friend class job;
+
+    job(std::shared_ptr<detail::job_state<T>> state, job_system* system) noexcept
+    : state_(std::move(state)), system_(system) {}
+
+    static void complete(detail::job_state<T>& state, job_system& system, cc::result<T> value) {
+        std::vector<std::move_only_function<void()>> continuations;
+        {
+            std::lock_guard lock(state.mutex);
+            state.value.emplace(std::move(value));
+            continuations.swap(state.continuations);
+        }
+        state.ready.store(true, std::memory_order_release);
+        for (auto& c : continuations) {
+            system.spawn(std::move(c));
+        }
+    }
+
+    std::shared_ptr<detail::job_state<T>> state_;
+    job_system* system_{nullptr};
+};
+
+template<typename F>
+    requires std::invocable<F&>
+auto job_system::async(F&& f) -> job<typename detail::job_result_t<std::decay_t<F>&>::value_type> {
+    using T = typename detail::job_result_t<std::decay_t<F>&>::value_type;
+    auto state = std::make_shared<detail::job_state<T>>();
+    spawn([state, this, fn = std::forward<F>(f)]() mutable {
+        job<T>::complete(*state, *this, detail::invoke_as_result(fn));
+    });
+    return job<T>(std::move(state), this);
+}
+
+//NOTE: fork/join scope. Tasks return void or cc::result<void>, the first error (or exception)
+// cancels tasks that have not started yet and is returned by wait(). The destructor waits
+class task_group {
+public:
+    explicit task_group(job_system& system = job_system::global()) noexcept
+    : system_(system) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() { (void)wait(); }
+
+    template<typename F>
+        requires std::invocable<F&>
+    void run(F&& f) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        system_.spawn([this, fn = std::forward<F>(f)]() mutable {
+            if (!cancelled()) {
+                if (auto res = detail::invoke_as_result(fn); !res) {
+                    fail(res.error());
+                }
+            }
+            //NOTE: last access to the group, wait() may return and destroy it right after
+            pending_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    [[nodiscard]] cc::result<void> wait() {
+        while (pending_.load(std::memory_order_acquire) > 0) {
+            if (!system_.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        if (failed_.load(std::memory_order_acquire)) {
+            return cc::err(*error_);
+        }
+        return cc::ok();
+    }
+
+    void cancel() noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]] bool cancelled() const noexcept {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] job_system& system() const noexcept { return system_; }
+
+    //NOTE: records `e` unless an earlier error was recorded, and cancels the group
+    void fail(const cc::error& e) {
+        std::lock_guard lock(error_mutex_);
+        if (!failed_.load(std::memory_order_relaxed)) {
+            error_.emplace(e);
+            failed_.store(true, std::memory_order_release);
+        }
+        cancel();
+    }
+
+private:
+    job_system& system_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> failed_{false};
+    std::mutex error_mutex_;
+    std::optional<cc::error> error_;
+};
+
+namespace detail {
+
+template<typename F>
+concept range_body = std::invocable<F&, size_t, size_t>;
+
+template<typename F>
+concept index_body = std::invocable<F&, size_t>;
+
+template<typename F>
+cc::result<void> run_range(F& body, size_t begin, size_t end) {
+    if constexpr (range_body<F>) {
+        return invoke_as_result(body, begin, end);
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            if (auto res = invoke_as_result(body, i); !res) {
+                return res;
+            }
+        }
+        return cc::ok();
+    }
+}
+
+//NOTE: splits off the upper half as a task until the range is within the grain, so thieves take
+// the largest pieces first
+template<typename F>
+void split_range(task_group& group, F& body, size_t begin, size_t end, size_t grain) {
+    while (end - begin > grain) {
+        size_t mid = begin + (end - begin) / 2;
+        group.run([&group, &body, mid, end, grain]() -> cc::result<void> {
+            split_range(group, body, mid, end, grain);
+            return cc::ok();
+        });
+        end = mid;
+    }
+    if (group.cancelled()) {
+        return;
+    }
+    if (auto res = run_range(body, begin, end); !res) {
+        group.fail(res.error());
+    }
+}
+
+} // namespace detail
+
+//NOTE: calls body(i) for every i in [begin, end), or body(lo, hi) for sub ranges when it takes two
+// indices. Ranges of at most `grain` run serially, 0 picks about 8 pieces per thread. Returns the
+// first error reported by the body
+template<typename F>
+    requires detail::range_body<F> || detail::index_body<F>
+cc::result<void> parallel_for(size_t begin, size_t end, size_t grain, F&& body,
+                              job_system& system = job_system::global()) {
+    if (begin >= end) {
+        return cc::ok();
+    }
+    size_t count = end - begin;
+    if (grain == 0) {
+        grain = std::max<size_t>(1, count / ((system.thread_count() + 1) * 8));
+    }
+    if (count <= grain) {
+        return detail::run_range(body, begin, end);
+    }
+
+    task_group group(system);
+    detail::split_range(group, body, begin, end, grain);
+    return group.wait();
+}
+
+template<typename F>
+    requires detail::range_body<F> || detail::index_body<F>
+cc::result<void> parallel_for(size_t begin, size_t end, F&& body, job_system& system = job_system::global()) {
+    return parallel_for(begin, end, 0, std::forward<F>(body), system);
+}
+
+} // namespace cc
@@ -1,9 +1,28 @@
 #pragma once
+#include <atomic>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+//NOTE: build time minimum level, calls below it compile to nothing. Set through the
+// CBOX_LOG_LEVEL cache variable, the CC_LOG_* macros also skip evaluating their arguments
+#define CBOX_LOG_LEVEL_TRACE 0
+#define CBOX_LOG_LEVEL_DEBUG 1
+#define CBOX_LOG_LEVEL_INFO 2
+#define CBOX_LOG_LEVEL_WARN 3
+#define CBOX_LOG_LEVEL_ERROR 4
+#define CBOX_LOG_LEVEL_CRITICAL 5
+#define CBOX_LOG_LEVEL_OFF 6
+
+#ifndef CBOX_LOG_LEVEL
+#define CBOX_LOG_LEVEL CBOX_LOG_LEVEL_TRACE
+#endif
+
 namespace cc::log {
 
 enum class Level {
@@ -34,6 +53,141 @@ inline spdlog::level::level_enum ToSpdlogLevel(Level level) noexcept {
         default:              return spdlog::level::info;
     }
 }
+
+[[nodiscard]] constexpr bool CompiledIn(Level level) noexcept {
+    return static_cast<int>(level) >= CBOX_LOG_LEVEL;
+}
+
+inline std::atomic<Level>& RuntimeLevel() noexcept {
+    static std::atomic<Level> g_level{Level::Trace};
+    return g_level;
+}
+
+inline std::atomic<bool>& AsyncEnabled() noexcept {
+    static std::atomic<bool> g_async{false};
+    return g_async;
+}
+
+//NOTE: threads between their AsyncEnabled() check and the commit of their record, Shutdown()
+// waits for zero before the last drain
+inline std::atomic<uint32_t>& AsyncWriters() noexcept {
+    static std::atomic<uint32_t> g_writers{0};
+    return g_writers;
+}
+
+struct AsyncWriteScope {
+    AsyncWriteScope() noexcept { AsyncWriters().fetch_add(1, std::memory_order_seq_cst); }
+    ~AsyncWriteScope() { AsyncWriters().fetch_sub(1, std::memory_order_release); }
+
+    AsyncWriteScope(const AsyncWriteScope&) = delete;
+    AsyncWriteScope& operator=(const AsyncWriteScope&) = delete;
+};
+
+//NOTE: async records copy the format string and the arguments into a per-thread ring, the
+// background thread decodes and formats them. Strings are copied as text, numbers and enums by
+// value, a call with any other argument type is formatted on the calling thread instead
+using FormatFn = void (*)(const std::byte* payload, fmt::memory_buffer& out, std::string_view fmt);
+
+template<typename T>
+concept LogString = std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, std::nullptr_t>;
+
+template<typename T>
+concept LogDeferrable = LogString<T> || std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template<typename T>
+using Decoded = std::conditional_t<LogString<T>, std::string_view, T>;
+
+template<typename T>
+[[nodiscard]] size_t EncodedSize(const T& value) noexcept {
+    if constexpr (LogString<T>) {
+        return sizeof(uint32_t) + std::string_view(value).size();
+    } else {
+        return sizeof(T);
+    }
+}
+
+template<typename T>
+std::byte* Encode(std::byte* out, const T& value) noexcept {
+    if constexpr (LogString<T>) {
+        std::string_view text(value);
+        auto size = static_cast<uint32_t>(text.size());
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), text.data(), text.size());
+        return out + sizeof(size) + text.size();
+    } else {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+}
+
+template<typename T>
+Decoded<T> Decode(const std::byte*& in) noexcept {
+    if constexpr (LogString<T>) {
+        uint32_t size;
+        std::memcpy(&size, in, sizeof(size));
+        std::string_view text(reinterpret_cast<const char*>(in + sizeof(size)), size);
+        in += sizeof(size) + size;
+        return text;
+    } else {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+}
+
+template<typename... T>
+void FormatRecord([[maybe_unused]] const std::byte* payload, fmt::memory_buffer& out, std::string_view fmt) {
+    //NOTE: braced initialization decodes the arguments left to right
+    std::tuple<Decoded<T>...> args{Decode<T>(payload)...};
+    std::apply([&](auto&... values) {
+        fmt::vformat_to(fmt::appender(out), fmt, fmt::make_format_args(values...));
+    }, args);
+}
+
+//NOTE: reserves a record in the calling thread's ring, copies `fmt` and returns the payload area,
+// or nullptr when the ring is full (the record is dropped and counted)
+[[nodiscard]] std::byte* BeginRecord(std::string_view fmt, size_t payload_size) noexcept;
+void CommitRecord(Level level, FormatFn format) noexcept;
+
+template<typename... Args>
+void LogAsync(Level level, std::string_view fmt, const Args&... args) {
+    if constexpr ((LogDeferrable<std::remove_cvref_t<Args>> && ...)) {
+        size_t size = (size_t{0} + ... + EncodedSize(args));
+        std::byte* out = BeginRecord(fmt, size);
+        if (out == nullptr) {
+            return;
+        }
+        ((out = Encode(out, args)), ...);
+        CommitRecord(level, &FormatRecord<std::remove_cvref_t<Args>...>);
+    } else {
+        fmt::memory_buffer text;
+        fmt::vformat_to(fmt::appender(text), fmt, fmt::make_format_args(args...));
+        LogAsync(level, "{}", std::string_view(text.data(), text.size()));
+    }
+}
+
+template<typename... Args>
+void Log(Level level, fmt::format_string<Args...> fmt, Args&&... args) {
+    if (level < RuntimeLevel().load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (AsyncEnabled().load(std::memory_order_acquire)) {
+        //NOTE: announced before the second check, so Shutdown() either sees this writer or it
+        // sees async logging already disabled
+        AsyncWriteScope scope;
+        if (AsyncEnabled().load(std::memory_order_seq_cst)) {
+            fmt::string_view text = fmt;
+            LogAsync(level, std::string_view(text.data(), text.size()), args...);
+            return;
+        }
+    }
+
+    auto& logger = GetLoggerInstance();
+    if (logger) {
+        logger->log(ToSpdlogLevel(level), fmt, std::forward<Args>(args)...);
+    }
+}
 }
 
 inline void Init(const std::string_view &name) {
@@ -42,6 +196,14 @@ inline void Init(const std::string_view &name) {
     detail::GetLoggerInstance()->set_level(spdlog::level::trace);
 }
 
+//NOTE: switches every cc::log call to the async backend, one ring of `ring_bytes` per logging
+// thread. Shutdown() drains the rings and returns to synchronous logging, it also runs at exit
+void InitAsync(const std::string_view& name, size_t ring_bytes = 256 * 1024);
+void Shutdown();
+
+//NOTE: records dropped because a ring was full since InitAsync()
+[[nodiscard]] uint64_t DroppedCount() noexcept;
+
 inline void SetLevel(Level level) noexcept {
     auto spdlog_level = detail::ToSpdlogLevel(level);
     auto& logger = detail::GetLoggerInstance();
@@ -49,6 +211,7 @@ inline void SetLevel(Level level) noexcept {
         logger->set_level(spdlog_level);
     }
     spdlog::set_level(spdlog_level);
+    detail::RuntimeLevel().store(level, std::memory_order_relaxed);
 }
 
 inline std::shared_ptr<spdlog::logger>& GetLogger() noexcept {
@@ -56,51 +219,81 @@ inline std::shared_ptr<spdlog::logger>& GetLogger() noexcept {
 }
 
 template<typename... Args>
-inline void Trace(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->trace(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Trace(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Trace)) {
+        detail::Log(Level::Trace, fmt, std::forward<Args>(args)...);
     }
 }
 
 template<typename... Args>
-inline void Debug(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->debug(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Debug(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Debug)) {
+        detail::Log(Level::Debug, fmt, std::forward<Args>(args)...);
     }
 }
 
 template<typename... Args>
-inline void Info(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->info(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Info(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Info)) {
+        detail::Log(Level::Info, fmt, std::forward<Args>(args)...);
     }
 }
 
 template<typename... Args>
-inline void Warn(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->warn(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Warn(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Warn)) {
+        detail::Log(Level::Warn, fmt, std::forward<Args>(args)...);
     }
 }
 
 template<typename... Args>
-inline void Error(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->error(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Error(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Error)) {
+        detail::Log(Level::Error, fmt, std::forward<Args>(args)...);
     }
 }
 
 template<typename... Args>
-inline void Critical(std::string_view fmt, Args&&... args) {
-    auto& logger = GetLogger();
-    if (logger) {
-        logger->critical(fmt::runtime(fmt), std::forward<Args>(args)...);
+inline void Critical(fmt::format_string<Args...> fmt, Args&&... args) {
+    if constexpr (detail::CompiledIn(Level::Critical)) {
+        detail::Log(Level::Critical, fmt, std::forward<Args>(args)...);
     }
 }
 
 }
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_TRACE
+#define CC_LOG_TRACE(...) ::cc::log::Trace(__VA_ARGS__)
+#else
+#define CC_LOG_TRACE(...) ((void)0)
+#endif
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_DEBUG
+#define CC_LOG_DEBUG(...) ::cc::log::Debug(__VA_ARGS__)
+#else
+#define CC_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_INFO
+#define CC_LOG_INFO(...) ::cc::log::Info(__VA_ARGS__)
+#else
+#define CC_LOG_INFO(...) ((void)0)
+#endif
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_WARN
+#define CC_LOG_WARN(...) ::cc::log::Warn(__VA_ARGS__)
+#else
+#define CC_LOG_WARN(...) ((void)0)
+#endif
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_ERROR
+#define CC_LOG_ERROR(...) ::cc::log::Error(__VA_ARGS__)
+#else
+#define CC_LOG_ERROR(...) ((void)0)
+#endif
+
+#if CBOX_LOG_LEVEL <= CBOX_LOG_LEVEL_CRITICAL
+#define CC_LOG_CRITICAL(...) ::cc::log::Critical(__VA_ARGS__)
+#else
+#define CC_LOG_CRITICAL(...) ((void)0)
+#endif
@@ -0,0 +1,231 @@
+#pragma once
+#include "types.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace cc {
+
+//NOTE: monotonic bump allocator, deallocate is a no-op. reset() rewinds to the first block and
+// keeps every block for reuse, release() hands them back to the upstream resource. Not thread safe
+class arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t default_block_size = 64 * 1024;
+    static constexpr size_t max_block_size = 16 * 1024 * 1024;
+
+    explicit arena(size_t block_size = default_block_size,
+                   std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+    : upstream_(upstream), block_size_(block_size), next_size_(block_size) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() override { release(); }
+
+    void reset() noexcept;
+    void release() noexcept;
+
+    //NOTE: bytes handed out since the last reset, and bytes held from upstream
+    [[nodiscard]] size_t used() const noexcept { return used_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = cursor_;
+        size_t space = static_cast<size_t>(end_ - cursor_);
+        if (cursor_ != nullptr && std::align(alignment, bytes, p, space)) {
+            cursor_ = static_cast<std::byte*>(p) + bytes;
+            used_ += bytes;
+            return p;
+        }
+        return grow(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) noexcept override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct block {
+        block* next;
+        size_t size;
+
+        [[nodiscard]] std::byte* begin() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+        [[nodiscard]] std::byte* end() noexcept { return begin() + size; }
+    };
+
+    void* grow(size_t bytes, size_t alignment);
+    void enter(block* b) noexcept;
+
+    std::pmr::memory_resource* upstream_;
+    block* head_{nullptr};
+    block* current_{nullptr};
+    std::byte* cursor_{nullptr};
+    std::byte* end_{nullptr};
+    size_t block_size_;
+    size_t next_size_;
+    size_t used_{0};
+    size_t capacity_{0};
+};
+
+//NOTE: two arenas used on alternate frames. begin_frame() flips and resets the arena about to be
+// filled, so memory allocated during frame N stays valid until begin_frame() of frame N + 2
+class frame_allocator : public std::pmr::memory_resource {
+public:
+    explicit frame_allocator(size_t block_size = arena::default_block_size,
+                             std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+    : arenas_{arena(block_size, upstream), arena(block_size, upstream)} {}
+
+    void begin_frame() noexcept {
+        index_ ^= 1;
+        arenas_[index_].reset();
+        ++frame_;
+    }
+
+    [[nodiscard]] arena& current() noexcept { return arenas_[index_]; }
+    [[nodiscard]] arena& previous() noexcept { return arenas_[index_ ^ 1]; }
+    [[nodiscard]] u64 frame() const noexcept { return frame_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return arenas_[index_].allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) noexcept override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    arena arenas_[2];
+    u32 index_{0};
+    u64 frame_{0};
+};
+
+//NOTE: fixed size object pool, slots come from chunks of `chunk_slots` and are recycled through
+// a free list. As a memory_resource it pools single requests that fit a slot of T and forwards the
+// rest upstream. Node based containers rebind to their node type, which is larger than T (links,
+// cached hash), so a pmr list or map of T gains nothing from a pool<T>; the pool is meant for
+// create()/destroy() and for resources whose allocations are known to fit. Not thread safe,
+// destroying the pool does not run destructors of live objects
+template<typename T>
+class pool : public std::pmr::memory_resource {
+    union slot {
+        slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    struct chunk {
+        chunk* next;
+    };
+
+    static constexpr size_t chunk_header = (sizeof(chunk) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+    static constexpr size_t chunk_align = alignof(slot) > alignof(chunk) ? alignof(slot) : alignof(chunk);
+
+public:
+    static constexpr size_t default_chunk_slots = 256;
+
+    explicit pool(size_t chunk_slots = default_chunk_slots,
+                  std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+    : upstream_(upstream), chunk_slots_(chunk_slots > 0 ? chunk_slots : 1) {}
+
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    ~pool() override {
+        while (chunks_ != nullptr) {
+            chunk* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunk_bytes(), chunk_align);
+            chunks_ = next;
+        }
+    }
+
+    template<typename... Args>
+    [[nodiscard]] T* create(Args&&... args) {
+        void* p = acquire();
+        try {
+            return std::construct_at(static_cast<T*>(p), std::forward<Args>(args)...);
+        } catch (...) {
+            recycle(p);
+            throw;
+        }
+    }
+
+    void destroy(T* object) noexcept {
+        if (object != nullptr) {
+            std::destroy_at(object);
+            recycle(object);
+        }
+    }
+
+    //NOTE: live slots and slots held in chunks
+    [[nodiscard]] size_t size() const noexcept { return live_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes <= sizeof(slot) && alignment <= alignof(slot)) {
+            return acquire();
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) noexcept override {
+        if (bytes <= sizeof(slot) && alignment <= alignof(slot)) {
+            recycle(p);
+        } else {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    [[nodiscard]] size_t chunk_bytes() const noexcept {
+        return chunk_header + chunk_slots_ * sizeof(slot);
+    }
+
+    void* acquire() {
+        if (free_ == nullptr) {
+            auto* c = static_cast<chunk*>(upstream_->allocate(chunk_bytes(), chunk_align));
+            c->next = chunks_;
+            chunks_ = c;
+
+            auto* slots = reinterpret_cast<slot*>(reinterpret_cast<std::byte*>(c) + chunk_header);
+            for (size_t i = chunk_slots_; i > 0; --i) {
+                slots[i - 1].next = free_;
+                free_ = &slots[i - 1];
+            }
+            capacity_ += chunk_slots_;
+        }
+
+        slot* s = free_;
+        free_ = s->next;
+        ++live_;
+        return s;
+    }
+
+    void recycle(void* p) noexcept {
+        auto* s = static_cast<slot*>(p);
+        s->next = free_;
+        free_ = s;
+        --live_;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    chunk* chunks_{nullptr};
+    slot* free_{nullptr};
+    size_t chunk_slots_;
+    size_t live_{0};
+    size_t capacity_{0};
+};
+
+} // namespace cc
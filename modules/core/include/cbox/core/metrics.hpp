@@ -0,0 +1,224 @@
+#pragma once
+#include "types.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace cc::metrics {
+
+namespace detail {
+
+inline constexpr size_t cache_line = 64;
+inline constexpr size_t shard_count = 16;
+
+//NOTE: threads are spread over the shards round robin on first use
+inline size_t shard_index() noexcept {
+    static std::atomic<size_t> g_next{0};
+    thread_local size_t t_index = g_next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+    return t_index;
+}
+
+struct alignas(cache_line) shard {
+    std::atomic<u64> value{0};
+};
+
+} // namespace detail
+
+//NOTE: monotonic, each thread adds to its own cache line and reads sum all shards
+class counter {
+public:
+    counter(std::string name, std::string help) : name_(std::move(name)), help_(std::move(help)) {}
+
+    counter(const counter&) = delete;
+    counter& operator=(const counter&) = delete;
+
+    void add(u64 n = 1) noexcept {
+        shards_[detail::shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] u64 value() const noexcept {
+        u64 total = 0;
+        for (const auto& s : shards_) {
+            total += s.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+
+private:
+    std::array<detail::shard, detail::shard_count> shards_;
+    std::string name_;
+    std::string help_;
+};
+
+//NOTE: last written value, f64 stored by bit pattern
+class gauge {
+public:
+    gauge(std::string name, std::string help) : name_(std::move(name)), help_(std::move(help)) {}
+
+    gauge(const gauge&) = delete;
+    gauge& operator=(const gauge&) = delete;
+
+    void set(f64 value) noexcept {
+        bits_.store(std::bit_cast<u64>(value), std::memory_order_relaxed);
+    }
+
+    void add(f64 delta) noexcept {
+        u64 expected = bits_.load(std::memory_order_relaxed);
+        while (!bits_.compare_exchange_weak(expected, std::bit_cast<u64>(std::bit_cast<f64>(expected) + delta),
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] f64 value() const noexcept {
+        return std::bit_cast<f64>(bits_.load(std::memory_order_relaxed));
+    }
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+
+private:
+    std::atomic<u64> bits_{std::bit_cast<u64>(0.0)};
+    std::string name_;
+    std::string help_;
+};
+
+//NOTE: HDR style log-linear buckets over the full u64 range. Values below 16 are exact, above that
+// every power of two is split into 16 linear sub-buckets, so a reported value is within 1/16 of
+// the recorded one
+class histogram {
+public:
+    static constexpr u32 sub_bits = 4;
+    static constexpr u32 sub_count = 1u << sub_bits;
+    static constexpr size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+    histogram(std::string name, std::string help) : name_(std::move(name)), help_(std::move(help)) {}
+
+    histogram(const histogram&) = delete;
+    histogram& operator=(const histogram&) = delete;
+
+    [[nodiscard]] static constexpr size_t bucket_of(u64 value) noexcept {
+        if (value < sub_count) {
+            return static_cast<size_t>(value);
+        }
+        u32 exponent = static_cast<u32>(std::bit_width(value)) - 1;
+        u64 sub = (value >> (exponent - sub_bits)) & (sub_count - 1);
+        return (exponent - sub_bits + 1) * sub_count + static_cast<size_t>(sub);
+    }
+
+    //NOTE: smallest value that lands in `bucket`
+    [[nodiscard]] static constexpr u64 bucket_lower(size_t bucket) noexcept {
+        if (bucket < sub_count) {
+            return bucket;
+        }
+        u32 exponent = static_cast<u32>(bucket / sub_count) + sub_bits - 1;
+        u64 sub = bucket % sub_count;
+        return (sub_count + sub) << (exponent - sub_bits);
+    }
+
+    void record(u64 value) noexcept {
+        buckets_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        u64 low = min_.load(std::memory_order_relaxed);
+        while (value < low && !min_.compare_exchange_weak(low, value, std::memory_order_relaxed)) {
+        }
+        u64 high = max_.load(std::memory_order_relaxed);
+        while (value > high && !max_.compare_exchange_weak(high, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> elapsed) noexcept {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(static_cast<u64>(ns > 0 ? ns : 0));
+    }
+
+    [[nodiscard]] u64 count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] u64 sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+    [[nodiscard]] u64 min() const noexcept { return count() != 0 ? min_.load(std::memory_order_relaxed) : 0; }
+    [[nodiscard]] u64 max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+    //NOTE: `q` in [0, 1]. Reads race with writers, the result is consistent to within the samples
+    // recorded during the walk
+    [[nodiscard]] u64 percentile(f64 q) const noexcept;
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+    [[nodiscard]] const std::string& help() const noexcept { return help_; }
+
+private:
+    std::array<std::atomic<u64>, bucket_count> buckets_{};
+    std::atomic<u64> count_{0};
+    std::atomic<u64> sum_{0};
+    std::atomic<u64> min_{~u64{0}};
+    std::atomic<u64> max_{0};
+    std::string name_;
+    std::string help_;
+};
+
+//NOTE: records the elapsed time in nanoseconds into `target` when it goes out of scope
+class timer {
+public:
+    explicit timer(histogram& target) noexcept
+    : target_(target), begin_(std::chrono::steady_clock::now()) {}
+
+    timer(const timer&) = delete;
+    timer& operator=(const timer&) = delete;
+
+    ~timer() { target_.record(std::chrono::steady_clock::now() - begin_); }
+
+private:
+    histogram& target_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+//NOTE: registration takes a lock and allocates, recording through the returned references does
+// neither. Metrics are never removed so references stay valid for the registry's lifetime;
+// call sites are expected to cache them in a function local static
+class registry {
+public:
+    registry() = default;
+    registry(const registry&) = delete;
+    registry& operator=(const registry&) = delete;
+
+    static registry& global();
+
+    //NOTE: returns the already registered metric when `name` is taken
+    counter& get_counter(std::string_view name, std::string_view help = {});
+    gauge& get_gauge(std::string_view name, std::string_view help = {});
+    histogram& get_histogram(std::string_view name, std::string_view help = {});
+
+    //NOTE: one object per metric, histograms report count, sum, min, max and p50/p90/p99/p999
+    [[nodiscard]] std::string to_json() const;
+
+    //NOTE: Prometheus text exposition format, histograms are exported as summaries
+    [[nodiscard]] std::string to_text() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<counter> counters_;
+    std::deque<gauge> gauges_;
+    std::deque<histogram> histograms_;
+};
+
+inline counter& get_counter(std::string_view name, std::string_view help = {}) {
+    return registry::global().get_counter(name, help);
+}
+
+inline gauge& get_gauge(std::string_view name, std::string_view help = {}) {
+    return registry::global().get_gauge(name, help);
+}
+
+inline histogram& get_histogram(std::string_view name, std::string_view help = {}) {
+    return registry::global().get_histogram(name, help);
+}
+
+} // namespace cc::metrics
@@ -0,0 +1,129 @@
+#pragma once
+#include "types.hpp"
+#include <atomic>
+#include <compare>
+#include <functional>
+#include <string_view>
+#include <fmt/format.h>
+
+namespace cc {
+
+namespace detail {
+
+[[nodiscard]] constexpr u64 fnv1a(std::string_view text) noexcept {
+    u64 h = 0xcbf29ce484222325ull;
+    for (char c : text) {
+        h ^= static_cast<u8>(c);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+//NOTE: interns `text` for ids built from runtime strings and warns when two strings share a hash
+const char* remember_name(u64 hash, std::string_view text);
+
+//NOTE: on by default when cbox_core itself is a Debug build
+[[nodiscard]] bool name_tracking_default() noexcept;
+
+inline std::atomic<bool>& name_tracking_flag() noexcept {
+    static std::atomic<bool> g_tracking{name_tracking_default()};
+    return g_tracking;
+}
+
+[[nodiscard]] constexpr size_t bounded_length(const char* text, size_t n) noexcept {
+    size_t length = 0;
+    while (length < n && text[length] != '\0') {
+        ++length;
+    }
+    return length;
+}
+
+} // namespace detail
+
+//NOTE: 64 bit FNV-1a hash of a name plus a pointer to its source string. Built from a literal
+// in a constant expression (the _id literal, a constexpr id) the hash is computed at compile time,
+// so lookups keyed by a name_id never touch the string. Equality is by hash only.
+//
+// The layout does not depend on the build configuration. Constant evaluated ids always keep their
+// string, ids built at runtime keep an interned copy only while name tracking is on
+class name_id {
+public:
+    constexpr name_id() noexcept = default;
+
+    //NOTE: the text runs up to the first NUL in the array. A runtime array is hashed at runtime
+    template <size_t N>
+    constexpr explicit name_id(const char (&text)[N]) noexcept
+    : name_id(std::string_view(text, detail::bounded_length(text, N))) {
+        if consteval {
+            debug_ = text;
+        }
+    }
+
+    constexpr explicit name_id(std::string_view text) noexcept
+    : hash_(detail::fnv1a(text)) {
+        if !consteval {
+            if (detail::name_tracking_flag().load(std::memory_order_relaxed)) {
+                debug_ = detail::remember_name(hash_, text);
+            }
+        }
+    }
+
+    [[nodiscard]] static constexpr name_id from_hash(u64 hash) noexcept {
+        name_id id;
+        id.hash_ = hash;
+        return id;
+    }
+
+    //NOTE: `text` must have static storage, used by the _id literal
+    [[nodiscard]] static consteval name_id from_literal(const char* text, size_t size) noexcept {
+        name_id id = from_hash(detail::fnv1a(std::string_view(text, size)));
+        id.debug_ = text;
+        return id;
+    }
+
+    [[nodiscard]] constexpr u64 value() const noexcept { return hash_; }
+    [[nodiscard]] constexpr bool is_null() const noexcept { return hash_ == 0; }
+
+    //NOTE: the source string when it was kept, empty otherwise
+    [[nodiscard]] constexpr std::string_view name() const noexcept {
+        return debug_ != nullptr ? std::string_view(debug_) : std::string_view{};
+    }
+
+    friend constexpr bool operator==(name_id a, name_id b) noexcept { return a.hash_ == b.hash_; }
+    friend constexpr auto operator<=>(name_id a, name_id b) noexcept { return a.hash_ <=> b.hash_; }
+
+private:
+    u64 hash_{0};
+    const char* debug_{nullptr};
+};
+
+//NOTE: interning of runtime built ids for name() and collision warnings. Takes effect for ids built
+// afterwards
+inline void set_name_tracking(bool enabled) noexcept {
+    detail::name_tracking_flag().store(enabled, std::memory_order_relaxed);
+}
+
+namespace literals {
+
+consteval name_id operator""_id(const char* text, size_t size) noexcept {
+    return name_id::from_literal(text, size);
+}
+
+} // namespace literals
+
+} // namespace cc
+
+template <>
+struct std::hash<cc::name_id> {
+    size_t operator()(cc::name_id id) const noexcept { return static_cast<size_t>(id.value()); }
+};
+
+template <>
+struct fmt::formatter<cc::name_id> : fmt::formatter<std::string_view> {
+    auto format(cc::name_id id, format_context& ctx) const {
+        if (auto name = id.name(); !name.empty()) {
+            return fmt::formatter<std::string_view>::format(name, ctx);
+        }
+        return fmt::format_to(ctx.out(), "#{:016x}", id.value());
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include "types.hpp"
+#include "result.hpp"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+
+//NOTE: instrumentation is compiled in with the CBOX_ENABLE_PROFILING cache option. Without it
+// every CC_PROFILE_* macro expands to nothing and no zone code is emitted
+#ifndef CBOX_PROFILE
+#define CBOX_PROFILE 0
+#endif
+
+namespace cc::profile {
+
+enum class event_kind : u8 {
+    zone,
+    counter,
+    frame
+};
+
+//NOTE: `name` must outlive the profiler, macros only pass string literals. Zones use begin/end,
+// counters store the bit pattern of their f64 value in `end`
+struct event {
+    const char* name;
+    u64 begin;
+    u64 end;
+    event_kind kind;
+};
+
+namespace detail {
+
+inline std::atomic<bool>& enabled_flag() noexcept {
+    static std::atomic<bool> g_enabled{true};
+    return g_enabled;
+}
+
+//NOTE: appends to the calling thread's buffer, a chain of fixed size chunks only that thread
+// writes. The exporter reads published events concurrently. Past the event limit the event is
+// dropped and counted instead
+void record(const char* name, u64 begin, u64 end, event_kind kind) noexcept;
+
+} // namespace detail
+
+//NOTE: nanoseconds since the first call in the process
+[[nodiscard]] inline u64 now() noexcept {
+    static const auto g_origin = std::chrono::steady_clock::now();
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_origin).count());
+}
+
+[[nodiscard]] inline bool enabled() noexcept {
+    return detail::enabled_flag().load(std::memory_order_relaxed);
+}
+
+//NOTE: pauses or resumes recording, already recorded events are kept
+inline void set_enabled(bool enabled) noexcept {
+    detail::enabled_flag().store(enabled, std::memory_order_relaxed);
+}
+
+inline void counter(const char* name, f64 value) noexcept {
+    if (enabled()) {
+        detail::record(name, now(), std::bit_cast<u64>(value), event_kind::counter);
+    }
+}
+
+inline void frame(const char* name = "frame") noexcept {
+    if (enabled()) {
+        detail::record(name, now(), 0, event_kind::frame);
+    }
+}
+
+//NOTE: shown as the track name of the calling thread in the trace viewer
+void set_thread_name(const char* name);
+
+//NOTE: events recorded so far by all threads
+[[nodiscard]] size_t event_count() noexcept;
+
+inline constexpr size_t default_event_limit = size_t{1} << 20;
+
+//NOTE: events each thread keeps until the next reset(), rounded up to whole chunks. Events past it
+// are counted by dropped_count()
+void set_event_limit(size_t events_per_thread) noexcept;
+
+//NOTE: events not recorded since the last reset(), because a thread hit the limit or a chunk
+// allocation failed
+[[nodiscard]] u64 dropped_count() noexcept;
+
+//NOTE: discards every recorded event and the drop count. Each thread recycles its chunks on its
+// next event, buffers of exited threads are freed. Long sessions export and reset periodically,
+// or capture a window between set_enabled(true) and set_enabled(false)
+void reset();
+
+//NOTE: writes every recorded event as Chrome trace event JSON, readable by chrome://tracing and
+// ui.perfetto.dev
+[[nodiscard]] cc::result<void> write_chrome_trace(const std::filesystem::path& path);
+
+class scope {
+    static constexpr u64 inactive = ~u64{0};
+
+public:
+    explicit scope(const char* name) noexcept
+    : name_(name), begin_(enabled() ? now() : inactive) {}
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    ~scope() {
+        if (begin_ != inactive) {
+            detail::record(name_, begin_, now(), event_kind::zone);
+        }
+    }
+
+private:
+    const char* name_;
+    u64 begin_;
+};
+
+} // namespace cc::profile
+
+#define CC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CC_PROFILE_CONCAT(a, b) CC_PROFILE_CONCAT_IMPL(a, b)
+
+#if CBOX_PROFILE
+#define CC_PROFILE_SCOPE(name) ::cc::profile::scope CC_PROFILE_CONCAT(cc_profile_scope_, __LINE__)(name)
+#define CC_PROFILE_FUNCTION() CC_PROFILE_SCOPE(__func__)
+#define CC_PROFILE_COUNTER(name, value) ::cc::profile::counter(name, static_cast<::cc::f64>(value))
+#define CC_PROFILE_FRAME() ::cc::profile::frame()
+#define CC_PROFILE_THREAD(name) ::cc::profile::set_thread_name(name)
+#else
+#define CC_PROFILE_SCOPE(name) ((void)0)
+#define CC_PROFILE_FUNCTION() ((void)0)
+#define CC_PROFILE_COUNTER(name, value) ((void)0)
+#define CC_PROFILE_FRAME() ((void)0)
+#define CC_PROFILE_THREAD(name) ((void)0)
+#endif
@@ -17,19 +17,19 @@ constexpr auto ok() noexcept -> result<void> {
     return result<void>();
 }
 
-inline auto err(error_code code, std::string_view msg,
+constexpr auto err(error_code code, error_message msg,
                 std::source_location loc = std::source_location::current()) noexcept 
     -> std::unexpected<error> {
     return std::unexpected<error>(error(code, msg, loc));
 }
 
-inline auto err(error_code code,
+constexpr auto err(error_code code,
                 std::source_location loc = std::source_location::current()) noexcept
     -> std::unexpected<error> {
     return std::unexpected<error>(error(code, "", loc));
 }
 
-inline auto err(const error& e) noexcept -> std::unexpected<error> {
+constexpr auto err(const error& e) noexcept -> std::unexpected<error> {
     return std::unexpected<error>(e);
 }
 
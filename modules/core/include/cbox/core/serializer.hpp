@@ -0,0 +1,363 @@
+#pragma once
+#include "bulk_copy.hpp"
+#include "concepts.hpp"
+#include "result.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cc {
+
+//NOTE: sequential writer over a buffer sized up front by serialized_size(), writes past the end
+// are dropped and reported by overflowed()
+class byte_writer {
+public:
+    explicit byte_writer(std::span<std::byte> out) noexcept
+    : out_(out) {}
+
+    void write_bytes(std::span<const std::byte> data) noexcept {
+        if (data.size() > out_.size() - pos_) {
+            overflow_ = true;
+            return;
+        }
+        if (!data.empty()) {
+            std::memcpy(out_.data() + pos_, data.data(), data.size());
+        }
+        pos_ += data.size();
+    }
+
+    template<trivially_copyable T>
+    void write(const T& value) noexcept {
+        write_bytes(std::as_bytes(std::span<const T>(&value, 1)));
+    }
+
+    template<trivially_copyable T>
+    void write_array(std::span<const T> values) noexcept {
+        write_bytes(std::as_bytes(values));
+    }
+
+    [[nodiscard]] size_t written() const noexcept { return pos_; }
+    [[nodiscard]] bool overflowed() const noexcept { return overflow_; }
+
+private:
+    std::span<std::byte> out_;
+    size_t pos_{0};
+    bool overflow_{false};
+};
+
+//NOTE: bounds checked reader, every read past the end fails with file_eof
+class byte_reader {
+public:
+    explicit byte_reader(std::span<const std::byte> in) noexcept
+    : in_(in) {}
+
+    [[nodiscard]] cc::result<void> read_bytes(std::span<std::byte> out) noexcept {
+        if (out.size() > remaining()) {
+            return cc::err(cc::error_code::file_eof, "Serialized data truncated");
+        }
+        if (!out.empty()) {
+            std::memcpy(out.data(), in_.data() + pos_, out.size());
+        }
+        pos_ += out.size();
+        return cc::ok();
+    }
+
+    template<trivially_copyable T>
+    [[nodiscard]] cc::result<void> read(T& value) noexcept {
+        return read_bytes(std::as_writable_bytes(std::span<T>(&value, 1)));
+    }
+
+    template<trivially_copyable T>
+    [[nodiscard]] cc::result<void> read_array(std::span<T> values) noexcept {
+        return read_bytes(std::as_writable_bytes(values));
+    }
+
+    //NOTE: reads a u64 element count and rejects counts the remaining bytes cannot hold
+    [[nodiscard]] cc::result<size_t> read_length(size_t min_element_size) noexcept {
+        u64 count = 0;
+        if (auto res = read(count); !res) {
+            return cc::err(res.error());
+        }
+        if (min_element_size > 0 && count > remaining() / min_element_size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Serialized length exceeds data");
+        }
+        if (count > std::numeric_limits<size_t>::max()) {
+            return cc::err(cc::error_code::parse_invalid_format, "Serialized length overflow");
+        }
+        return static_cast<size_t>(count);
+    }
+
+    [[nodiscard]] size_t remaining() const noexcept { return in_.size() - pos_; }
+    [[nodiscard]] size_t position() const noexcept { return pos_; }
+
+private:
+    std::span<const std::byte> in_;
+    size_t pos_{0};
+};
+
+namespace detail {
+
+template<typename T>
+struct is_std_vector : std::false_type {};
+
+template<typename T, typename A>
+struct is_std_vector<std::vector<T, A>> : std::true_type {};
+
+template<typename T>
+struct is_std_array : std::false_type {};
+
+template<typename T, size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
+
+//NOTE: converts to any member type, used to count aggregate fields by brace initialization
+struct any_field {
+    template<typename U>
+    constexpr operator U&() const noexcept;
+};
+
+//NOTE: stops one past the supported 8 fields, so a larger aggregate is reported instead of being
+// taken for one with 8
+template<typename T, typename... Fields>
+consteval size_t field_count() noexcept {
+    if constexpr (sizeof...(Fields) < 9 && requires { T{Fields{}..., any_field{}}; }) {
+        return field_count<T, Fields..., any_field>();
+    } else {
+        return sizeof...(Fields);
+    }
+}
+
+//NOTE: structured bindings stand in for reflection, aggregates of up to 8 fields are supported
+template<typename T, typename F>
+constexpr decltype(auto) visit_fields(T& value, F&& f) {
+    constexpr size_t n = field_count<std::remove_const_t<T>>();
+    static_assert(n >= 1 && n <= 8, "Aggregate needs 1 to 8 fields or a cc::codec specialization");
+
+    if constexpr (n == 1) {
+        auto& [a] = value;
+        return f(a);
+    } else if constexpr (n == 2) {
+        auto& [a, b] = value;
+        return f(a, b);
+    } else if constexpr (n == 3) {
+        auto& [a, b, c] = value;
+        return f(a, b, c);
+    } else if constexpr (n == 4) {
+        auto& [a, b, c, d] = value;
+        return f(a, b, c, d);
+    } else if constexpr (n == 5) {
+        auto& [a, b, c, d, e] = value;
+        return f(a, b, c, d, e);
+    } else if constexpr (n == 6) {
+        auto& [a, b, c, d, e, g] = value;
+        return f(a, b, c, d, e, g);
+    } else if constexpr (n == 7) {
+        auto& [a, b, c, d, e, g, h] = value;
+        return f(a, b, c, d, e, g, h);
+    } else {
+        auto& [a, b, c, d, e, g, h, i] = value;
+        return f(a, b, c, d, e, g, h, i);
+    }
+}
+
+template<typename T>
+concept has_serialize_member = requires(const T t) {
+    { t.serialize() } -> std::same_as<std::vector<std::byte>>;
+};
+
+//NOTE: serialized_size() keeps size() from serializing the value just to measure it
+template<typename T>
+concept member_serializable = has_serialize_member<T> && requires(const T t, std::span<const std::byte> data) {
+    { t.serialized_size() } -> std::convertible_to<size_t>;
+    { T::deserialize(data) } -> std::same_as<result<T>>;
+};
+
+template<typename T>
+inline constexpr bool padding_free = std::has_unique_object_representations_v<T> || std::is_floating_point_v<T> ||
+                                     enable_bulk_copy<std::remove_cv_t<T>>;
+
+template<typename T, size_t N>
+inline constexpr bool padding_free<std::array<T, N>> = padding_free<T>;
+
+template<typename T, size_t N>
+inline constexpr bool padding_free<T[N]> = padding_free<T>;
+
+template<typename T>
+concept bulk_copyable = trivially_copyable<T> && padding_free<T> && !std::is_pointer_v<T> &&
+                        !std::is_member_pointer_v<T> && !has_serialize_member<T>;
+
+} // namespace detail
+
+//NOTE: serialization customization point. The primary template handles, in order: types with
+// serialize()/serialized_size()/deserialize() members, padding free trivially copyable values
+// (scalars, vec and mat once opted in through enable_bulk_copy) as one bulk copy, std::string,
+// std::vector and std::array (bulk copyable elements as one run), and aggregates field by field.
+// Specialize codec<T> for anything else. Lengths are u64, data is stored in native byte order
+template<typename T>
+struct codec {
+    static_assert(detail::member_serializable<T> || !detail::has_serialize_member<T>,
+                  "serialize() members need serialized_size() and deserialize() next to them");
+
+    [[nodiscard]] static constexpr size_t size(const T& value);
+    static void write(byte_writer& out, const T& value);
+    [[nodiscard]] static cc::result<void> read(byte_reader& in, T& value);
+};
+
+template<typename T>
+[[nodiscard]] constexpr size_t serialized_size(const T& value) {
+    return codec<T>::size(value);
+}
+
+template<typename T>
+constexpr size_t codec<T>::size(const T& value) {
+    if constexpr (detail::member_serializable<T>) {
+        return sizeof(u64) + value.serialized_size();
+    } else if constexpr (detail::bulk_copyable<T>) {
+        return sizeof(T);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return sizeof(u64) + value.size();
+    } else if constexpr (detail::is_std_vector<T>::value || detail::is_std_array<T>::value) {
+        using element = typename T::value_type;
+        size_t size = detail::is_std_vector<T>::value ? sizeof(u64) : 0;
+        if constexpr (detail::bulk_copyable<element>) {
+            return size + value.size() * sizeof(element);
+        } else {
+            for (const auto& item : value) {
+                size += serialized_size(item);
+            }
+            return size;
+        }
+    } else {
+        static_assert(std::is_aggregate_v<T>, "Type needs a cc::codec specialization");
+        return detail::visit_fields(value, [](const auto&... fields) {
+            return (size_t{0} + ... + serialized_size(fields));
+        });
+    }
+}
+
+template<typename T>
+void codec<T>::write(byte_writer& out, const T& value) {
+    if constexpr (detail::member_serializable<T>) {
+        auto bytes = value.serialize();
+        out.write(static_cast<u64>(bytes.size()));
+        out.write_bytes(bytes);
+    } else if constexpr (detail::bulk_copyable<T>) {
+        out.write(value);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        out.write(static_cast<u64>(value.size()));
+        out.write_array(std::span<const char>(value));
+    } else if constexpr (detail::is_std_vector<T>::value || detail::is_std_array<T>::value) {
+        using element = typename T::value_type;
+        if constexpr (detail::is_std_vector<T>::value) {
+            out.write(static_cast<u64>(value.size()));
+        }
+        if constexpr (detail::bulk_copyable<element>) {
+            out.write_array(std::span<const element>(value));
+        } else {
+            for (const auto& item : value) {
+                codec<element>::write(out, item);
+            }
+        }
+    } else {
+        detail::visit_fields(value, [&](const auto&... fields) {
+            (codec<std::remove_cvref_t<decltype(fields)>>::write(out, fields), ...);
+        });
+    }
+}
+
+template<typename T>
+cc::result<void> codec<T>::read(byte_reader& in, T& value) {
+    if constexpr (detail::member_serializable<T>) {
+        auto size = in.read_length(1);
+        if (!size) {
+            return cc::err(size.error());
+        }
+        std::vector<std::byte> bytes(*size);
+        if (auto res = in.read_bytes(bytes); !res) {
+            return res;
+        }
+        auto parsed = T::deserialize(bytes);
+        if (!parsed) {
+            return cc::err(parsed.error());
+        }
+        value = std::move(*parsed);
+        return cc::ok();
+    } else if constexpr (detail::bulk_copyable<T>) {
+        return in.read(value);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        auto size = in.read_length(1);
+        if (!size) {
+            return cc::err(size.error());
+        }
+        value.resize(*size);
+        return in.read_array(std::span<char>(value));
+    } else if constexpr (detail::is_std_vector<T>::value || detail::is_std_array<T>::value) {
+        using element = typename T::value_type;
+        if constexpr (detail::is_std_vector<T>::value) {
+            auto count = in.read_length(detail::bulk_copyable<element> ? sizeof(element) : 1);
+            if (!count) {
+                return cc::err(count.error());
+            }
+            value.resize(*count);
+        }
+        if constexpr (detail::bulk_copyable<element>) {
+            return in.read_array(std::span<element>(value));
+        } else {
+            for (auto& item : value) {
+                if (auto res = codec<element>::read(in, item); !res) {
+                    return res;
+                }
+            }
+            return cc::ok();
+        }
+    } else {
+        return detail::visit_fields(value, [&](auto&... fields) -> cc::result<void> {
+            cc::result<void> res;
+            ((res = codec<std::remove_cvref_t<decltype(fields)>>::read(in, fields)) && ...);
+            return res;
+        });
+    }
+}
+
+//NOTE: writes into caller owned memory, e.g. an arena block, and returns the bytes used
+template<typename T>
+[[nodiscard]] cc::result<size_t> serialize_into(const T& value, std::span<std::byte> out) {
+    size_t size = serialized_size(value);
+    if (size > out.size()) {
+        return cc::err(cc::error_code::validation_out_of_range, "Serialization buffer too small");
+    }
+
+    byte_writer writer(out.first(size));
+    codec<T>::write(writer, value);
+    return writer.written();
+}
+
+//NOTE: sizes the output first so the whole value costs one allocation (member serialize()
+// implementations aside)
+template<typename T>
+[[nodiscard]] std::vector<std::byte> serialize(const T& value) {
+    std::vector<std::byte> out(serialized_size(value));
+    byte_writer writer(out);
+    codec<T>::write(writer, value);
+    return out;
+}
+
+template<typename T>
+[[nodiscard]] cc::result<T> deserialize(std::span<const std::byte> data) {
+    byte_reader reader(data);
+    T value{};
+    if (auto res = codec<T>::read(reader, value); !res) {
+        return cc::err(res.error());
+    }
+    if (reader.remaining() != 0) {
+        return cc::err(cc::error_code::parse_invalid_format, "Trailing bytes after serialized value");
+    }
+    return value;
+}
+
+} // namespace cc
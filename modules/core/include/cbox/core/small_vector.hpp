@@ -0,0 +1,301 @@
+#pragma once
+#include "types.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cc {
+
+//NOTE: vector that keeps up to N elements in place and moves to the heap past that. Same
+// invalidation rules as std::vector, moving a small_vector also moves inline elements
+template <typename T, size_t N>
+class small_vector {
+    static_assert(N > 0, "small_vector needs at least one inline element, use std::vector otherwise");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t inline_capacity = N;
+
+    small_vector() noexcept = default;
+
+    explicit small_vector(size_t count) { resize(count); }
+
+    small_vector(size_t count, const T& value) { assign(count, value); }
+
+    small_vector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    template <std::input_iterator It>
+    small_vector(It first, It last) { assign(first, last); }
+
+    small_vector(const small_vector& other) { assign(other.begin(), other.end()); }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(std::move(other));
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    ~small_vector() {
+        clear();
+        release();
+    }
+
+    void assign(size_t count, const T& value) {
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(data_, count, value);
+        size_ = count;
+    }
+
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::forward_iterator<It>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    [[nodiscard]] T& operator[](size_t i) noexcept {
+        assert(i < size_);
+        return data_[i];
+    }
+
+    [[nodiscard]] const T& operator[](size_t i) const noexcept {
+        assert(i < size_);
+        return data_[i];
+    }
+
+    [[nodiscard]] T& front() noexcept { return data_[0]; }
+    [[nodiscard]] const T& front() const noexcept { return data_[0]; }
+    [[nodiscard]] T& back() noexcept { return data_[size_ - 1]; }
+    [[nodiscard]] const T& back() const noexcept { return data_[size_ - 1]; }
+
+    [[nodiscard]] T* data() noexcept { return data_; }
+    [[nodiscard]] const T* data() const noexcept { return data_; }
+
+    [[nodiscard]] iterator begin() noexcept { return data_; }
+    [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+    [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return data_; }
+    [[nodiscard]] const_iterator cend() const noexcept { return data_ + size_; }
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    //NOTE: true while the elements live in the inline buffer
+    [[nodiscard]] bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    void reserve(size_t count) {
+        if (count > capacity_) {
+            reallocate(count);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (!is_inline() && size_ < capacity_) {
+            reallocate(std::max(size_, N));
+        }
+    }
+
+    void clear() noexcept {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            //NOTE: construct first, `args` may alias an element of this vector
+            size_t count = grow_size(size_ + 1);
+            T* fresh = allocate(count);
+            T* slot;
+            try {
+                slot = std::construct_at(fresh + size_, std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(fresh);
+                throw;
+            }
+            relocate(fresh, count);
+            ++size_;
+            return *slot;
+        }
+        T* slot = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(data_ + --size_);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t index = static_cast<size_t>(pos - data_);
+        if (index == size_) {
+            emplace_back(std::forward<Args>(args)...);
+            return data_ + index;
+        }
+
+        T value(std::forward<Args>(args)...);
+        emplace_back(std::move(data_[size_ - 1]));
+        std::move_backward(data_ + index, data_ + size_ - 2, data_ + size_ - 1);
+        data_[index] = std::move(value);
+        return data_ + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        T* begin = data_ + (first - data_);
+        T* end = data_ + (last - data_);
+        if (begin != end) {
+            T* tail = std::move(end, data_ + size_, begin);
+            std::destroy(tail, data_ + size_);
+            size_ -= static_cast<size_t>(end - begin);
+        }
+        return begin;
+    }
+
+    void resize(size_t count) {
+        if (count < size_) {
+            std::destroy(data_ + count, data_ + size_);
+        } else if (count > size_) {
+            reserve(count);
+            std::uninitialized_value_construct(data_ + size_, data_ + count);
+        }
+        size_ = count;
+    }
+
+    void resize(size_t count, const T& value) {
+        if (count < size_) {
+            std::destroy(data_ + count, data_ + size_);
+        } else if (count > size_) {
+            reserve(count);
+            std::uninitialized_fill(data_ + size_, data_ + count, value);
+        }
+        size_ = count;
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend auto operator<=>(const small_vector& a, const small_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    [[nodiscard]] T* inline_data() noexcept { return reinterpret_cast<T*>(storage_); }
+    [[nodiscard]] const T* inline_data() const noexcept { return reinterpret_cast<const T*>(storage_); }
+
+    [[nodiscard]] size_t grow_size(size_t required) const noexcept {
+        return std::max(required, capacity_ * 2);
+    }
+
+    [[nodiscard]] static T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    static void deallocate(T* p) noexcept {
+        ::operator delete(p, std::align_val_t{alignof(T)});
+    }
+
+    //NOTE: moves the live elements into `fresh`, which already has room for `count`
+    void relocate(T* fresh, size_t count) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move(data_, data_ + size_, fresh);
+        std::destroy_n(data_, size_);
+        release();
+        data_ = fresh;
+        capacity_ = count;
+    }
+
+    void reallocate(size_t count) {
+        T* fresh = count <= N ? inline_data() : allocate(count);
+        if (fresh == data_) {
+            return;
+        }
+        relocate(fresh, count <= N ? N : count);
+    }
+
+    void release() noexcept {
+        if (!is_inline()) {
+            deallocate(data_);
+        }
+        data_ = inline_data();
+        capacity_ = N;
+    }
+
+    void take(small_vector&& other) {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.data_, other.data_ + other.size_, data_);
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_data();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+
+    T* data_{inline_data()};
+    size_t size_{0};
+    size_t capacity_{N};
+    alignas(T) std::byte storage_[N * sizeof(T)];
+};
+
+} // namespace cc
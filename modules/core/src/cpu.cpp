@@ -0,0 +1,226 @@
+#include <cbox/core/cpu.hpp>
+#include <cbox/core/logger.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if CBOX_CPU_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace cc::cpu {
+
+namespace {
+
+#if CBOX_CPU_X86
+std::array<u32, 4> cpuid(u32 leaf, u32 subleaf = 0) noexcept {
+    std::array<u32, 4> regs{};
+#if defined(_MSC_VER)
+    i32 out[4];
+    __cpuidex(out, static_cast<i32>(leaf), static_cast<i32>(subleaf));
+    std::memcpy(regs.data(), out, sizeof(out));
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    return regs;
+}
+
+//NOTE: only valid once cpuid reports OSXSAVE
+u64 xgetbv0() noexcept {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    u32 lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<u64>(hi) << 32) | lo;
+#endif
+}
+
+bool bit(u32 reg, u32 index) noexcept { return ((reg >> index) & 1u) != 0; }
+#endif
+
+features probe() noexcept {
+    features f;
+#if CBOX_CPU_X86
+    auto leaf0 = cpuid(0);
+    u32 max_leaf = leaf0[0];
+    char vendor[12];
+    std::memcpy(vendor + 0, &leaf0[1], 4);
+    std::memcpy(vendor + 4, &leaf0[3], 4);
+    std::memcpy(vendor + 8, &leaf0[2], 4);
+    f.vendor.assign(vendor, sizeof(vendor));
+
+    if (max_leaf >= 1) {
+        auto [eax, ebx, ecx, edx] = cpuid(1);
+        f.sse2 = bit(edx, 26);
+        f.sse3 = bit(ecx, 0);
+        f.ssse3 = bit(ecx, 9);
+        f.fma = bit(ecx, 12);
+        f.sse41 = bit(ecx, 19);
+        f.sse42 = bit(ecx, 20);
+        f.popcnt = bit(ecx, 23);
+        f.avx = bit(ecx, 28);
+        f.f16c = bit(ecx, 29);
+
+        //NOTE: the CPU having AVX is not enough, the OS must save ymm/zmm state (XCR0)
+        if (bit(ecx, 27)) {
+            u64 xcr0 = xgetbv0();
+            f.os_ymm = (xcr0 & 0x6) == 0x6;
+            f.os_zmm = f.os_ymm && (xcr0 & 0xe0) == 0xe0;
+        }
+    }
+
+    if (max_leaf >= 7) {
+        auto [eax, ebx, ecx, edx] = cpuid(7);
+        f.bmi1 = bit(ebx, 3);
+        f.avx2 = bit(ebx, 5);
+        f.bmi2 = bit(ebx, 8);
+        f.avx512f = bit(ebx, 16);
+        f.avx512dq = bit(ebx, 17);
+        f.avx512cd = bit(ebx, 28);
+        f.avx512bw = bit(ebx, 30);
+        f.avx512vl = bit(ebx, 31);
+    }
+
+    if (cpuid(0x80000000)[0] >= 0x80000004) {
+        char brand[48];
+        for (u32 i = 0; i < 3; ++i) {
+            auto regs = cpuid(0x80000002 + i);
+            std::memcpy(brand + i * 16, regs.data(), 16);
+        }
+        std::string_view text(brand, strnlen(brand, sizeof(brand)));
+        auto first = text.find_first_not_of(' ');
+        auto last = text.find_last_not_of(' ');
+        if (first != std::string_view::npos) {
+            f.brand.assign(text.substr(first, last - first + 1));
+        }
+    }
+#endif
+    return f;
+}
+
+isa highest_level(const features& f) noexcept {
+    if (!f.sse2) {
+        return isa::scalar;
+    }
+    if (!(f.sse3 && f.ssse3 && f.sse41 && f.sse42 && f.popcnt)) {
+        return isa::sse2;
+    }
+    if (!(f.os_ymm && f.avx && f.avx2 && f.fma && f.bmi1 && f.bmi2 && f.f16c)) {
+        return isa::sse42;
+    }
+    if (!(f.os_zmm && f.avx512f && f.avx512bw && f.avx512dq && f.avx512vl && f.avx512cd)) {
+        return isa::avx2;
+    }
+    return isa::avx512;
+}
+
+struct state {
+    features info;
+    isa best;
+    std::atomic<isa> active;
+
+    std::mutex mutex;
+    std::vector<detail::dispatch_node*> nodes;
+
+    state() : info(probe()), best(highest_level(info)), active(best) {
+        if (const char* env = std::getenv("CBOX_FORCE_ISA"); env != nullptr && *env != '\0') {
+            auto level = parse_isa(env);
+            if (!level) {
+                log::Warn("CBOX_FORCE_ISA={} is not an ISA level, using {}", env, to_string(best));
+            } else if (*level > best) {
+                log::Warn("CBOX_FORCE_ISA={} is not supported on this machine, using {}", env, to_string(best));
+            } else {
+                active.store(*level, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+state& global() noexcept {
+    static state g_state;
+    return g_state;
+}
+
+void apply(state& s, isa level) {
+    std::lock_guard lock(s.mutex);
+    s.active.store(level, std::memory_order_relaxed);
+    for (auto* node : s.nodes) {
+        node->resolve(level);
+    }
+}
+
+} // namespace
+
+const features& info() noexcept {
+    return global().info;
+}
+
+isa best() noexcept {
+    return global().best;
+}
+
+isa active() noexcept {
+    return global().active.load(std::memory_order_relaxed);
+}
+
+result<void> force(isa level) {
+    auto& s = global();
+    if (level > s.best) {
+        return err(error_code::validation_out_of_range,
+                   fmt::format("cpu does not support {}, best is {}", to_string(level), to_string(s.best)));
+    }
+    apply(s, level);
+    return {};
+}
+
+void clear_force() {
+    auto& s = global();
+    apply(s, s.best);
+}
+
+std::string_view to_string(isa level) noexcept {
+    switch (level) {
+        case isa::scalar: return "scalar";
+        case isa::sse2: return "sse2";
+        case isa::sse42: return "sse42";
+        case isa::avx2: return "avx2";
+        case isa::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+std::optional<isa> parse_isa(std::string_view text) noexcept {
+    for (isa level : {isa::scalar, isa::sse2, isa::sse42, isa::avx2, isa::avx512}) {
+        if (text == to_string(level)) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+namespace detail {
+
+void register_dispatch(dispatch_node* node) {
+    auto& s = global();
+    std::lock_guard lock(s.mutex);
+    node->resolve(s.active.load(std::memory_order_relaxed));
+    s.nodes.push_back(node);
+}
+
+void unregister_dispatch(dispatch_node* node) noexcept {
+    auto& s = global();
+    std::lock_guard lock(s.mutex);
+    std::erase(s.nodes, node);
+}
+
+} // namespace detail
+
+} // namespace cc::cpu
@@ -1,9 +1,30 @@
 #include <cbox/core/error.hpp>
 #include <cbox/core/logger.hpp>
 #include <format>
+#include <new>
 
 namespace cc {
 
+void error::store(std::string_view msg) noexcept {
+    if (msg.size() <= inline_capacity) {
+        storage_ = storage::inline_buffer;
+        size_ = static_cast<u32>(msg.size());
+        std::char_traits<char>::copy(inline_, msg.data(), msg.size());
+        return;
+    }
+
+    //NOTE: a failed allocation keeps the head of the message instead of throwing
+    char* data = new (std::nothrow) char[msg.size()];
+    if (data == nullptr) {
+        store(msg.substr(0, inline_capacity));
+        return;
+    }
+    std::char_traits<char>::copy(data, msg.data(), msg.size());
+    storage_ = storage::heap;
+    external_ = data;
+    size_ = static_cast<u32>(msg.size());
+}
+
 const char* error::code_string() const noexcept {
     switch (code_) {
         case error_code::success: return "Success";
@@ -53,7 +74,7 @@ std::string error::format() const {
                        location_.function_name(),
                        category_string(),
                        code_string(),
-                       message_);
+                       message());
 }
 
 void error::log() const {
@@ -0,0 +1,153 @@
+#include <cbox/core/jobs.hpp>
+
+namespace cc {
+
+namespace {
+
+//NOTE: set on worker threads so spawns from inside a task go to the worker's own deque
+thread_local job_system* t_system = nullptr;
+thread_local size_t t_index = 0;
+
+u64 next_random(u64& state) noexcept {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+job_system::job_system(size_t threads) {
+    if (threads == 0) {
+        size_t hardware = std::thread::hardware_concurrency();
+        threads = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<worker>(0x9e3779b97f4a7c15ull * (i + 1)));
+    }
+
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i](std::stop_token stop) { worker_loop(i, stop); });
+    }
+}
+
+job_system::~job_system() {
+    stopping_.store(true, std::memory_order_seq_cst);
+    for (auto& thread : threads_) {
+        thread.request_stop();
+    }
+    {
+        std::lock_guard lock(sleep_mutex_);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    sleep_cv_.notify_all();
+    threads_.clear();
+
+    //NOTE: tasks still queued when the pool goes away are dropped without running
+    for (auto& w : workers_) {
+        while (auto t = w->deque.pop()) {
+            delete *t;
+        }
+    }
+    for (task* t : inject_) {
+        delete t;
+    }
+}
+
+job_system& job_system::global() {
+    static job_system system;
+    return system;
+}
+
+void job_system::submit(task* t) {
+    if (t_system == this) {
+        workers_[t_index]->deque.push(t);
+    } else {
+        std::lock_guard lock(inject_mutex_);
+        inject_.push_back(t);
+        inject_size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake_one();
+}
+
+void job_system::wake_one() {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard lock(sleep_mutex_);
+        sleep_cv_.notify_one();
+    }
+}
+
+job_system::task* job_system::find_task(worker* self) {
+    if (self != nullptr) {
+        if (auto t = self->deque.pop()) {
+            return *t;
+        }
+    }
+
+    if (inject_size_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard lock(inject_mutex_);
+        if (!inject_.empty()) {
+            task* t = inject_.front();
+            inject_.pop_front();
+            inject_size_.fetch_sub(1, std::memory_order_relaxed);
+            return t;
+        }
+    }
+
+    //NOTE: one sweep over all deques from a random start
+    size_t count = workers_.size();
+    u64 seed = self != nullptr ? next_random(self->seed) : std::hash<std::thread::id>{}(std::this_thread::get_id());
+    size_t start = static_cast<size_t>(seed % count);
+    for (size_t i = 0; i < count; ++i) {
+        worker* victim = workers_[(start + i) % count].get();
+        if (victim == self) {
+            continue;
+        }
+        if (auto t = victim->deque.steal()) {
+            return *t;
+        }
+    }
+    return nullptr;
+}
+
+bool job_system::run_one() {
+    worker* self = t_system == this ? workers_[t_index].get() : nullptr;
+    task* t = find_task(self);
+    if (t == nullptr) {
+        return false;
+    }
+    (*t)();
+    delete t;
+    return true;
+}
+
+void job_system::worker_loop(size_t index, std::stop_token stop) {
+    t_system = this;
+    t_index = index;
+    worker* self = workers_[index].get();
+
+    while (!stop.stop_requested()) {
+        u64 epoch = epoch_.load(std::memory_order_seq_cst);
+        if (task* t = find_task(self)) {
+            (*t)();
+            delete t;
+            continue;
+        }
+
+        //NOTE: sleep until a submit bumps the epoch observed before the last search
+        std::unique_lock lock(sleep_mutex_);
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [&] {
+            return stopping_.load(std::memory_order_relaxed) || epoch_.load(std::memory_order_seq_cst) != epoch;
+        });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    t_system = nullptr;
+}
+
+} // namespace cc
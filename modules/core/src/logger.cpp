@@ -0,0 +1,277 @@
+#include <cbox/core/logger.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cc::log {
+
+namespace {
+
+//NOTE: records are 8 byte aligned: header, format string, payload. A header with
+// fmt_size == skip_marker pads the end of the ring when a record would not fit before the wrap
+struct RecordHeader {
+    uint32_t size;
+    uint32_t fmt_size;
+    Level level;
+    detail::FormatFn format;
+    spdlog::log_clock::time_point time;
+};
+
+constexpr uint32_t skip_marker = ~uint32_t{0};
+constexpr size_t record_align = 8;
+constexpr size_t min_ring_bytes = 4096;
+
+constexpr size_t AlignRecord(size_t size) noexcept {
+    return (size + record_align - 1) & ~(record_align - 1);
+}
+
+//NOTE: single producer (the owning thread), single consumer (the backend thread). Positions
+// grow monotonically and are masked into the buffer
+struct Ring {
+    explicit Ring(size_t capacity) : data(capacity), mask(capacity - 1) {}
+
+    std::vector<std::byte> data;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t pending = 0;
+    size_t pending_size = 0;
+    size_t pending_fmt_size = 0;
+
+    std::atomic<bool> retired{false};
+};
+
+//NOTE: `signal` is bumped whenever a ring goes from empty to non-empty, the consumer sleeps on it
+// once a pass over all rings found nothing
+struct Backend {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::atomic<uint64_t> generation{0};
+    size_t ring_bytes = 0;
+    std::jthread consumer;
+    std::atomic<uint64_t> dropped{0};
+    alignas(64) std::atomic<uint32_t> signal{0};
+};
+
+void Wake(Backend& backend) noexcept {
+    backend.signal.fetch_add(1, std::memory_order_release);
+    backend.signal.notify_one();
+}
+
+Backend& GetBackend() {
+    static Backend backend;
+    return backend;
+}
+
+//NOTE: a thread keeps its ring while the backend generation matches, the ring is retired on thread
+// exit and released by the consumer once drained
+struct ThreadRing {
+    std::shared_ptr<Ring> ring;
+    uint64_t generation = 0;
+
+    ~ThreadRing() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+Ring& CurrentRing() {
+    auto& backend = GetBackend();
+    if (t_ring.ring && t_ring.generation == backend.generation.load(std::memory_order_acquire)) {
+        return *t_ring.ring;
+    }
+
+    std::lock_guard lock(backend.mutex);
+    if (t_ring.ring) {
+        t_ring.ring->retired.store(true, std::memory_order_release);
+    }
+    t_ring.ring = std::make_shared<Ring>(backend.ring_bytes);
+    t_ring.generation = backend.generation.load(std::memory_order_relaxed);
+    backend.rings.push_back(t_ring.ring);
+    return *t_ring.ring;
+}
+
+bool Drain(Ring& ring, spdlog::logger& logger, fmt::memory_buffer& text) {
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    size_t tail = ring.tail.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    while (head != tail) {
+        const std::byte* record = ring.data.data() + (head & ring.mask);
+        uint32_t prefix[2];
+        std::memcpy(prefix, record, sizeof(prefix));
+        if (prefix[1] == skip_marker) {
+            head += prefix[0];
+            continue;
+        }
+        RecordHeader header;
+        std::memcpy(&header, record, sizeof(header));
+
+        std::string_view fmt(reinterpret_cast<const char*>(record + sizeof(header)), header.fmt_size);
+        text.clear();
+        try {
+            header.format(record + sizeof(header) + header.fmt_size, text, fmt);
+        } catch (const fmt::format_error& e) {
+            text.clear();
+            fmt::format_to(fmt::appender(text), "[log format error: {}] {}", e.what(), fmt);
+        }
+        logger.log(header.time, spdlog::source_loc{}, detail::ToSpdlogLevel(header.level),
+                   spdlog::string_view_t(text.data(), text.size()));
+        head += header.size;
+    }
+
+    ring.head.store(head, std::memory_order_release);
+    return true;
+}
+
+void Consume(std::stop_token stop) {
+    auto& backend = GetBackend();
+    std::vector<std::shared_ptr<Ring>> rings;
+    fmt::memory_buffer text;
+
+    auto drain_all = [&]() {
+        {
+            std::lock_guard lock(backend.mutex);
+            //NOTE: drop retired rings that were drained on the previous pass
+            std::erase_if(backend.rings, [](const std::shared_ptr<Ring>& ring) {
+                return ring->retired.load(std::memory_order_acquire) &&
+                       ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+            });
+            rings = backend.rings;
+        }
+
+        bool any = false;
+        auto& logger = detail::GetLoggerInstance();
+        for (auto& ring : rings) {
+            any |= Drain(*ring, *logger, text);
+        }
+        return any;
+    };
+
+    while (!stop.stop_requested()) {
+        //NOTE: pairs with the fence in CommitRecord, either this pass sees the new tail or the
+        // producer sees the drained head and bumps the signal past `seen`
+        uint32_t seen = backend.signal.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!drain_all()) {
+            backend.signal.wait(seen, std::memory_order_acquire);
+        }
+    }
+    drain_all();
+    detail::GetLoggerInstance()->flush();
+}
+
+} // namespace
+
+namespace detail {
+
+std::byte* BeginRecord(std::string_view fmt, size_t payload_size) noexcept {
+    Ring* ring;
+    try {
+        ring = &CurrentRing();
+    } catch (...) {
+        GetBackend().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    size_t capacity = ring->data.size();
+    size_t size = AlignRecord(sizeof(RecordHeader) + fmt.size() + payload_size);
+    if (size > capacity / 2) {
+        GetBackend().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+    size_t head = ring->head.load(std::memory_order_acquire);
+    size_t contiguous = capacity - (tail & ring->mask);
+    size_t needed = size <= contiguous ? size : contiguous + size;
+    if (needed > capacity - (tail - head)) {
+        GetBackend().dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if (size > contiguous) {
+        //NOTE: the consumer only reads the skip marker once the record after it is committed
+        uint32_t marker[2] = {static_cast<uint32_t>(contiguous), skip_marker};
+        std::memcpy(ring->data.data() + (tail & ring->mask), marker, sizeof(marker));
+        tail += contiguous;
+    }
+
+    ring->pending = tail;
+    ring->pending_size = size;
+    ring->pending_fmt_size = fmt.size();
+    std::byte* record = ring->data.data() + (tail & ring->mask);
+    std::memcpy(record + sizeof(RecordHeader), fmt.data(), fmt.size());
+    return record + sizeof(RecordHeader) + fmt.size();
+}
+
+void CommitRecord(Level level, FormatFn format) noexcept {
+    Ring& ring = *t_ring.ring;
+    RecordHeader header{static_cast<uint32_t>(ring.pending_size), static_cast<uint32_t>(ring.pending_fmt_size),
+                        level, format, spdlog::log_clock::now()};
+    std::memcpy(ring.data.data() + (ring.pending & ring.mask), &header, sizeof(header));
+
+    size_t previous = ring.tail.load(std::memory_order_relaxed);
+    ring.tail.store(ring.pending + ring.pending_size, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.head.load(std::memory_order_relaxed) == previous) {
+        Wake(GetBackend());
+    }
+}
+
+} // namespace detail
+
+void InitAsync(const std::string_view& name, size_t ring_bytes) {
+    auto& backend = GetBackend();
+    if (detail::AsyncEnabled().load(std::memory_order_acquire)) {
+        return;
+    }
+    if (!detail::GetLoggerInstance()) {
+        Init(name);
+    }
+
+    {
+        std::lock_guard lock(backend.mutex);
+        backend.ring_bytes = std::bit_ceil(std::max(ring_bytes, min_ring_bytes));
+        backend.generation.fetch_add(1, std::memory_order_acq_rel);
+        backend.rings.clear();
+        backend.dropped.store(0, std::memory_order_relaxed);
+    }
+    backend.consumer = std::jthread(Consume);
+    detail::AsyncEnabled().store(true, std::memory_order_release);
+
+    //NOTE: registered after the backend and the logger were constructed, so it runs before their
+    // destructors and the consumer never outlives them
+    static const bool registered = std::atexit(Shutdown) == 0;
+    (void)registered;
+}
+
+void Shutdown() {
+    auto& backend = GetBackend();
+    if (!detail::AsyncEnabled().exchange(false, std::memory_order_seq_cst)) {
+        return;
+    }
+
+    //NOTE: writers that saw async logging enabled finish their record before the final drain
+    while (detail::AsyncWriters().load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+    backend.consumer.request_stop();
+    Wake(backend);
+    backend.consumer.join();
+}
+
+uint64_t DroppedCount() noexcept {
+    return GetBackend().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace cc::log
@@ -0,0 +1,75 @@
+#include <cbox/core/memory.hpp>
+#include <algorithm>
+
+namespace cc {
+
+void arena::enter(block* b) noexcept {
+    current_ = b;
+    cursor_ = b->begin();
+    end_ = b->end();
+}
+
+void* arena::grow(size_t bytes, size_t alignment) {
+    //NOTE: after a reset the following blocks are still owned, reuse the first one that fits
+    block* b = current_ != nullptr ? current_->next : nullptr;
+    while (b != nullptr) {
+        enter(b);
+        void* p = cursor_;
+        size_t space = b->size;
+        if (std::align(alignment, bytes, p, space)) {
+            cursor_ = static_cast<std::byte*>(p) + bytes;
+            used_ += bytes;
+            return p;
+        }
+        b = b->next;
+    }
+
+    size_t size = std::max(next_size_, bytes + alignment);
+    auto* fresh = static_cast<block*>(upstream_->allocate(sizeof(block) + size, alignof(std::max_align_t)));
+    fresh->next = nullptr;
+    fresh->size = size;
+    capacity_ += size;
+    next_size_ = std::min(next_size_ * 2, std::max(max_block_size, block_size_));
+
+    //NOTE: keep the list in allocation order so reset() walks the blocks front to back
+    if (head_ == nullptr) {
+        head_ = fresh;
+    } else {
+        block* last = current_;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = fresh;
+    }
+
+    enter(fresh);
+    void* p = cursor_;
+    size_t space = size;
+    std::align(alignment, bytes, p, space);
+    cursor_ = static_cast<std::byte*>(p) + bytes;
+    used_ += bytes;
+    return p;
+}
+
+void arena::reset() noexcept {
+    used_ = 0;
+    if (head_ != nullptr) {
+        enter(head_);
+    }
+}
+
+void arena::release() noexcept {
+    while (head_ != nullptr) {
+        block* next = head_->next;
+        upstream_->deallocate(head_, sizeof(block) + head_->size, alignof(std::max_align_t));
+        head_ = next;
+    }
+    current_ = nullptr;
+    cursor_ = nullptr;
+    end_ = nullptr;
+    next_size_ = block_size_;
+    used_ = 0;
+    capacity_ = 0;
+}
+
+} // namespace cc
@@ -0,0 +1,154 @@
+#include <cbox/core/metrics.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+
+namespace cc::metrics {
+
+namespace {
+
+constexpr f64 reported_quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+template <typename Metric>
+Metric& find_or_add(std::deque<Metric>& metrics, std::string_view name, std::string_view help) {
+    for (auto& m : metrics) {
+        if (m.name() == name) {
+            return m;
+        }
+    }
+    return metrics.emplace_back(std::string(name), std::string(help));
+}
+
+void append_escaped(fmt::memory_buffer& out, std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (c == '\n') {
+            out.append(std::string_view("\\n"));
+        } else {
+            out.push_back(c);
+        }
+    }
+}
+
+void append_help(fmt::memory_buffer& out, std::string_view name, std::string_view help, std::string_view type) {
+    if (!help.empty()) {
+        fmt::format_to(fmt::appender(out), "# HELP {} ", name);
+        append_escaped(out, help);
+        out.push_back('\n');
+    }
+    fmt::format_to(fmt::appender(out), "# TYPE {} {}\n", name, type);
+}
+
+} // namespace
+
+u64 histogram::percentile(f64 q) const noexcept {
+    u64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    u64 rank = static_cast<u64>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<f64>(total)));
+    rank = std::max<u64>(rank, 1);
+
+    u64 seen = 0;
+    for (size_t b = 0; b < bucket_count; ++b) {
+        seen += buckets_[b].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            //NOTE: report the highest value of the bucket, clamped to what was actually recorded
+            u64 high = b + 1 < bucket_count ? bucket_lower(b + 1) - 1 : ~u64{0};
+            return std::clamp(high, min(), max());
+        }
+    }
+    return max();
+}
+
+registry& registry::global() {
+    static registry r;
+    return r;
+}
+
+counter& registry::get_counter(std::string_view name, std::string_view help) {
+    std::lock_guard lock(mutex_);
+    return find_or_add(counters_, name, help);
+}
+
+gauge& registry::get_gauge(std::string_view name, std::string_view help) {
+    std::lock_guard lock(mutex_);
+    return find_or_add(gauges_, name, help);
+}
+
+histogram& registry::get_histogram(std::string_view name, std::string_view help) {
+    std::lock_guard lock(mutex_);
+    return find_or_add(histograms_, name, help);
+}
+
+std::string registry::to_json() const {
+    fmt::memory_buffer out;
+    std::lock_guard lock(mutex_);
+
+    out.append(std::string_view("{\"counters\":{"));
+    bool first = true;
+    for (const auto& c : counters_) {
+        out.append(std::string_view(first ? "\"" : ",\""));
+        append_escaped(out, c.name());
+        fmt::format_to(fmt::appender(out), "\":{}", c.value());
+        first = false;
+    }
+
+    out.append(std::string_view("},\"gauges\":{"));
+    first = true;
+    for (const auto& g : gauges_) {
+        out.append(std::string_view(first ? "\"" : ",\""));
+        append_escaped(out, g.name());
+        f64 value = g.value();
+        if (std::isfinite(value)) {
+            fmt::format_to(fmt::appender(out), "\":{}", value);
+        } else {
+            out.append(std::string_view("\":null"));
+        }
+        first = false;
+    }
+
+    out.append(std::string_view("},\"histograms\":{"));
+    first = true;
+    for (const auto& h : histograms_) {
+        out.append(std::string_view(first ? "\"" : ",\""));
+        append_escaped(out, h.name());
+        fmt::format_to(fmt::appender(out), "\":{{\"count\":{},\"sum\":{},\"min\":{},\"max\":{},\"p50\":{},\"p90\":{},\"p99\":{},\"p999\":{}}}",
+                       h.count(), h.sum(), h.min(), h.max(), h.percentile(0.5), h.percentile(0.9),
+                       h.percentile(0.99), h.percentile(0.999));
+        first = false;
+    }
+    out.append(std::string_view("}}\n"));
+
+    return fmt::to_string(out);
+}
+
+std::string registry::to_text() const {
+    fmt::memory_buffer out;
+    std::lock_guard lock(mutex_);
+
+    for (const auto& c : counters_) {
+        append_help(out, c.name(), c.help(), "counter");
+        fmt::format_to(fmt::appender(out), "{} {}\n", c.name(), c.value());
+    }
+
+    for (const auto& g : gauges_) {
+        append_help(out, g.name(), g.help(), "gauge");
+        fmt::format_to(fmt::appender(out), "{} {}\n", g.name(), g.value());
+    }
+
+    for (const auto& h : histograms_) {
+        append_help(out, h.name(), h.help(), "summary");
+        for (f64 q : reported_quantiles) {
+            fmt::format_to(fmt::appender(out), "{}{{quantile=\"{}\"}} {}\n", h.name(), q, h.percentile(q));
+        }
+        fmt::format_to(fmt::appender(out), "{}_sum {}\n{}_count {}\n", h.name(), h.sum(), h.name(), h.count());
+    }
+
+    return fmt::to_string(out);
+}
+
+} // namespace cc::metrics
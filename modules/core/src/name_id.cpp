@@ -0,0 +1,29 @@
+#include <cbox/core/name_id.hpp>
+#include <cbox/core/logger.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace cc::detail {
+
+#ifndef CBOX_NAME_ID_DEBUG
+#define CBOX_NAME_ID_DEBUG 0
+#endif
+
+bool name_tracking_default() noexcept {
+    return CBOX_NAME_ID_DEBUG != 0;
+}
+
+const char* remember_name(u64 hash, std::string_view text) {
+    static std::mutex g_mutex;
+    static std::unordered_map<u64, std::string> g_names;
+
+    std::lock_guard lock(g_mutex);
+    auto [it, inserted] = g_names.try_emplace(hash, text);
+    if (!inserted && it->second != text) {
+        log::Warn("name_id collision: '{}' and '{}' both hash to {:016x}", it->second, text, hash);
+    }
+    return it->second.c_str();
+}
+
+} // namespace cc::detail
@@ -0,0 +1,276 @@
+#include <cbox/core/profiler.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cc::profile {
+
+namespace {
+
+struct chunk {
+    static constexpr size_t capacity = 4096;
+
+    event events[capacity];
+    std::atomic<size_t> count{0};
+    std::atomic<chunk*> next{nullptr};
+};
+
+//NOTE: buffers live until exit or the next reset() so events of finished threads can still be
+// exported. Only the owning thread writes, it rewinds its own chunks once it sees a newer reset
+// generation; until then readers skip the buffer, its events predate the reset
+struct thread_buffer {
+    thread_buffer() = default;
+    thread_buffer(const thread_buffer&) = delete;
+    thread_buffer& operator=(const thread_buffer&) = delete;
+
+    ~thread_buffer() {
+        chunk* c = head->next.load(std::memory_order_relaxed);
+        while (c != nullptr) {
+            chunk* next = c->next.load(std::memory_order_relaxed);
+            delete c;
+            c = next;
+        }
+    }
+
+    std::unique_ptr<chunk> head{std::make_unique<chunk>()};
+    chunk* tail{head.get()};
+    size_t tail_index{0};
+    std::atomic<u64> generation{0};
+    std::atomic<bool> retired{false};
+    u32 tid{0};
+    std::string name;
+};
+
+//NOTE: `generation` only changes under the mutex, so it is stable while a reader holds it
+struct registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<thread_buffer>> buffers;
+    std::atomic<u64> generation{0};
+    std::atomic<size_t> event_limit{default_event_limit};
+    std::atomic<u64> dropped{0};
+    u32 next_tid{0};
+};
+
+registry& get_registry() {
+    static registry r;
+    return r;
+}
+
+thread_buffer* register_thread() {
+    auto& r = get_registry();
+    std::lock_guard lock(r.mutex);
+    auto& buffer = r.buffers.emplace_back(std::make_unique<thread_buffer>());
+    buffer->tid = ++r.next_tid;
+    buffer->generation.store(r.generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return buffer.get();
+}
+
+//NOTE: marks the buffer retired on thread exit, reset() frees retired buffers
+struct thread_handle {
+    thread_buffer* buffer = nullptr;
+
+    ~thread_handle() {
+        if (buffer != nullptr) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local thread_handle t_buffer;
+
+thread_buffer& local_buffer() {
+    if (t_buffer.buffer == nullptr) {
+        t_buffer.buffer = register_thread();
+    }
+    return *t_buffer.buffer;
+}
+
+//NOTE: a reader holding the registry mutex sees the events of the current generation only
+bool current(const registry& r, const thread_buffer& buffer) noexcept {
+    return buffer.generation.load(std::memory_order_acquire) == r.generation.load(std::memory_order_relaxed);
+}
+
+void rewind(thread_buffer& buffer, u64 generation) noexcept {
+    for (chunk* c = buffer.head.get(); c != nullptr; c = c->next.load(std::memory_order_relaxed)) {
+        c->count.store(0, std::memory_order_relaxed);
+    }
+    buffer.tail = buffer.head.get();
+    buffer.tail_index = 0;
+    buffer.generation.store(generation, std::memory_order_release);
+}
+
+void append_escaped(fmt::memory_buffer& out, std::string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '"': out.append(std::string_view("\\\"")); break;
+            case '\\': out.append(std::string_view("\\\\")); break;
+            case '\n': out.append(std::string_view("\\n")); break;
+            case '\t': out.append(std::string_view("\\t")); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fmt::format_to(fmt::appender(out), "\\u{:04x}", static_cast<unsigned>(c));
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+}
+
+void append_event(fmt::memory_buffer& out, const event& e, u32 tid) {
+    out.append(std::string_view("{\"name\":\""));
+    append_escaped(out, e.name);
+    switch (e.kind) {
+        case event_kind::zone:
+            fmt::format_to(fmt::appender(out), "\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                           static_cast<f64>(e.begin) / 1000.0, static_cast<f64>(e.end - e.begin) / 1000.0, tid);
+            break;
+        case event_kind::counter:
+            fmt::format_to(fmt::appender(out), "\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"args\":{{\"value\":{}}}}}",
+                           static_cast<f64>(e.begin) / 1000.0, std::bit_cast<f64>(e.end));
+            break;
+        case event_kind::frame:
+            fmt::format_to(fmt::appender(out), "\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                           static_cast<f64>(e.begin) / 1000.0, tid);
+            break;
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+void record(const char* name, u64 begin, u64 end, event_kind kind) noexcept {
+    thread_buffer* buffer;
+    try {
+        buffer = &local_buffer();
+    } catch (...) {
+        return;
+    }
+
+    auto& r = get_registry();
+    u64 generation = r.generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+        rewind(*buffer, generation);
+    }
+
+    chunk* c = buffer->tail;
+    size_t n = c->count.load(std::memory_order_relaxed);
+    if (n == chunk::capacity) {
+        if ((buffer->tail_index + 1) * chunk::capacity >= r.event_limit.load(std::memory_order_relaxed)) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        //NOTE: chunks kept by a rewind are reused before new ones are allocated
+        chunk* next = c->next.load(std::memory_order_relaxed);
+        if (next == nullptr) {
+            next = new (std::nothrow) chunk();
+            if (next == nullptr) {
+                r.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            c->next.store(next, std::memory_order_release);
+        }
+        buffer->tail = next;
+        ++buffer->tail_index;
+        c = next;
+        n = 0;
+    }
+
+    c->events[n] = event{name, begin, end, kind};
+    c->count.store(n + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+void set_thread_name(const char* name) {
+    auto& buffer = local_buffer();
+    std::lock_guard lock(get_registry().mutex);
+    buffer.name = name;
+}
+
+size_t event_count() noexcept {
+    auto& r = get_registry();
+    std::lock_guard lock(r.mutex);
+    size_t count = 0;
+    for (const auto& buffer : r.buffers) {
+        if (!current(r, *buffer)) {
+            continue;
+        }
+        for (const chunk* c = buffer->head.get(); c != nullptr; c = c->next.load(std::memory_order_acquire)) {
+            count += c->count.load(std::memory_order_acquire);
+        }
+    }
+    return count;
+}
+
+u64 dropped_count() noexcept {
+    return get_registry().dropped.load(std::memory_order_relaxed);
+}
+
+void set_event_limit(size_t events_per_thread) noexcept {
+    get_registry().event_limit.store(std::max(events_per_thread, chunk::capacity), std::memory_order_relaxed);
+}
+
+void reset() {
+    auto& r = get_registry();
+    std::lock_guard lock(r.mutex);
+    std::erase_if(r.buffers, [](const std::unique_ptr<thread_buffer>& buffer) {
+        return buffer->retired.load(std::memory_order_acquire);
+    });
+    r.generation.fetch_add(1, std::memory_order_release);
+    r.dropped.store(0, std::memory_order_relaxed);
+}
+
+cc::result<void> write_chrome_trace(const std::filesystem::path& path) {
+    fmt::memory_buffer out;
+    out.append(std::string_view("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"));
+    bool first = true;
+    auto separate = [&]() {
+        if (!first) {
+            out.append(std::string_view(",\n"));
+        }
+        first = false;
+    };
+
+    {
+        auto& r = get_registry();
+        std::lock_guard lock(r.mutex);
+        for (const auto& buffer : r.buffers) {
+            if (!buffer->name.empty()) {
+                separate();
+                fmt::format_to(fmt::appender(out), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"",
+                               buffer->tid);
+                append_escaped(out, buffer->name);
+                out.append(std::string_view("\"}}"));
+            }
+
+            if (!current(r, *buffer)) {
+                continue;
+            }
+            for (const chunk* c = buffer->head.get(); c != nullptr; c = c->next.load(std::memory_order_acquire)) {
+                size_t count = c->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; ++i) {
+                    separate();
+                    append_event(out, c->events[i], buffer->tid);
+                }
+            }
+        }
+    }
+    out.append(std::string_view("\n]}\n"));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return cc::err(cc::error_code::file_access_denied, "Failed to open trace file");
+    }
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        return cc::err(cc::error_code::file_write_error, "Failed to write trace file");
+    }
+    return cc::ok();
+}
+
+} // namespace cc::profile
@@ -1,4 +1,5 @@
 #include "buffer.hpp"
+#include "../../../src/metrics.hpp"
 #include "cbox/core/core.hpp"
 #include <format>
 #include <glad/glad.h>
@@ -67,6 +68,8 @@ void GLBuffer::Unbind() const {
 }
 
 void GLBuffer::SetData(const void* data, u32 size, u32 offset) {
+    BufferUploadBytes().add(size);
+
     glBindBuffer(ToGLBufferType(type_), buffer_id_);
     glBufferSubData(ToGLBufferType(type_), offset, size, data);
     glBindBuffer(ToGLBufferType(type_), 0);
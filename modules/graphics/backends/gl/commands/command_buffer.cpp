@@ -7,6 +7,7 @@
 #include "cbox/graphics/resources/texture.hpp"
 #include "cbox/graphics/resources/sampler.hpp"
 #include "../pipeline/pipeline.hpp"
+#include "../../../src/metrics.hpp"
 #include "cbox/core/core.hpp"
 #include <glad/glad.h>
 
@@ -25,6 +26,8 @@ void GLCommandBuffer::Begin() {
 
 void GLCommandBuffer::End() {
     recording_ = false;
+    current_pipeline_ = nullptr;
+    current_shader_ = nullptr;
 }
 
 void GLCommandBuffer::BeginRenderPass(const ref<RenderPass>& pass) {
@@ -63,8 +66,8 @@ void GLCommandBuffer::BeginRenderPass(const ref<RenderPass>& pass) {
 void GLCommandBuffer::EndRenderPass() {}
 
 void GLCommandBuffer::SetPipeline(const ref<PipelineState>& pipeline) {
-    current_pipeline_ = std::static_pointer_cast<GLPipelineState>(pipeline);
-    current_shader_ = pipeline->GetShader();
+    current_pipeline_ = static_cast<GLPipelineState*>(pipeline.get());
+    current_shader_ = pipeline->GetShader().get();
     current_pipeline_->Bind();
 }
 
@@ -143,6 +146,52 @@ void GLCommandBuffer::SetUniformMat4(const std::string& name, const mat4f& value
     }
 }
 
+i32 GLCommandBuffer::UniformLocation(name_id name) const noexcept {
+    return current_shader_ ? current_shader_->GetUniformLocation(name) : -1;
+}
+
+void GLCommandBuffer::SetUniformFloat(name_id name, f32 value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniform1f(loc, value);
+    }
+}
+
+void GLCommandBuffer::SetUniformInt(name_id name, i32 value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniform1i(loc, value);
+    }
+}
+
+void GLCommandBuffer::SetUniformVec2(name_id name, const vec2f& value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniform2f(loc, value.x, value.y);
+    }
+}
+
+void GLCommandBuffer::SetUniformVec3(name_id name, const vec3f& value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniform3f(loc, value.x, value.y, value.z);
+    }
+}
+
+void GLCommandBuffer::SetUniformVec4(name_id name, const vec4f& value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniform4f(loc, value.x, value.y, value.z, value.w);
+    }
+}
+
+void GLCommandBuffer::SetUniformMat3(name_id name, const mat3f& value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniformMatrix3fv(loc, 1, GL_FALSE, &value[0][0]);
+    }
+}
+
+void GLCommandBuffer::SetUniformMat4(name_id name, const mat4f& value) {
+    if (i32 loc = UniformLocation(name); loc >= 0) {
+        glUniformMatrix4fv(loc, 1, GL_FALSE, &value[0][0]);
+    }
+}
+
 void GLCommandBuffer::SetTexture(u32 slot, const ref<Texture>& texture) {
     if (texture) {
         texture->Bind(slot);
@@ -182,6 +231,7 @@ void GLCommandBuffer::Draw(u32 vertex_count, u32 first_vertex) {
     }
 
     glDrawArrays(mode, first_vertex, vertex_count);
+    DrawCallCounter().add();
 }
 
 void GLCommandBuffer::DrawIndexed(u32 index_count, u32 first_index, i32 vertex_offset) {
@@ -212,6 +262,7 @@ void GLCommandBuffer::DrawIndexed(u32 index_count, u32 first_index, i32 vertex_o
 
     void* offset = reinterpret_cast<void*>(static_cast<uintptr_t>(first_index * sizeof(u32)));
     glDrawElements(mode, index_count, GL_UNSIGNED_INT, offset);
+    DrawCallCounter().add();
 }
 
 void GLCommandBuffer::SetViewport(f32 x, f32 y, f32 width, f32 height) {
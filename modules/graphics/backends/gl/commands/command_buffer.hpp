@@ -12,6 +12,12 @@ class GLCommandBuffer : public CommandBuffer {
 
     static auto Create() -> result<ref<GLCommandBuffer>>;
 
+    using CommandBuffer::SetPipeline;
+    using CommandBuffer::SetVertexBuffer;
+    using CommandBuffer::SetIndexBuffer;
+    using CommandBuffer::SetTexture;
+    using CommandBuffer::SetSampler;
+
     void Begin() override;
     void End() override;
 
@@ -30,6 +36,14 @@ class GLCommandBuffer : public CommandBuffer {
     void SetUniformMat3(const std::string& name, const mat3f& value) override;
     void SetUniformMat4(const std::string& name, const mat4f& value) override;
 
+    void SetUniformFloat(name_id name, f32 value) override;
+    void SetUniformInt(name_id name, i32 value) override;
+    void SetUniformVec2(name_id name, const vec2f& value) override;
+    void SetUniformVec3(name_id name, const vec3f& value) override;
+    void SetUniformVec4(name_id name, const vec4f& value) override;
+    void SetUniformMat3(name_id name, const mat3f& value) override;
+    void SetUniformMat4(name_id name, const mat4f& value) override;
+
     void SetTexture(u32 slot, const ref<Texture>& texture) override;
     void SetSampler(u32 slot, const ref<Sampler>& sampler) override;
 
@@ -42,8 +56,12 @@ class GLCommandBuffer : public CommandBuffer {
   private:
     GLCommandBuffer() = default;
 
-    ref<ShaderModule> current_shader_;
-    ref<GLPipelineState> current_pipeline_;
+    i32 UniformLocation(name_id name) const noexcept;
+
+    //NOTE: non owning, GL executes every command as it is recorded, so bound objects only need to
+    // outlive the draws that use them. Binding does not touch refcounts, End() clears both
+    ShaderModule* current_shader_{nullptr};
+    GLPipelineState* current_pipeline_{nullptr};
     bool recording_{false};
 };
 
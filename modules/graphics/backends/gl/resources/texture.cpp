@@ -130,6 +130,7 @@ auto GLTexture2D::Create(u32 width, u32 height, TextureFormat format, const void
 
 auto GLTexture2D::CreateFromFile(const std::filesystem::path& filepath, bool srgb, bool mipmaps)
     -> ref<GLTexture2D> {
+    CC_PROFILE_SCOPE("GLTexture2D::CreateFromFile");
     if (!std::filesystem::exists(filepath)) {
         auto msg = std::format("Texture file not found: {}", filepath.string());
         std::runtime_error(msg.c_str());
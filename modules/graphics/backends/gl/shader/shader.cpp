@@ -107,6 +107,30 @@ auto GLShader::LinkProgram(const std::vector<u32>& shader_ids) -> result<u32> {
     return ok(program_id);
 }
 
+auto GLShader::GetActiveUniforms(u32 program_id) -> std::vector<std::pair<std::string, i32>> {
+    GLint count = 0;
+    glGetProgramiv(program_id, GL_ACTIVE_UNIFORMS, &count);
+    GLint max_length = 0;
+    glGetProgramiv(program_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    std::vector<std::pair<std::string, i32>> uniforms;
+    uniforms.reserve(static_cast<size_t>(count));
+    std::string name(static_cast<size_t>(max_length), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program_id, static_cast<GLuint>(i), max_length, &length, &size, &type, name.data());
+
+        std::string uniform(name.data(), static_cast<size_t>(length));
+        i32 location = glGetUniformLocation(program_id, uniform.c_str());
+        if (location >= 0) {
+            uniforms.emplace_back(std::move(uniform), location);
+        }
+    }
+    return uniforms;
+}
+
 void GLShader::DeleteShader(u32 shader_id) {
     glDeleteShader(shader_id);
 }
@@ -15,6 +15,10 @@ class GLShader {
 
     static auto LinkProgram(const std::vector<u32>& shader_ids) -> result<u32>;
 
+    //NOTE: (name, location) of every active uniform of a linked program, arrays are reported by
+    // their first element, e.g. "u_lights[0]"
+    static auto GetActiveUniforms(u32 program_id) -> std::vector<std::pair<std::string, i32>>;
+
     static void DeleteShader(u32 shader_id);
     static void DeleteProgram(u32 program_id);
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "cbox/core/core.hpp"
 #include "cbox/math/math.hpp"
+#include "cbox/graphics/resources/handles.hpp"
 
 namespace cc {
 
@@ -34,6 +35,15 @@ class CommandBuffer {
     virtual void SetUniformMat3(const std::string& name, const mat3f& value) = 0;
     virtual void SetUniformMat4(const std::string& name, const mat4f& value) = 0;
 
+    //NOTE: per draw variants, the location comes from the shader's link time table
+    virtual void SetUniformFloat(name_id name, f32 value) = 0;
+    virtual void SetUniformInt(name_id name, i32 value) = 0;
+    virtual void SetUniformVec2(name_id name, const vec2f& value) = 0;
+    virtual void SetUniformVec3(name_id name, const vec3f& value) = 0;
+    virtual void SetUniformVec4(name_id name, const vec4f& value) = 0;
+    virtual void SetUniformMat3(name_id name, const mat3f& value) = 0;
+    virtual void SetUniformMat4(name_id name, const mat4f& value) = 0;
+
     virtual void SetTexture(u32 slot, const ref<Texture>& texture) = 0;
     virtual void SetSampler(u32 slot, const ref<Sampler>& sampler) = 0;
 
@@ -43,6 +53,14 @@ class CommandBuffer {
     virtual void SetViewport(f32 x, f32 y, f32 width, f32 height) = 0;
     virtual void SetScissor(i32 x, i32 y, u32 width, u32 height) = 0;
 
+    //NOTE: handle overloads resolve through the active RendererContext's resource pool, invalid
+    // handles and calls without a context are ignored
+    void SetPipeline(PipelineHandle pipeline);
+    void SetVertexBuffer(BufferHandle buffer, u32 binding = 0);
+    void SetIndexBuffer(BufferHandle buffer);
+    void SetTexture(u32 slot, TextureHandle texture);
+    void SetSampler(u32 slot, SamplerHandle sampler);
+
   protected:
     CommandBuffer() = default;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "cbox/core/core.hpp"
 #include "cbox/graphics/types/types.hpp"
+#include "cbox/graphics/resources/pool.hpp"
 
 namespace cc {
 
@@ -46,6 +47,15 @@ class RendererContext {
     ref<RenderDevice> GetDevice() const noexcept {
         return device_;
     }
+    ResourcePool& GetResources() noexcept {
+        return resources_;
+    }
+
+    //NOTE: pool of the current context without touching the instance refcount, nullptr before
+    // Build() and after Shutdown()
+    static ResourcePool* Resources() noexcept {
+        return instance_ ? &instance_->resources_ : nullptr;
+    }
 
     void InitializeDevice();
 
@@ -54,6 +64,7 @@ class RendererContext {
 
     RenderAPI api_{RenderAPI::None};
     ref<RenderDevice> device_;
+    ResourcePool resources_;
     bool vsync_{true};
     u32 msaa_samples_{0};
 
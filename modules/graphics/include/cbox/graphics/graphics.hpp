@@ -15,6 +15,7 @@
 #include "resources/sampler.hpp"
 #include "resources/texture.hpp"
 #include "resources/mesh.hpp"
+#include "resources/pool.hpp"
 #include "pipeline/vlayout.hpp"
 #include "pipeline/rasterizer.hpp"
 #include "pipeline/depth_stencil.hpp"
@@ -0,0 +1,19 @@
+#pragma once
+#include "cbox/core/handle.hpp"
+
+namespace cc {
+
+class Buffer;
+class Texture;
+class Sampler;
+class ShaderModule;
+class PipelineState;
+
+//NOTE: handles of the resources a ResourcePool owns, usable without the resource headers
+using BufferHandle = handle<Buffer>;
+using TextureHandle = handle<Texture>;
+using SamplerHandle = handle<Sampler>;
+using ShaderHandle = handle<ShaderModule>;
+using PipelineHandle = handle<PipelineState>;
+
+} // namespace cc
@@ -0,0 +1,79 @@
+#pragma once
+#include "cbox/core/core.hpp"
+#include "cbox/graphics/resources/handles.hpp"
+#include "cbox/graphics/resources/buffer.hpp"
+#include "cbox/graphics/resources/texture.hpp"
+#include "cbox/graphics/resources/sampler.hpp"
+#include "cbox/graphics/shader/module.hpp"
+#include "cbox/graphics/pipeline/pipeline.hpp"
+#include <span>
+
+namespace cc {
+
+//NOTE: owns GPU resources behind generational handles so render loop code can pass 8 byte PODs
+// instead of copying ref<T>. Create* returns a null handle when the underlying build fails, a
+// destroyed or stale handle resolves to nullptr
+class ResourcePool {
+  public:
+    ResourcePool() = default;
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    auto CreateBuffer(BufferType type, BufferUsage usage, u32 size, const void* data = nullptr)
+        -> BufferHandle;
+
+    template <typename T>
+    auto CreateBuffer(BufferType type, BufferUsage usage, std::span<const T> data) -> BufferHandle {
+        return CreateBuffer(type, usage, static_cast<u32>(data.size() * sizeof(T)), data.data());
+    }
+
+    auto CreateTexture(Texture2D::Builder builder) -> TextureHandle;
+    auto CreateSampler(Sampler::Builder builder) -> SamplerHandle;
+    auto CreateShader(ShaderModule::Builder builder) -> ShaderHandle;
+    auto CreatePipeline(PipelineState::Builder builder) -> result<PipelineHandle>;
+
+    //NOTE: adopt resources created through the ref<T> API
+    auto Add(ref<Buffer> buffer) -> BufferHandle;
+    auto Add(ref<Texture> texture) -> TextureHandle;
+    auto Add(ref<Sampler> sampler) -> SamplerHandle;
+    auto Add(ref<ShaderModule> shader) -> ShaderHandle;
+    auto Add(ref<PipelineState> pipeline) -> PipelineHandle;
+
+    Buffer* Get(BufferHandle handle) const noexcept { return Resolve(buffers_, handle).get(); }
+    Texture* Get(TextureHandle handle) const noexcept { return Resolve(textures_, handle).get(); }
+    Sampler* Get(SamplerHandle handle) const noexcept { return Resolve(samplers_, handle).get(); }
+    ShaderModule* Get(ShaderHandle handle) const noexcept { return Resolve(shaders_, handle).get(); }
+    PipelineState* Get(PipelineHandle handle) const noexcept { return Resolve(pipelines_, handle).get(); }
+
+    //NOTE: the owning reference, for APIs that still take const ref<T>&. Returns a null ref for
+    // invalid handles
+    const ref<Buffer>& GetRef(BufferHandle handle) const noexcept { return Resolve(buffers_, handle); }
+    const ref<Texture>& GetRef(TextureHandle handle) const noexcept { return Resolve(textures_, handle); }
+    const ref<Sampler>& GetRef(SamplerHandle handle) const noexcept { return Resolve(samplers_, handle); }
+    const ref<ShaderModule>& GetRef(ShaderHandle handle) const noexcept { return Resolve(shaders_, handle); }
+    const ref<PipelineState>& GetRef(PipelineHandle handle) const noexcept { return Resolve(pipelines_, handle); }
+
+    bool Destroy(BufferHandle handle) { return buffers_.erase(handle); }
+    bool Destroy(TextureHandle handle) { return textures_.erase(handle); }
+    bool Destroy(SamplerHandle handle) { return samplers_.erase(handle); }
+    bool Destroy(ShaderHandle handle) { return shaders_.erase(handle); }
+    bool Destroy(PipelineHandle handle) { return pipelines_.erase(handle); }
+
+    void Clear();
+
+  private:
+    template <typename T>
+    static const ref<T>& Resolve(const slot_map<ref<T>, T>& map, handle<T> handle) noexcept {
+        static const ref<T> null_ref;
+        const ref<T>* value = map.get(handle);
+        return value != nullptr ? *value : null_ref;
+    }
+
+    slot_map<ref<Buffer>, Buffer> buffers_;
+    slot_map<ref<Texture>, Texture> textures_;
+    slot_map<ref<Sampler>, Sampler> samplers_;
+    slot_map<ref<ShaderModule>, ShaderModule> shaders_;
+    slot_map<ref<PipelineState>, PipelineState> pipelines_;
+};
+
+} // namespace cc
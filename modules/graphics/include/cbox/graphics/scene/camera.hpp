@@ -6,6 +6,10 @@ namespace cc {
 
 enum class ProjectionType : u8 { Perspective, Orthographic };
 
+//NOTE: LookAt aims the camera at the target with the up vector, Orientation takes the rotation
+// from a quaternion and only keeps the target as the orbit pivot
+enum class ViewMode : u8 { LookAt, Orientation };
+
 class Camera {
   public:
     class Builder {
@@ -63,11 +67,26 @@ class Camera {
 
     void SetTarget(const vec3f& target) noexcept {
         target_ = target;
+        mode_ = ViewMode::LookAt;
         view_dirty_ = true;
     }
 
     void SetUp(const vec3f& up) noexcept {
         up_ = up;
+        mode_ = ViewMode::LookAt;
+        view_dirty_ = true;
+    }
+
+    void SetOrientation(const quatf& orientation) noexcept {
+        orientation_ = orientation;
+        mode_ = ViewMode::Orientation;
+        view_dirty_ = true;
+    }
+
+    //NOTE: turns the camera in its own space, switches to orientation mode
+    void Rotate(const quatf& delta) noexcept {
+        orientation_ = (GetOrientation() * delta).norm();
+        mode_ = ViewMode::Orientation;
         view_dirty_ = true;
     }
 
@@ -98,15 +117,39 @@ class Camera {
     const vec3f& GetTarget() const noexcept {
         return target_;
     }
-    const vec3f& GetUp() const noexcept {
+    //NOTE: the up vector set for look-at, in orientation mode the camera's own +y
+    vec3f GetUp() const noexcept {
+        if (mode_ == ViewMode::Orientation) {
+            return orientation_.rotate(vec3f{0.0f, 1.0f, 0.0f});
+        }
         return up_;
     }
+    ViewMode GetViewMode() const noexcept {
+        return mode_;
+    }
+
+    //NOTE: camera to world rotation, the camera looks down its -z
+    quatf GetOrientation() const noexcept {
+        if (mode_ == ViewMode::Orientation) {
+            return orientation_;
+        }
+        vec3f f = GetForward();
+        vec3f s = f.cross(up_).norm();
+        vec3f u = s.cross(f);
+        return quatf::from_mat(mat3f(layout::colm, s.x, s.y, s.z, u.x, u.y, u.z, -f.x, -f.y, -f.z));
+    }
 
     vec3f GetForward() const noexcept {
+        if (mode_ == ViewMode::Orientation) {
+            return orientation_.rotate(vec3f{0.0f, 0.0f, -1.0f});
+        }
         return (target_ - position_).norm();
     }
 
     vec3f GetRight() const noexcept {
+        if (mode_ == ViewMode::Orientation) {
+            return orientation_.rotate(vec3f{1.0f, 0.0f, 0.0f});
+        }
         return GetForward().cross(up_).norm();
     }
 
@@ -116,17 +159,17 @@ class Camera {
         view_dirty_ = true;
     }
 
+    //NOTE: swings the position around the target by the inverse of rotate_y(yaw) * rotate_x(pitch).
+    // In orientation mode the camera turns with it and keeps its view of the target
     void Orbit(f32 yaw, f32 pitch) noexcept {
         vec3f offset = position_ - target_;
         f32 radius = offset.len();
 
-        mat4f rotation = rotate_y(yaw) * rotate_x(pitch);
-        vec3f rotated = vec3f{
-            rotation[0][0] * offset.x + rotation[0][1] * offset.y + rotation[0][2] * offset.z,
-            rotation[1][0] * offset.x + rotation[1][1] * offset.y + rotation[1][2] * offset.z,
-            rotation[2][0] * offset.x + rotation[2][1] * offset.y + rotation[2][2] * offset.z};
-
-        position_ = target_ + rotated.norm() * radius;
+        quatf rotation = (quatf::rotation_y(yaw) * quatf::rotation_x(pitch)).conjugate();
+        position_ = target_ + rotation.rotate(offset).norm() * radius;
+        if (mode_ == ViewMode::Orientation) {
+            orientation_ = (rotation * orientation_).norm();
+        }
         view_dirty_ = true;
     }
 
@@ -134,7 +177,11 @@ class Camera {
     Camera() = default;
 
     void UpdateView() const noexcept {
-        view_ = look_at(position_, target_, up_);
+        if (mode_ == ViewMode::LookAt) {
+            view_ = look_at(position_, target_, up_);
+        } else {
+            view_ = rigid3f(orientation_, position_).inverse().to_mat4();
+        }
         view_dirty_ = false;
     }
 
@@ -160,6 +207,8 @@ class Camera {
     vec3f position_{0.0f, 0.0f, 3.0f};
     vec3f target_{0.0f, 0.0f, 0.0f};
     vec3f up_{0.0f, 1.0f, 0.0f};
+    quatf orientation_{};
+    ViewMode mode_{ViewMode::LookAt};
 
     mutable mat4f view_{mat4f::identity()};
     mutable mat4f projection_{mat4f::identity()};
@@ -1,7 +1,6 @@
 #pragma once
 #include "cbox/core/core.hpp"
 #include "cbox/math/math.hpp"
-#include <unordered_map>
 #include <variant>
 
 namespace cc {
@@ -28,14 +27,16 @@ class Material {
         Builder& SetMat4(const std::string& name, const mat4f& value);
         Builder& SetTexture(const std::string& name, u32 slot, const ref<Texture>& texture);
         Builder& SetSampler(u32 slot, const ref<Sampler>& sampler);
+        Builder& SetUniform(name_id name, const UniformValue& value);
+        Builder& SetTexture(name_id name, u32 slot, const ref<Texture>& texture);
 
         ref<Material> Build();
 
       private:
         ref<ShaderModule> shader_;
-        std::unordered_map<std::string, UniformValue> uniforms_;
-        std::unordered_map<std::string, std::pair<u32, ref<Texture>>> textures_;
-        std::unordered_map<u32, ref<Sampler>> samplers_;
+        flat_map<name_id, UniformValue> uniforms_;
+        flat_map<name_id, std::pair<u32, ref<Texture>>> textures_;
+        flat_map<u32, ref<Sampler>> samplers_;
     };
 
     static Builder Create() {
@@ -48,11 +49,20 @@ class Material {
         return shader_;
     }
 
+    //NOTE: names are hashed once here, Apply() binds by name_id
     template <typename T> void SetUniform(const std::string& name, const T& value) {
+        uniforms_[name_id(name)] = value;
+    }
+
+    template <typename T> void SetUniform(name_id name, const T& value) {
         uniforms_[name] = value;
     }
 
     void SetTexture(const std::string& name, u32 slot, const ref<Texture>& texture) {
+        textures_[name_id(name)] = {slot, texture};
+    }
+
+    void SetTexture(name_id name, u32 slot, const ref<Texture>& texture) {
         textures_[name] = {slot, texture};
     }
 
@@ -64,9 +74,9 @@ class Material {
     Material() = default;
 
     ref<ShaderModule> shader_;
-    std::unordered_map<std::string, UniformValue> uniforms_;
-    std::unordered_map<std::string, std::pair<u32, ref<Texture>>> textures_;
-    std::unordered_map<u32, ref<Sampler>> samplers_;
+    flat_map<name_id, UniformValue> uniforms_;
+    flat_map<name_id, std::pair<u32, ref<Texture>>> textures_;
+    flat_map<u32, ref<Sampler>> samplers_;
 
     friend class Builder;
 };
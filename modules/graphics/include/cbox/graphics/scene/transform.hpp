@@ -4,6 +4,10 @@
 
 namespace cc {
 
+//NOTE: which representation is authoritative. Euler angles are what editors expose, a quaternion
+// composes and interpolates without gimbal lock. Both build the matrix without matrix products
+enum class RotationMode : u8 { Euler, Quaternion };
+
 class Transform {
   public:
     Transform() = default;
@@ -19,6 +23,13 @@ class Transform {
 
     void SetRotation(const vec3f& euler) noexcept {
         rotation_ = euler;
+        mode_ = RotationMode::Euler;
+        dirty_ = true;
+    }
+
+    void SetOrientation(const quatf& orientation) noexcept {
+        orientation_ = orientation;
+        mode_ = RotationMode::Quaternion;
         dirty_ = true;
     }
 
@@ -32,8 +43,20 @@ class Transform {
         dirty_ = true;
     }
 
+    //NOTE: adds to the angles in Euler mode, in quaternion mode `delta` is applied in local space
     void Rotate(const vec3f& delta) noexcept {
-        rotation_ += delta;
+        if (mode_ == RotationMode::Euler) {
+            rotation_ += delta;
+        } else {
+            orientation_ = (orientation_ * quatf::from_euler(delta)).norm();
+        }
+        dirty_ = true;
+    }
+
+    //NOTE: local space rotation, switches to quaternion mode
+    void Rotate(const quatf& delta) noexcept {
+        orientation_ = (GetOrientation() * delta).norm();
+        mode_ = RotationMode::Quaternion;
         dirty_ = true;
     }
 
@@ -45,8 +68,14 @@ class Transform {
     const vec3f& GetPosition() const noexcept {
         return position_;
     }
-    const vec3f& GetRotation() const noexcept {
-        return rotation_;
+    vec3f GetRotation() const noexcept {
+        return mode_ == RotationMode::Euler ? rotation_ : orientation_.to_euler();
+    }
+    quatf GetOrientation() const noexcept {
+        return mode_ == RotationMode::Quaternion ? orientation_ : quatf::from_euler(rotation_);
+    }
+    RotationMode GetRotationMode() const noexcept {
+        return mode_;
     }
     const vec3f& GetScale() const noexcept {
         return scale_;
@@ -78,17 +107,26 @@ class Transform {
     }
 
   private:
+    //NOTE: translate * rotate * scale written out, the rotation columns scaled and the position
+    // dropped into the last column
     void UpdateMatrix() const noexcept {
-        mat4f translation = translate(position_);
-        mat4f rotation = rotate(rotation_);
-        mat4f scaling = scale(scale_);
-        matrix_ = translation * rotation * scaling;
+        matrix_ = GetOrientation().to_mat4();
+        for (std::size_t c = 0; c < 3; ++c) {
+            matrix_[c][0] *= scale_[c];
+            matrix_[c][1] *= scale_[c];
+            matrix_[c][2] *= scale_[c];
+        }
+        matrix_[3][0] = position_.x;
+        matrix_[3][1] = position_.y;
+        matrix_[3][2] = position_.z;
         dirty_ = false;
     }
 
     vec3f position_{0.0f, 0.0f, 0.0f};
     vec3f rotation_{0.0f, 0.0f, 0.0f};
     vec3f scale_{1.0f, 1.0f, 1.0f};
+    quatf orientation_{};
+    RotationMode mode_{RotationMode::Euler};
     mutable mat4f matrix_{mat4f::identity()};
     mutable bool dirty_{true};
 };
@@ -4,7 +4,6 @@
 #include "cbox/graphics/shader/reflection.hpp"
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 namespace cc {
 
@@ -16,7 +15,8 @@ class ShaderModule {
 
         Builder& AddStage(ShaderStage stage, const std::filesystem::path& filepath);
         Builder& AddStage(ShaderStage stage, const std::vector<u32>& spirv);
-        Builder& Reflect();
+        //NOTE: reflection scratch is drawn from `resource`, the module keeps its own copy
+        Builder& Reflect(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
         ref<ShaderModule> Build();
 
@@ -28,8 +28,9 @@ class ShaderModule {
             ShaderReflection reflection;
         };
 
-        std::unordered_map<ShaderStage, StageData> stages_;
+        flat_map<ShaderStage, StageData> stages_;
         bool reflect_{false};
+        std::pmr::memory_resource* reflect_resource_{std::pmr::get_default_resource()};
     };
 
     ~ShaderModule();
@@ -47,14 +48,17 @@ class ShaderModule {
     void Unbind() const;
 
     i32 GetUniformLocation(const std::string& name) const;
+    //NOTE: resolved from the table of active uniforms built at link time, no string is touched
+    i32 GetUniformLocation(name_id name) const noexcept;
     i32 GetAttributeLocation(const std::string& name) const;
 
   private:
     ShaderModule() = default;
 
     u32 program_id_{0};
-    std::unordered_map<ShaderStage, ShaderReflection> reflections_;
-    mutable std::unordered_map<std::string, i32> uniform_location_cache_;
+    flat_map<ShaderStage, ShaderReflection> reflections_;
+    mutable hash_map<std::string, i32> uniform_location_cache_;
+    hash_map<name_id, i32> uniform_ids_;
 };
 
 } // namespace cc
@@ -1,9 +1,9 @@
 #pragma once
 #include "cbox/core/core.hpp"
 #include "cbox/graphics/shader/compiler.hpp"
+#include <memory_resource>
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 namespace cc {
 
@@ -40,12 +40,23 @@ struct UniformVariable {
     u32 size;
 };
 
+//NOTE: containers draw from the allocator given at construction, names that exceed the small
+// string buffer still use the global heap
 struct ShaderReflection {
-    std::vector<ShaderVertexAttribute> attributes;
-    std::vector<UniformVariable> uniforms;
-    std::vector<UniformVariable> samplers;
-    std::unordered_map<std::string, u32> uniform_locations;
-    std::unordered_map<std::string, u32> sampler_bindings;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::vector<ShaderVertexAttribute> attributes;
+    std::pmr::vector<UniformVariable> uniforms;
+    std::pmr::vector<UniformVariable> samplers;
+    cc::pmr::hash_map<name_id, u32> uniform_locations;
+    cc::pmr::hash_map<name_id, u32> sampler_bindings;
+
+    ShaderReflection() noexcept : ShaderReflection(allocator_type{}) {}
+
+    explicit ShaderReflection(allocator_type alloc) noexcept
+    : attributes(alloc), uniforms(alloc), samplers(alloc), uniform_locations(alloc), sampler_bindings(alloc) {}
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return attributes.get_allocator(); }
 };
 
 class ShaderReflector {
@@ -54,7 +65,9 @@ class ShaderReflector {
 
     static auto Create() -> result<ref<ShaderReflector>>;
 
-    auto Reflect(const std::vector<u32>& spirv, ShaderStage stage) -> result<ShaderReflection>;
+    auto Reflect(const std::vector<u32>& spirv, ShaderStage stage,
+                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        -> result<ShaderReflection>;
 
   private:
     ShaderReflector() = default;
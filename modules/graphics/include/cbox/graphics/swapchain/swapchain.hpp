@@ -31,6 +31,7 @@ class Swapchain {
     ref<Window> window_;
     ref<Framebuffer> framebuffer_;
     bool initialized_{false};
+    u64 last_draw_calls_{0};
 };
 
 } // namespace cc
@@ -1,10 +1,48 @@
 #include "cbox/graphics/commands/command_buffer.hpp"
+#include "cbox/graphics/context/context.hpp"
 #include "../../backends/gl/commands/command_buffer.hpp"
 
 namespace cc {
 
+template <typename T>
+static const ref<T>& ResolveCurrent(handle<T> handle) noexcept {
+    static const ref<T> null_ref;
+    ResourcePool* resources = RendererContext::Resources();
+    return resources != nullptr ? resources->GetRef(handle) : null_ref;
+}
+
 auto CommandBuffer::Create() -> result<ref<CommandBuffer>> {
     return GLCommandBuffer::Create();
 }
 
+void CommandBuffer::SetPipeline(PipelineHandle pipeline) {
+    if (const auto& resolved = ResolveCurrent(pipeline)) {
+        SetPipeline(resolved);
+    }
+}
+
+void CommandBuffer::SetVertexBuffer(BufferHandle buffer, u32 binding) {
+    if (const auto& resolved = ResolveCurrent(buffer)) {
+        SetVertexBuffer(resolved, binding);
+    }
+}
+
+void CommandBuffer::SetIndexBuffer(BufferHandle buffer) {
+    if (const auto& resolved = ResolveCurrent(buffer)) {
+        SetIndexBuffer(resolved);
+    }
+}
+
+void CommandBuffer::SetTexture(u32 slot, TextureHandle texture) {
+    if (const auto& resolved = ResolveCurrent(texture)) {
+        SetTexture(slot, resolved);
+    }
+}
+
+void CommandBuffer::SetSampler(u32 slot, SamplerHandle sampler) {
+    if (const auto& resolved = ResolveCurrent(sampler)) {
+        SetSampler(slot, resolved);
+    }
+}
+
 } // namespace cc
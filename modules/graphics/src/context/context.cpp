@@ -6,6 +6,7 @@
 namespace cc {
 
 RendererContext::~RendererContext() {
+    resources_.Clear();
     if (device_) {
         device_.reset();
     }
@@ -52,6 +53,7 @@ void RendererContext::InitializeDevice() {
 
 void RendererContext::Shutdown() {
     if (instance_) {
+        instance_->resources_.Clear();
         instance_->device_.reset();
         instance_.reset();
         log::Info("Renderer context shutdown complete");
@@ -0,0 +1,30 @@
+#include "metrics.hpp"
+
+namespace cc {
+
+metrics::counter& DrawCallCounter() {
+    static auto& draw_calls = metrics::get_counter("cbox_gfx_draw_calls_total", "Draw calls submitted");
+    return draw_calls;
+}
+
+metrics::counter& FrameCounter() {
+    static auto& frames = metrics::get_counter("cbox_gfx_frames_total", "Frames presented");
+    return frames;
+}
+
+metrics::histogram& DrawCallsPerFrame() {
+    static auto& per_frame = metrics::get_histogram("cbox_gfx_draw_calls_per_frame", "Draw calls between two presents");
+    return per_frame;
+}
+
+metrics::histogram& ShaderCompileTime() {
+    static auto& compile_time = metrics::get_histogram("cbox_gfx_shader_compile_ns", "Shader stage compile time in nanoseconds");
+    return compile_time;
+}
+
+metrics::counter& BufferUploadBytes() {
+    static auto& uploaded = metrics::get_counter("cbox_gfx_buffer_upload_bytes_total", "Bytes uploaded through Buffer::SetData");
+    return uploaded;
+}
+
+} // namespace cc
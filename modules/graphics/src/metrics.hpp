@@ -0,0 +1,14 @@
+#pragma once
+#include "cbox/core/metrics.hpp"
+
+namespace cc {
+
+//NOTE: each graphics series is registered in one place, the frontend and the backends use these
+// accessors instead of repeating the name and help strings
+metrics::counter& DrawCallCounter();
+metrics::counter& FrameCounter();
+metrics::histogram& DrawCallsPerFrame();
+metrics::histogram& ShaderCompileTime();
+metrics::counter& BufferUploadBytes();
+
+} // namespace cc
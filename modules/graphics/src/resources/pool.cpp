@@ -0,0 +1,59 @@
+#include "cbox/graphics/resources/pool.hpp"
+
+namespace cc {
+
+auto ResourcePool::CreateBuffer(BufferType type, BufferUsage usage, u32 size, const void* data)
+    -> BufferHandle {
+    return Add(Buffer::Create(type, usage, size, data));
+}
+
+auto ResourcePool::CreateTexture(Texture2D::Builder builder) -> TextureHandle {
+    return Add(ref<Texture>(builder.Build()));
+}
+
+auto ResourcePool::CreateSampler(Sampler::Builder builder) -> SamplerHandle {
+    return Add(builder.Build());
+}
+
+auto ResourcePool::CreateShader(ShaderModule::Builder builder) -> ShaderHandle {
+    return Add(builder.Build());
+}
+
+auto ResourcePool::CreatePipeline(PipelineState::Builder builder) -> result<PipelineHandle> {
+    auto pipeline = builder.Build();
+    if (!pipeline) {
+        return err(pipeline.error());
+    }
+    return ok(Add(std::move(pipeline.value())));
+}
+
+auto ResourcePool::Add(ref<Buffer> buffer) -> BufferHandle {
+    return buffer ? buffers_.insert(std::move(buffer)) : BufferHandle{};
+}
+
+auto ResourcePool::Add(ref<Texture> texture) -> TextureHandle {
+    return texture ? textures_.insert(std::move(texture)) : TextureHandle{};
+}
+
+auto ResourcePool::Add(ref<Sampler> sampler) -> SamplerHandle {
+    return sampler ? samplers_.insert(std::move(sampler)) : SamplerHandle{};
+}
+
+auto ResourcePool::Add(ref<ShaderModule> shader) -> ShaderHandle {
+    return shader ? shaders_.insert(std::move(shader)) : ShaderHandle{};
+}
+
+auto ResourcePool::Add(ref<PipelineState> pipeline) -> PipelineHandle {
+    return pipeline ? pipelines_.insert(std::move(pipeline)) : PipelineHandle{};
+}
+
+void ResourcePool::Clear() {
+    //NOTE: pipelines hold refs to their shaders, release dependents first
+    pipelines_.clear();
+    shaders_.clear();
+    samplers_.clear();
+    textures_.clear();
+    buffers_.clear();
+}
+
+} // namespace cc
@@ -12,43 +12,43 @@ auto Material::Builder::SetShader(const ref<ShaderModule>& shader) -> Builder& {
 }
 
 auto Material::Builder::SetFloat(const std::string& name, f32 value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetInt(const std::string& name, i32 value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetVec2(const std::string& name, const vec2f& value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetVec3(const std::string& name, const vec3f& value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetVec4(const std::string& name, const vec4f& value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetMat3(const std::string& name, const mat3f& value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetMat4(const std::string& name, const mat4f& value) -> Builder& {
-    uniforms_[name] = value;
+    uniforms_[name_id(name)] = value;
     return *this;
 }
 
 auto Material::Builder::SetTexture(const std::string& name, u32 slot, const ref<Texture>& texture)
     -> Builder& {
-    textures_[name] = {slot, texture};
+    textures_[name_id(name)] = {slot, texture};
     return *this;
 }
 
@@ -57,6 +57,17 @@ auto Material::Builder::SetSampler(u32 slot, const ref<Sampler>& sampler) -> Bui
     return *this;
 }
 
+auto Material::Builder::SetUniform(name_id name, const UniformValue& value) -> Builder& {
+    uniforms_[name] = value;
+    return *this;
+}
+
+auto Material::Builder::SetTexture(name_id name, u32 slot, const ref<Texture>& texture)
+    -> Builder& {
+    textures_[name] = {slot, texture};
+    return *this;
+}
+
 auto Material::Builder::Build() -> ref<Material> {
     auto material = ref<Material>(new Material());
     material->shader_ = shader_;
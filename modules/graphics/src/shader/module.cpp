@@ -2,6 +2,7 @@
 #include "cbox/graphics/shader/compiler.hpp"
 #include "cbox/graphics/shader/reflection.hpp"
 #include "../../backends/gl/shader/shader.hpp"
+#include "../metrics.hpp"
 #include "cbox/core/core.hpp"
 #include "glad/glad.h"
 #include <format>
@@ -23,7 +24,9 @@ auto ShaderModule::Builder::AddStage(ShaderStage stage, const std::filesystem::p
         return *this;
     }
 
+    auto compile_begin = std::chrono::steady_clock::now();
     auto spirv_result = compiler_result.value()->CompileFile(filepath, stage);
+    ShaderCompileTime().record(std::chrono::steady_clock::now() - compile_begin);
     if (!spirv_result) {
         log::Error("Failed to compile shader file '{}': {}", filepath.string(),
                    spirv_result.error().message());
@@ -49,12 +52,14 @@ auto ShaderModule::Builder::AddStage(ShaderStage stage, const std::vector<u32>&
     return *this;
 }
 
-auto ShaderModule::Builder::Reflect() -> Builder& {
+auto ShaderModule::Builder::Reflect(std::pmr::memory_resource* resource) -> Builder& {
     reflect_ = true;
+    reflect_resource_ = resource;
     return *this;
 }
 
 auto ShaderModule::Builder::Build() -> ref<ShaderModule> {
+    CC_PROFILE_SCOPE("ShaderModule::Build");
     if (stages_.empty()) {
         std::runtime_error("No shader stages added");
     }
@@ -97,7 +102,7 @@ auto ShaderModule::Builder::Build() -> ref<ShaderModule> {
                 std::runtime_error(msg.c_str());
             }
 
-            auto reflection_result = reflector_result.value()->Reflect(data.spirv, stage);
+            auto reflection_result = reflector_result.value()->Reflect(data.spirv, stage, reflect_resource_);
             if (!reflection_result) {
                 for (u32 id : shader_ids) {
                     GLShader::DeleteShader(id);
@@ -126,6 +131,15 @@ auto ShaderModule::Builder::Build() -> ref<ShaderModule> {
 
     module->program_id_ = program_result.value();
 
+    for (auto& [name, location] : GLShader::GetActiveUniforms(module->program_id_)) {
+        module->uniform_ids_[name_id(name)] = location;
+        //NOTE: arrays are also reachable by their bare name, as glGetUniformLocation allows
+        if (name.ends_with("[0]")) {
+            module->uniform_ids_[name_id(std::string_view(name).substr(0, name.size() - 3))] = location;
+        }
+        module->uniform_location_cache_.try_emplace(std::move(name), location);
+    }
+
     log::Info("Shader module created (program: {}, stages: {})", module->program_id_,
               stages_.size());
 
@@ -158,6 +172,11 @@ i32 ShaderModule::GetUniformLocation(const std::string& name) const {
     return location;
 }
 
+i32 ShaderModule::GetUniformLocation(name_id name) const noexcept {
+    auto it = uniform_ids_.find(name);
+    return it != uniform_ids_.end() ? it->second : -1;
+}
+
 i32 ShaderModule::GetAttributeLocation(const std::string& name) const {
     return glGetAttribLocation(program_id_, name.c_str());
 }
@@ -78,13 +78,13 @@ auto ShaderReflector::Create() -> result<ref<ShaderReflector>> {
     return ok(reflector);
 }
 
-auto ShaderReflector::Reflect(const std::vector<u32>& spirv, ShaderStage stage)
-    -> result<ShaderReflection> {
+auto ShaderReflector::Reflect(const std::vector<u32>& spirv, ShaderStage stage,
+                              std::pmr::memory_resource* resource) -> result<ShaderReflection> {
     if (spirv.empty()) {
         return err(error_code::validation_invalid_state, "SPIR-V data is empty");
     }
 
-    ShaderReflection reflection;
+    ShaderReflection reflection(resource);
 
     try {
         spirv_cross::Compiler compiler(spirv);
@@ -120,7 +120,7 @@ auto ShaderReflector::Reflect(const std::vector<u32>& spirv, ShaderStage stage)
                 var.size = GetUniformSize(var.type);
 
                 reflection.uniforms.push_back(var);
-                reflection.uniform_locations[var.name] = var.location;
+                reflection.uniform_locations[name_id(var.name)] = var.location;
             }
         }
 
@@ -135,7 +135,7 @@ auto ShaderReflector::Reflect(const std::vector<u32>& spirv, ShaderStage stage)
             var.size = 0;
 
             reflection.samplers.push_back(var);
-            reflection.sampler_bindings[var.name] = var.binding;
+            reflection.sampler_bindings[name_id(var.name)] = var.binding;
         }
 
         log::Info("Shader reflection: {}", stage == ShaderStage::Vertex     ? "Vertex"
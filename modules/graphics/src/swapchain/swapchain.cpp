@@ -2,12 +2,21 @@
 #include "cbox/graphics/window/window.hpp"
 #include "cbox/graphics/context/context.hpp"
 #include "../../backends/gl/framebuffer/framebuffer.hpp"
+#include "../metrics.hpp"
 #include "cbox/core/core.hpp"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 namespace cc {
 
+//NOTE: draw calls per frame are the delta of the global draw counter between two presents
+static void RecordFrameMetrics(u64& last_draw_calls) {
+    u64 total = DrawCallCounter().value();
+    DrawCallsPerFrame().record(total - last_draw_calls);
+    last_draw_calls = total;
+    FrameCounter().add();
+}
+
 Swapchain::~Swapchain() {
     framebuffer_.reset();
     window_.reset();
@@ -85,11 +94,21 @@ void Swapchain::Clear(const ClearColor& color, f32 depth) {
 }
 
 void Swapchain::Present() {
-    glfwSwapBuffers(window_->GetNativeWindow());
+    {
+        CC_PROFILE_SCOPE("Swapchain::Present");
+        glfwSwapBuffers(window_->GetNativeWindow());
+    }
+    RecordFrameMetrics(last_draw_calls_);
+    CC_PROFILE_FRAME();
 }
 
 void Swapchain::Present(const ref<CommandBuffer>& cmd) {
-    glfwSwapBuffers(window_->GetNativeWindow());
+    {
+        CC_PROFILE_SCOPE("Swapchain::Present");
+        glfwSwapBuffers(window_->GetNativeWindow());
+    }
+    RecordFrameMetrics(last_draw_calls_);
+    CC_PROFILE_FRAME();
 }
 
 u32 Swapchain::GetWidth() const noexcept {
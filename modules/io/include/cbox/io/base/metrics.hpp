@@ -0,0 +1,12 @@
+#pragma once
+#include <cbox/core/metrics.hpp>
+
+namespace cc::io::metric {
+
+//NOTE: each io series is registered in one place, call sites use these accessors instead of
+// repeating the name and help strings
+[[nodiscard]] cc::metrics::counter& observations_read();
+[[nodiscard]] cc::metrics::histogram& scene_load_time();
+[[nodiscard]] cc::metrics::histogram& dense_scene_load_time();
+
+} // namespace cc::io::metric
@@ -3,11 +3,54 @@
 #include <cbox/core/core.hpp>
 #include <span>
 #include <array>
+#include <algorithm>
+#include <bit>
 #include <cstring>
+#include <limits>
+#include <vector>
 
 
 namespace cc::io{
 
+template<typename T>
+concept seekable = requires(T t, const T ct, size_t pos) {
+    t.seek(pos);
+    { ct.tell() } -> std::convertible_to<size_t>;
+    { ct.size() } -> std::convertible_to<size_t>;
+};
+
+//NOTE: types whose bytes can be swapped scalar by scalar, plain arithmetic values or
+// aggregates of one arithmetic value_type such as vec3f
+template<typename T>
+concept endian_swappable = cc::trivially_copyable<T> && (
+    std::is_arithmetic_v<T> ||
+    requires { typename T::value_type; } &&
+    std::is_arithmetic_v<typename T::value_type> && sizeof(T) % sizeof(typename T::value_type) == 0);
+
+namespace detail {
+
+template<endian_swappable T>
+consteval size_t swap_unit() noexcept {
+    if constexpr (std::is_arithmetic_v<T>) {
+        return sizeof(T);
+    } else {
+        return sizeof(typename T::value_type);
+    }
+}
+
+template<endian_swappable T>
+void byteswap_array(std::span<T> values) noexcept {
+    constexpr size_t unit = swap_unit<T>();
+    if constexpr (unit > 1) {
+        auto bytes = std::as_writable_bytes(values);
+        for (size_t i = 0; i < bytes.size(); i += unit) {
+            std::reverse(bytes.data() + i, bytes.data() + i + unit);
+        }
+    }
+}
+
+} // namespace detail
+
 //NOTE: implements a CRTP base class for derived classes writer and reader ... from core concepts
 template <typename Derived>
 class sbase{
@@ -17,7 +60,7 @@ protected:
     }
 
     constexpr const Derived& self()const noexcept {
-        return static_cast<Derived&>(*this);
+        return static_cast<const Derived&>(*this);
     }
 public:
 
@@ -63,6 +106,152 @@ public:
         return cc::ok();
     }
 
+    //NOTE: bulk variants move the whole span in a single read()/write() call
+    template<cc::trivially_copyable T>
+    [[nodiscard]] cc::result<void> read_array(std::span<T> out) {
+        auto bytes = std::as_writable_bytes(out);
+        if (read(bytes) != bytes.size()) {
+            return cc::err(cc::error_code::file_eof, "Incomplete read");
+        }
+        return cc::ok();
+    }
+
+    template<cc::trivially_copyable T>
+    [[nodiscard]] cc::result<void> write_array(std::span<const T> data) {
+        auto bytes = std::as_bytes(data);
+        if (write(bytes) != bytes.size()) {
+            return cc::err(cc::error_code::file_write_error, "Write failed");
+        }
+        return cc::ok();
+    }
+
+    //NOTE: vectors are prefixed with their element count as u64
+    template<cc::trivially_copyable T>
+    [[nodiscard]] cc::result<void> read_vector(std::vector<T>& out) {
+        auto count = read_binary<u64>();
+        if (!count) {
+            return cc::err(count.error());
+        }
+        if (auto res = check_length<T>(*count); !res) {
+            return res;
+        }
+
+        out.resize(static_cast<size_t>(*count));
+        return read_array(std::span<T>(out));
+    }
+
+    template<cc::trivially_copyable T>
+    [[nodiscard]] cc::result<std::vector<T>> read_vector() {
+        std::vector<T> out;
+        if (auto res = read_vector(out); !res) {
+            return cc::err(res.error());
+        }
+        return out;
+    }
+
+    template<cc::trivially_copyable T>
+    [[nodiscard]] cc::result<void> write_vector(std::span<const T> data) {
+        if (auto res = write_binary(static_cast<u64>(data.size())); !res) {
+            return res;
+        }
+        return write_array(data);
+    }
+
+    //NOTE: endian tagged variants, `order` is the byte order of the data in the stream.
+    // Matching the native order costs nothing over the untagged calls
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<T> read_binary(std::endian order) {
+        auto value = read_binary<T>();
+        if (value && order != std::endian::native) {
+            detail::byteswap_array(std::span<T>(&*value, 1));
+        }
+        return value;
+    }
+
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<void> write_binary(const T& value, std::endian order) {
+        if (order == std::endian::native) {
+            return write_binary(value);
+        }
+        T swapped = value;
+        detail::byteswap_array(std::span<T>(&swapped, 1));
+        return write_binary(swapped);
+    }
+
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<void> read_array(std::span<T> out, std::endian order) {
+        if (auto res = read_array(out); !res) {
+            return res;
+        }
+        if (order != std::endian::native) {
+            detail::byteswap_array(out);
+        }
+        return cc::ok();
+    }
+
+    //NOTE: swaps through a fixed stack chunk so foreign order writes stay allocation free
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<void> write_array(std::span<const T> data, std::endian order) {
+        if (order == std::endian::native) {
+            return write_array(data);
+        }
+
+        constexpr size_t chunk = std::max<size_t>(1, 4096 / sizeof(T));
+        std::array<T, chunk> buffer;
+        while (!data.empty()) {
+            size_t count = std::min(chunk, data.size());
+            std::copy_n(data.begin(), count, buffer.begin());
+            detail::byteswap_array(std::span<T>(buffer.data(), count));
+            if (auto res = write_array(std::span<const T>(buffer.data(), count)); !res) {
+                return res;
+            }
+            data = data.subspan(count);
+        }
+        return cc::ok();
+    }
+
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<void> read_vector(std::vector<T>& out, std::endian order) {
+        auto count = read_binary<u64>(order);
+        if (!count) {
+            return cc::err(count.error());
+        }
+        if (auto res = check_length<T>(*count); !res) {
+            return res;
+        }
+
+        out.resize(static_cast<size_t>(*count));
+        return read_array(std::span<T>(out), order);
+    }
+
+    template<endian_swappable T>
+    [[nodiscard]] cc::result<void> write_vector(std::span<const T> data, std::endian order) {
+        if (auto res = write_binary(static_cast<u64>(data.size()), order); !res) {
+            return res;
+        }
+        return write_array(data, order);
+    }
+
+private:
+    //NOTE: rejects corrupt length prefixes before they turn into huge allocations
+    template<typename T>
+    [[nodiscard]] cc::result<void> check_length(u64 count) const {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Vector length overflow");
+        }
+        if constexpr (seekable<Derived>) {
+            //NOTE: a failed tellg comes back as size_t(-1), past any size
+            size_t pos = self().tell();
+            size_t total = self().size();
+            if (pos > total) {
+                return cc::err(cc::error_code::file_read_error, "Stream position unavailable");
+            }
+            if (count > (total - pos) / sizeof(T)) {
+                return cc::err(cc::error_code::parse_invalid_format, "Vector length exceeds stream size");
+            }
+        }
+        return cc::ok();
+    }
 };
 
 
@@ -0,0 +1,25 @@
+#pragma once
+#include <cbox/core/core.hpp>
+#include <span>
+
+namespace cc::io {
+
+//NOTE: byte oriented LZ77 codec in the LZ4 family. A block is a list of sequences:
+//  token (literal length << 4 | match length - 4), extra literal length bytes, literals,
+//  u16 little endian match offset, extra match length bytes
+// Lengths of 15 continue in following bytes, each 255 adds and ends on a smaller byte. The last
+// sequence only carries literals. Blocks are independent, matches never reach outside of them
+inline constexpr size_t lz_min_match = 4;
+inline constexpr size_t lz_max_offset = 65535;
+
+[[nodiscard]] constexpr size_t lz_compress_bound(size_t size) noexcept {
+    return size + size / 255 + 16;
+}
+
+//NOTE: `dst` needs lz_compress_bound(src.size()) bytes, returns the compressed size
+[[nodiscard]] size_t lz_compress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept;
+
+//NOTE: fully bounds checked, returns the decompressed size or parse_invalid_format
+[[nodiscard]] cc::result<size_t> lz_decompress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept;
+
+} // namespace cc::io
@@ -3,8 +3,17 @@
 // IWYU pragma: begin_exports
 #include "base/sbase.hpp"
 #include "scene/scene.hpp"
+#include "scene/reader.hpp"
+#include "scene/dense.hpp"
+#include "scene/binary.hpp"
+#include "scene/sequence.hpp"
+#include "scene/serialize.hpp"
 #include "scene/parser.hpp"
 #include "stream/fstream.hpp"
+#include "stream/buffered_stream.hpp"
+#include "stream/mmap_stream.hpp"
+#include "stream/async_stream.hpp"
+#include "stream/compressed_stream.hpp"
 // IWYU pragma: end_exports
 
 
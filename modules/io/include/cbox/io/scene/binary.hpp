@@ -0,0 +1,119 @@
+#pragma once
+#include "dense.hpp"
+#include "../stream/fstream.hpp"
+#include "../stream/mmap_stream.hpp"
+#include <cbox/core/core.hpp>
+#include <array>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace cc::io {
+
+//NOTE: .scnb layout, little endian:
+//  scnb_header | section table | sections, each section starts on a scnb_alignment boundary
+//  names:      u32 offsets[cameras + markers + 1], then the name bytes (cameras first)
+//  intrinsics: f32[cameras][4] as fx, fy, cx, cy
+//  offsets:    u32[cameras + 1], CSR ranges into the observation columns
+//  marker_ids: u32[observations]
+//  u, v:       f32[observations]
+inline constexpr std::array<char, 4> scnb_magic{'S', 'C', 'N', 'B'};
+inline constexpr u16 scnb_version = 1;
+inline constexpr u16 scnb_endian_tag = 0x0102;
+inline constexpr size_t scnb_alignment = 64;
+
+enum class scnb_section_kind : u32 {
+    names = 0,
+    intrinsics = 1,
+    offsets = 2,
+    marker_ids = 3,
+    u = 4,
+    v = 5,
+    count
+};
+
+struct scnb_section {
+    scnb_section_kind kind{};
+    u32 reserved{0};
+    u64 offset{0};
+    u64 size{0};
+};
+
+struct scnb_header {
+    std::array<char, 4> magic{scnb_magic};
+    u16 version{scnb_version};
+    u16 endian{scnb_endian_tag};
+    u32 camera_count{0};
+    u32 marker_count{0};
+    u64 observation_count{0};
+    u32 section_count{static_cast<u32>(scnb_section_kind::count)};
+    u32 reserved{0};
+    std::array<scnb_section, static_cast<size_t>(scnb_section_kind::count)> sections{};
+};
+
+static_assert(std::is_trivially_copyable_v<scnb_header>);
+
+//NOTE: zero-copy view over a .scnb image, spans point straight into the source bytes. open()
+// checks every name offset, CSR offset and marker id once, the accessors then index unchecked
+class scnb_view {
+public:
+    [[nodiscard]] static cc::result<scnb_view> open(std::span<const std::byte> image);
+
+    [[nodiscard]] size_t camera_count() const noexcept { return header_.camera_count; }
+    [[nodiscard]] size_t marker_count() const noexcept { return header_.marker_count; }
+    [[nodiscard]] size_t observation_count() const noexcept { return u_.size(); }
+
+    [[nodiscard]] std::string_view camera_name(camera_id id) const noexcept;
+    [[nodiscard]] std::string_view marker_name(marker_id id) const noexcept;
+
+    [[nodiscard]] std::span<const f32, 4> intrinsics_of(camera_id id) const noexcept {
+        return std::span<const f32, 4>(intrinsics_.data() + id * 4, 4);
+    }
+
+    [[nodiscard]] camera_view camera(camera_id id) const noexcept;
+
+    [[nodiscard]] std::span<const u32> offsets() const noexcept { return offsets_; }
+    [[nodiscard]] std::span<const marker_id> marker_ids() const noexcept { return marker_ids_; }
+    [[nodiscard]] std::span<const f32> u() const noexcept { return u_; }
+    [[nodiscard]] std::span<const f32> v() const noexcept { return v_; }
+
+    [[nodiscard]] cc::result<dense_scene> to_dense() const;
+
+private:
+    scnb_header header_{};
+    std::span<const u32> name_offsets_;
+    std::string_view name_bytes_;
+    std::span<const f32> intrinsics_;
+    std::span<const u32> offsets_;
+    std::span<const marker_id> marker_ids_;
+    std::span<const f32> u_;
+    std::span<const f32> v_;
+};
+
+//NOTE: memory maps a .scnb file and keeps the mapping alive for the view
+class scnb_file {
+public:
+    [[nodiscard]] static cc::result<scnb_file> open(const std::filesystem::path& path);
+
+    [[nodiscard]] const scnb_view& view() const noexcept { return view_; }
+    [[nodiscard]] const scnb_view* operator->() const noexcept { return &view_; }
+
+private:
+    scnb_file(mmap_stream&& stream, const scnb_view& view)
+    : stream_(std::move(stream)), view_(view) {}
+
+    mmap_stream stream_;
+    scnb_view view_;
+};
+
+[[nodiscard]] cc::result<void> write_scnb(const dense_scene& scene, fstream& out);
+[[nodiscard]] cc::result<void> write_scn(const dense_scene& scene, fstream& out);
+
+[[nodiscard]] cc::result<void> save_scnb(const dense_scene& scene, const std::filesystem::path& path);
+[[nodiscard]] cc::result<void> save_scn(const dense_scene& scene, const std::filesystem::path& path);
+
+[[nodiscard]] cc::result<void> convert_scn_to_scnb(const std::filesystem::path& src, const std::filesystem::path& dst);
+[[nodiscard]] cc::result<void> convert_scnb_to_scn(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+} // namespace cc::io
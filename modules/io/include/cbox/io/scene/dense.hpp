@@ -0,0 +1,149 @@
+#pragma once
+#include "scene.hpp"
+#include "reader.hpp"
+#include <cbox/core/core.hpp>
+#include <cbox/math/math.hpp>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cc::io {
+
+class dense_scene_builder;
+
+using camera_id = u32;
+using marker_id = u32;
+
+inline constexpr u32 invalid_id = ~u32{0};
+
+//NOTE: maps names to dense ids in insertion order, each distinct name is stored once
+class interner {
+public:
+    interner() = default;
+    interner(const interner& other);
+    interner& operator=(const interner& other);
+    interner(interner&&) noexcept = default;
+    interner& operator=(interner&&) noexcept = default;
+
+    [[nodiscard]] u32 intern(std::string_view name);
+    [[nodiscard]] u32 find(std::string_view name) const noexcept;
+
+    [[nodiscard]] std::string_view name(u32 id) const noexcept {
+        return id < names_.size() ? std::string_view(*names_[id]) : std::string_view{};
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return names_.size(); }
+
+    void reserve(size_t count);
+    void clear() noexcept;
+
+private:
+    std::unordered_map<std::string, u32, string_hash, std::equal_to<>> ids_;
+    std::vector<const std::string*> names_;
+};
+
+//NOTE: observations of one camera, the three columns are parallel and unit stride
+struct camera_view {
+    camera_id id{invalid_id};
+    std::span<const marker_id> markers;
+    std::span<const f32> u;
+    std::span<const f32> v;
+
+    [[nodiscard]] size_t size() const noexcept { return markers.size(); }
+    [[nodiscard]] bool empty() const noexcept { return markers.empty(); }
+
+    [[nodiscard]] bool is_visible(size_t i) const noexcept {
+        return u[i] >= 0.0f && v[i] >= 0.0f;
+    }
+};
+
+//NOTE: struct-of-arrays scene: intrinsics are per camera columns, observations are stored
+// camera after camera (CSR) with offsets_[c]..offsets_[c + 1] covering camera c
+class dense_scene {
+public:
+    dense_scene() = default;
+
+    [[nodiscard]] cc::result<camera_id> add_camera(std::string_view name, f32 fx, f32 fy, f32 cx, f32 cy);
+
+    //NOTE: observations always go to the most recently added camera
+    [[nodiscard]] cc::result<void> add_observation(marker_id marker, f32 u, f32 v);
+    [[nodiscard]] cc::result<void> add_observation(std::string_view marker, f32 u, f32 v);
+
+    void set_intrinsics(camera_id id, f32 fx, f32 fy, f32 cx, f32 cy) noexcept;
+
+    [[nodiscard]] size_t camera_count() const noexcept { return fx_.size(); }
+    [[nodiscard]] size_t marker_count() const noexcept { return markers_.size(); }
+    [[nodiscard]] size_t observation_count() const noexcept { return marker_ids_.size(); }
+
+    [[nodiscard]] camera_id find_camera(std::string_view name) const noexcept { return cameras_.find(name); }
+    [[nodiscard]] marker_id find_marker(std::string_view name) const noexcept { return markers_.find(name); }
+    [[nodiscard]] marker_id intern_marker(std::string_view name) { return markers_.intern(name); }
+
+    [[nodiscard]] std::string_view camera_name(camera_id id) const noexcept { return cameras_.name(id); }
+    [[nodiscard]] std::string_view marker_name(marker_id id) const noexcept { return markers_.name(id); }
+
+    [[nodiscard]] camera_view camera(camera_id id) const noexcept;
+    [[nodiscard]] intrinsics camera_intrinsics(camera_id id) const;
+    [[nodiscard]] pinhole<f32> camera_pinhole(camera_id id) const noexcept;
+
+    [[nodiscard]] std::span<const f32> fx() const noexcept { return fx_; }
+    [[nodiscard]] std::span<const f32> fy() const noexcept { return fy_; }
+    [[nodiscard]] std::span<const f32> cx() const noexcept { return cx_; }
+    [[nodiscard]] std::span<const f32> cy() const noexcept { return cy_; }
+
+    [[nodiscard]] std::span<const u32> offsets() const noexcept { return offsets_; }
+    [[nodiscard]] std::span<const marker_id> marker_ids() const noexcept { return marker_ids_; }
+    [[nodiscard]] std::span<const f32> u() const noexcept { return u_; }
+    [[nodiscard]] std::span<const f32> v() const noexcept { return v_; }
+
+    [[nodiscard]] const interner& camera_names() const noexcept { return cameras_; }
+    [[nodiscard]] const interner& marker_names() const noexcept { return markers_; }
+
+    void reserve(size_t cameras, size_t observations);
+    void clear() noexcept;
+
+    [[nodiscard]] static cc::result<dense_scene> from_scene(const scene& src);
+    [[nodiscard]] scene to_scene(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+private:
+    interner cameras_;
+    interner markers_;
+
+    std::vector<f32> fx_;
+    std::vector<f32> fy_;
+    std::vector<f32> cx_;
+    std::vector<f32> cy_;
+
+    std::vector<u32> offsets_{0};
+    std::vector<marker_id> marker_ids_;
+    std::vector<f32> u_;
+    std::vector<f32> v_;
+
+    friend class dense_scene_builder;
+};
+
+//NOTE: scn_reader handler that fills a dense_scene directly from the text records
+class dense_scene_builder {
+public:
+    explicit dense_scene_builder(dense_scene& out) noexcept
+    : scene_(out) {}
+
+    [[nodiscard]] cc::result<void> operator()(const scn_record& record);
+
+private:
+    dense_scene& scene_;
+    camera_id camera_{invalid_id};
+};
+
+//NOTE: projects every marker into every camera with the batch kernels. `positions` is indexed by
+// marker id and `world_to_camera` holds one pose per camera, since the scene itself stores neither.
+// out[c] gets the pixels of all markers in camera c, NaN where a marker is behind it
+[[nodiscard]] cc::result<void> reproject_markers(const dense_scene& scene, std::span<const mat4f> world_to_camera,
+                                                 const points3f& positions, std::vector<points2f>& out);
+
+[[nodiscard]] cc::result<dense_scene> load_dense_scene(const std::filesystem::path& path);
+
+} // namespace cc::io
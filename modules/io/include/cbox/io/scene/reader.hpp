@@ -0,0 +1,158 @@
+#pragma once
+#include "scene.hpp"
+#include "../base/sbase.hpp"
+#include <cbox/core/core.hpp>
+#include <concepts>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace cc::io {
+
+enum class scn_tag : u8 {
+    none,
+    camera,
+    fx,
+    fy,
+    cx,
+    cy,
+    uv
+};
+
+//NOTE: `name` points into the parsed buffer and is only valid for the duration of the handler call
+struct scn_record {
+    scn_tag tag{scn_tag::none};
+    std::string_view name;
+    f32 x{0.0f};
+    f32 y{0.0f};
+};
+
+[[nodiscard]] cc::result<scn_record> parse_scn_line(std::string_view line) noexcept;
+
+template<typename H>
+concept scn_handler = std::invocable<H&, const scn_record&>;
+
+//NOTE: streaming .scn reader, lines are split in place and handed out as views, the only
+// allocation is the block buffer made once per reader
+class scn_reader {
+public:
+    static constexpr size_t default_block_size = 1 << 20;
+
+    explicit scn_reader(size_t block_size = default_block_size)
+    : buffer_(block_size) {}
+
+    template<scn_handler H>
+    [[nodiscard]] cc::result<void> parse(std::string_view text, H&& handler) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+
+        while (p < end) {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* line_end = nl ? nl : end;
+            ++line_;
+
+            auto record = parse_scn_line({p, static_cast<size_t>(line_end - p)});
+            if (!record) {
+                return cc::err(at_line(record.error()));
+            }
+
+            if (record->tag != scn_tag::none) {
+                if (auto res = dispatch(handler, *record); !res) {
+                    return cc::err(at_line(res.error()));
+                }
+            }
+
+            p = nl ? nl + 1 : end;
+        }
+        return cc::ok();
+    }
+
+    template<scn_handler H>
+    [[nodiscard]] cc::result<void> parse(std::span<const std::byte> bytes, H&& handler) {
+        return parse(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()),
+                     std::forward<H>(handler));
+    }
+
+    template<typename S, scn_handler H>
+    [[nodiscard]] cc::result<void> parse_stream(sbase<S>& stream, H&& handler) {
+        if (!stream.is_open()) {
+            return cc::err(cc::error_code::file_read_error, "Stream is not open");
+        }
+
+        size_t carry = 0;
+        for (;;) {
+            auto space = std::as_writable_bytes(std::span(buffer_)).subspan(carry);
+            size_t bytes_read = stream.read(space);
+            size_t filled = carry + bytes_read;
+            std::string_view chunk(buffer_.data(), filled);
+
+            if (bytes_read == 0) {
+                return parse(chunk, handler);
+            }
+
+            size_t last_nl = chunk.rfind('\n');
+            if (last_nl == std::string_view::npos) {
+                if (filled == buffer_.size()) {
+                    return cc::err(cc::error(cc::error_code::parse_invalid_format,
+                                             std::format("line {}: exceeds reader block size", line_ + 1)));
+                }
+                carry = filled;
+                continue;
+            }
+
+            if (auto res = parse(chunk.substr(0, last_nl + 1), handler); !res) {
+                return res;
+            }
+
+            carry = filled - (last_nl + 1);
+            std::memmove(buffer_.data(), buffer_.data() + last_nl + 1, carry);
+        }
+    }
+
+    [[nodiscard]] size_t line() const noexcept { return line_; }
+    void reset() noexcept { line_ = 0; }
+
+private:
+    //NOTE: the same error with the 1-based number of the line being parsed in front of its message
+    [[nodiscard]] cc::error at_line(const cc::error& e) const {
+        return cc::error(e.code(), std::format("line {}: {}", line_, e.message()), e.location());
+    }
+
+    template<typename H>
+    static cc::result<void> dispatch(H& handler, const scn_record& record) {
+        if constexpr (std::same_as<std::invoke_result_t<H&, const scn_record&>, cc::result<void>>) {
+            return std::invoke(handler, record);
+        } else {
+            std::invoke(handler, record);
+            return cc::ok();
+        }
+    }
+
+    std::vector<char> buffer_;
+    size_t line_{0};
+};
+
+//NOTE: handler that fills a cc::io::scene, records must follow their camera line
+class scene_builder {
+public:
+    explicit scene_builder(scene& out) noexcept
+    : scene_(out) {}
+
+    [[nodiscard]] cc::result<void> operator()(const scn_record& record);
+
+private:
+    scene& scene_;
+    intrinsics* camera_{nullptr};
+    scene::uv_list* uvs_{nullptr};
+};
+
+[[nodiscard]] cc::result<scene> parse_scene(std::string_view text,
+                                            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+[[nodiscard]] cc::result<scene> load_scene(const std::filesystem::path& path,
+                                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+} // namespace cc::io
@@ -1,14 +1,18 @@
 #pragma once
 #include <cbox/math/math.hpp>
 #include <cbox/core/core.hpp>
+#include <functional>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <span>
 #include <algorithm>
 
 namespace cc::io {
 
+using cc::string_hash;
+
 struct intrinsics {
     std::string name;
     f32 fx{0.0f};
@@ -35,11 +39,28 @@ struct uv {
     }
 };
 
+//NOTE: containers draw from the memory resource given at construction, pass an arena to load a
+// scene in a handful of upstream allocations. Names longer than the small string buffer still
+// use the global heap
 class scene {
-    std::vector<intrinsics> cameras_;
-    std::unordered_map<std::string, std::vector<uv>> camera_uvs_;
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using camera_list = std::pmr::vector<intrinsics>;
+    using uv_list = std::pmr::vector<uv>;
+    using uv_map = cc::pmr::hash_map<std::string, uv_list>;
+
+private:
+    camera_list cameras_;
+    uv_map camera_uvs_;
 
 public:
+    scene() noexcept : scene(allocator_type{}) {}
+
+    explicit scene(allocator_type alloc) noexcept
+    : cameras_(alloc), camera_uvs_(alloc) {}
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return cameras_.get_allocator(); }
+
     [[nodiscard]] auto& cameras() noexcept { return cameras_; }
     [[nodiscard]] const auto& cameras() const noexcept { return cameras_; }
 
@@ -52,7 +73,7 @@ public:
     }
 
     [[nodiscard]] std::span<const uv> uvs_for_camera(std::string_view name) const noexcept {
-        auto it = camera_uvs_.find(std::string(name));
+        auto it = camera_uvs_.find(name);
         return it != camera_uvs_.end() ? std::span{it->second} : std::span<const uv>{};
     }
 
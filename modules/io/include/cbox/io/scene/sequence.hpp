@@ -0,0 +1,462 @@
+#pragma once
+#include "dense.hpp"
+#include "../base/metrics.hpp"
+#include "../base/sbase.hpp"
+#include <cbox/core/core.hpp>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace cc::io {
+
+//NOTE: .scnq layout, little endian:
+//  scnq_header | frame records | dictionary | frame index | scnq_footer
+//  frame record: scnq_frame_header, u32 offsets[cameras + 1], u32 markers[n], f32 u[n], f32 v[n]
+//  dictionary:   u32 camera_count, u32 marker_count, u32 name_offsets[cameras + markers + 1],
+//                name bytes (cameras first), f32 intrinsics[cameras][4]
+//  frame index:  u64 record_offsets[frames]
+inline constexpr std::array<char, 4> scnq_magic{'S', 'C', 'N', 'Q'};
+inline constexpr u16 scnq_version = 1;
+inline constexpr u16 scnq_endian_tag = 0x0102;
+
+struct scnq_header {
+    std::array<char, 4> magic{scnq_magic};
+    u16 version{scnq_version};
+    u16 endian{scnq_endian_tag};
+    u64 reserved{0};
+};
+
+struct scnq_frame_header {
+    u64 timestamp{0};
+    u32 camera_count{0};
+    u32 observation_count{0};
+};
+
+struct scnq_footer {
+    u64 dictionary_offset{0};
+    u64 index_offset{0};
+    u64 frame_count{0};
+    u16 version{scnq_version};
+    u16 endian{scnq_endian_tag};
+    std::array<char, 4> magic{scnq_magic};
+};
+
+//NOTE: one decoded frame in the same CSR layout as dense_scene, buffers keep their capacity
+// so decoding frame after frame into the same object stops allocating after warm up
+struct sequence_frame {
+    u64 timestamp{0};
+    std::vector<u32> offsets{0};
+    std::vector<marker_id> markers;
+    std::vector<f32> u;
+    std::vector<f32> v;
+
+    [[nodiscard]] size_t camera_count() const noexcept { return offsets.size() - 1; }
+    [[nodiscard]] size_t observation_count() const noexcept { return markers.size(); }
+
+    [[nodiscard]] camera_view camera(camera_id id) const noexcept {
+        if (id >= camera_count()) {
+            return {};
+        }
+        size_t begin = offsets[id];
+        size_t count = offsets[id + 1] - begin;
+        return {
+            id,
+            std::span(markers).subspan(begin, count),
+            std::span(u).subspan(begin, count),
+            std::span(v).subspan(begin, count),
+        };
+    }
+
+    void resize(size_t cameras, size_t observations) {
+        offsets.resize(cameras + 1);
+        markers.resize(observations);
+        u.resize(observations);
+        v.resize(observations);
+    }
+};
+
+//NOTE: appends frames to any writer, the dictionary and the frame index are written by finish()
+template<typename S>
+requires std::derived_from<S, sbase<S>>
+class sequence_writer {
+public:
+    sequence_writer(S& stream, std::span<const intrinsics> cameras)
+    : stream_(&stream), cameras_(cameras.begin(), cameras.end()) {
+        scnq_header header;
+        if (!stream_->write_binary(header)) {
+            failed_ = true;
+        }
+        offset_ = sizeof(scnq_header);
+    }
+
+    ~sequence_writer() {
+        if (!finished_) {
+            if (auto res = finish(); !res) {
+                res.error().log();
+            }
+        }
+    }
+
+    sequence_writer(const sequence_writer&) = delete;
+    sequence_writer& operator=(const sequence_writer&) = delete;
+
+    [[nodiscard]] marker_id intern_marker(std::string_view name) { return markers_.intern(name); }
+
+    [[nodiscard]] size_t frame_count() const noexcept { return index_.size(); }
+
+    [[nodiscard]] cc::result<void> write_frame(const sequence_frame& frame) {
+        if (failed_ || finished_) {
+            return cc::err(cc::error_code::validation_invalid_state, "Sequence writer is not writable");
+        }
+        if (frame.camera_count() != cameras_.size() || frame.offsets.back() != frame.observation_count()) {
+            return cc::err(cc::error_code::validation_invalid_state, "Frame does not match sequence cameras");
+        }
+
+        scnq_frame_header header{
+            frame.timestamp,
+            static_cast<u32>(frame.camera_count()),
+            static_cast<u32>(frame.observation_count()),
+        };
+
+        bool ok = stream_->write_binary(header) &&
+                  stream_->write_array(std::span<const u32>(frame.offsets)) &&
+                  stream_->write_array(std::span<const marker_id>(frame.markers)) &&
+                  stream_->write_array(std::span<const f32>(frame.u)) &&
+                  stream_->write_array(std::span<const f32>(frame.v));
+        if (!ok) {
+            failed_ = true;
+            return cc::err(cc::error_code::file_write_error, "Failed to write sequence frame");
+        }
+
+        index_.push_back(offset_);
+        offset_ += sizeof(scnq_frame_header) + frame.offsets.size() * sizeof(u32) +
+                   frame.observation_count() * (sizeof(marker_id) + 2 * sizeof(f32));
+        return cc::ok();
+    }
+
+    //NOTE: cameras are matched by position, markers are remapped into the sequence dictionary by name
+    [[nodiscard]] cc::result<void> write_frame(u64 timestamp, const dense_scene& scene) {
+        if (scene.camera_count() != cameras_.size()) {
+            return cc::err(cc::error_code::validation_invalid_state, "Frame does not match sequence cameras");
+        }
+
+        remap_.resize(scene.marker_count());
+        for (marker_id m = 0; m < scene.marker_count(); ++m) {
+            remap_[m] = markers_.intern(scene.marker_name(m));
+        }
+
+        scratch_.timestamp = timestamp;
+        scratch_.offsets.assign(scene.offsets().begin(), scene.offsets().end());
+        scratch_.markers.resize(scene.observation_count());
+        for (size_t i = 0; i < scene.observation_count(); ++i) {
+            scratch_.markers[i] = remap_[scene.marker_ids()[i]];
+        }
+        scratch_.u.assign(scene.u().begin(), scene.u().end());
+        scratch_.v.assign(scene.v().begin(), scene.v().end());
+        return write_frame(scratch_);
+    }
+
+    [[nodiscard]] cc::result<void> finish() {
+        if (finished_) {
+            return cc::ok();
+        }
+        finished_ = true;
+        if (failed_) {
+            return cc::err(cc::error_code::file_write_error, "Sequence writer failed earlier");
+        }
+
+        scnq_footer footer;
+        footer.dictionary_offset = offset_;
+        footer.frame_count = index_.size();
+
+        std::array<u32, 2> counts{static_cast<u32>(cameras_.size()), static_cast<u32>(markers_.size())};
+        std::vector<u32> name_offsets{0};
+        std::string names;
+        std::vector<f32> params;
+        params.reserve(cameras_.size() * 4);
+        for (const auto& cam : cameras_) {
+            names += cam.name;
+            name_offsets.push_back(static_cast<u32>(names.size()));
+            params.insert(params.end(), {cam.fx, cam.fy, cam.cx, cam.cy});
+        }
+        for (marker_id m = 0; m < markers_.size(); ++m) {
+            names += markers_.name(m);
+            name_offsets.push_back(static_cast<u32>(names.size()));
+        }
+
+        footer.index_offset = footer.dictionary_offset + sizeof(counts) + name_offsets.size() * sizeof(u32) +
+                              names.size() + params.size() * sizeof(f32);
+
+        bool ok = stream_->write_array(std::span<const u32>(counts)) &&
+                  stream_->write_array(std::span<const u32>(name_offsets)) &&
+                  stream_->write_array(std::span<const char>(names)) &&
+                  stream_->write_array(std::span<const f32>(params)) &&
+                  stream_->write_array(std::span<const u64>(index_)) &&
+                  stream_->write_binary(footer);
+        if (!ok) {
+            failed_ = true;
+            return cc::err(cc::error_code::file_write_error, "Failed to write sequence index");
+        }
+
+        stream_->flush();
+        return cc::ok();
+    }
+
+private:
+    S* stream_;
+    std::vector<intrinsics> cameras_;
+    interner markers_;
+    std::vector<u64> index_;
+    u64 offset_{0};
+    bool failed_{false};
+    bool finished_{false};
+
+    std::vector<marker_id> remap_;
+    sequence_frame scratch_;
+};
+
+//NOTE: random access over a .scnq stream, only the dictionary and the frame index stay resident
+template<typename S>
+requires std::derived_from<S, sbase<S>> && seekable<S>
+class sequence_reader {
+public:
+    [[nodiscard]] static cc::result<sequence_reader> open(S& stream) {
+        sequence_reader reader(stream);
+
+        scnq_header header;
+        stream.seek(0);
+        if (!stream.read_array(std::span<scnq_header>(&header, 1)) || header.magic != scnq_magic) {
+            return cc::err(cc::error_code::parse_invalid_format, "Not a .scnq stream");
+        }
+        if (header.endian != scnq_endian_tag || header.version == 0 || header.version > scnq_version) {
+            return cc::err(cc::error_code::parse_invalid_format, "Unsupported .scnq version");
+        }
+
+        size_t size = stream.size();
+        scnq_footer footer;
+        if (size < sizeof(scnq_header) + sizeof(scnq_footer)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnq stream");
+        }
+        stream.seek(size - sizeof(scnq_footer));
+        if (!stream.read_array(std::span<scnq_footer>(&footer, 1)) || footer.magic != scnq_magic) {
+            return cc::err(cc::error_code::parse_invalid_format, "Missing .scnq footer");
+        }
+        //NOTE: both bounds first so the sum below cannot wrap around
+        if (footer.frame_count > (size - sizeof(scnq_footer)) / sizeof(u64) || footer.index_offset > size ||
+            footer.dictionary_offset < sizeof(scnq_header) || footer.dictionary_offset > footer.index_offset ||
+            footer.index_offset + footer.frame_count * sizeof(u64) + sizeof(scnq_footer) != size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnq footer");
+        }
+
+        //NOTE: every count read from the stream is checked against the dictionary size before it
+        // sizes an allocation
+        u64 dictionary_size = footer.index_offset - footer.dictionary_offset;
+        std::array<u32, 2> counts{};
+        stream.seek(footer.dictionary_offset);
+        if (dictionary_size < sizeof(counts) || !stream.read_array(std::span<u32>(counts))) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnq dictionary");
+        }
+        reader.camera_count_ = counts[0];
+        reader.marker_count_ = counts[1];
+
+        u64 table_size = (u64{counts[0]} + counts[1] + 1) * sizeof(u32) + u64{counts[0]} * 4 * sizeof(f32);
+        if (table_size > dictionary_size - sizeof(counts)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnq dictionary");
+        }
+        reader.name_offsets_.resize(size_t{counts[0]} + counts[1] + 1);
+        if (!stream.read_array(std::span<u32>(reader.name_offsets_))) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnq dictionary");
+        }
+        if (!std::ranges::is_sorted(reader.name_offsets_) ||
+            reader.name_offsets_.back() != dictionary_size - sizeof(counts) - table_size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnq name table");
+        }
+        reader.names_.resize(reader.name_offsets_.back());
+        reader.intrinsics_.resize(size_t{counts[0]} * 4);
+        reader.index_.resize(footer.frame_count);
+        if (!stream.read_array(std::span<char>(reader.names_)) ||
+            !stream.read_array(std::span<f32>(reader.intrinsics_)) ||
+            stream.tell() != footer.index_offset ||
+            !stream.read_array(std::span<u64>(reader.index_))) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnq dictionary");
+        }
+
+        //NOTE: ascending records between the header and the dictionary, so the record of frame k ends
+        // where frame k + 1 (or the dictionary) begins
+        if (!reader.index_.empty() &&
+            (reader.index_.front() < sizeof(scnq_header) || !std::ranges::is_sorted(reader.index_) ||
+             reader.index_.back() > footer.dictionary_offset)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnq frame index");
+        }
+        reader.dictionary_offset_ = footer.dictionary_offset;
+
+        return reader;
+    }
+
+    [[nodiscard]] size_t frame_count() const noexcept { return index_.size(); }
+    [[nodiscard]] size_t camera_count() const noexcept { return camera_count_; }
+    [[nodiscard]] size_t marker_count() const noexcept { return marker_count_; }
+
+    [[nodiscard]] std::string_view camera_name(camera_id id) const noexcept {
+        return id < camera_count_ ? name(id) : std::string_view{};
+    }
+
+    [[nodiscard]] std::string_view marker_name(marker_id id) const noexcept {
+        return id < marker_count_ ? name(size_t{camera_count_} + id) : std::string_view{};
+    }
+
+    [[nodiscard]] std::span<const f32, 4> intrinsics_of(camera_id id) const noexcept {
+        return std::span<const f32, 4>(intrinsics_.data() + size_t{id} * 4, 4);
+    }
+
+    [[nodiscard]] cc::result<void> read_frame(size_t k, sequence_frame& out) {
+        CC_PROFILE_SCOPE("io::sequence_reader::read_frame");
+        if (k >= index_.size()) {
+            return cc::err(cc::error_code::validation_out_of_range, "Frame index out of range");
+        }
+
+        stream_->seek(index_[k]);
+        scnq_frame_header header;
+        if (!stream_->read_array(std::span<scnq_frame_header>(&header, 1))) {
+            return cc::err(cc::error_code::file_read_error, "Truncated .scnq frame");
+        }
+        if (header.camera_count != camera_count_) {
+            return cc::err(cc::error_code::parse_invalid_format, "Frame camera count mismatch");
+        }
+
+        //NOTE: the observation count must account for the whole indexed record, checked before it
+        // sizes the frame buffers
+        u64 end = k + 1 < index_.size() ? index_[k + 1] : dictionary_offset_;
+        u64 record = sizeof(scnq_frame_header) + (u64{header.camera_count} + 1) * sizeof(u32) +
+                     u64{header.observation_count} * (sizeof(marker_id) + 2 * sizeof(f32));
+        if (record != end - index_[k]) {
+            return cc::err(cc::error_code::parse_invalid_format, "Frame size does not match the .scnq index");
+        }
+
+        out.timestamp = header.timestamp;
+        out.resize(header.camera_count, header.observation_count);
+        bool ok = stream_->read_array(std::span<u32>(out.offsets)) &&
+                  stream_->read_array(std::span<marker_id>(out.markers)) &&
+                  stream_->read_array(std::span<f32>(out.u)) &&
+                  stream_->read_array(std::span<f32>(out.v));
+        if (!ok) {
+            return cc::err(cc::error_code::file_read_error, "Truncated .scnq frame");
+        }
+        if (!std::ranges::is_sorted(out.offsets) || out.offsets.back() != header.observation_count) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnq frame offsets");
+        }
+        if (!std::ranges::all_of(out.markers, [this](marker_id m) { return m < marker_count_; })) {
+            return cc::err(cc::error_code::parse_invalid_format, "Out of range .scnq marker id");
+        }
+
+        metric::observations_read().add(header.observation_count);
+        return cc::ok();
+    }
+
+private:
+    explicit sequence_reader(S& stream) noexcept
+    : stream_(&stream) {}
+
+    [[nodiscard]] std::string_view name(size_t i) const noexcept {
+        return std::string_view(names_).substr(name_offsets_[i], name_offsets_[i + 1] - name_offsets_[i]);
+    }
+
+    S* stream_;
+    u32 camera_count_{0};
+    u32 marker_count_{0};
+    std::vector<u32> name_offsets_;
+    std::string names_;
+    std::vector<f32> intrinsics_;
+    std::vector<u64> index_;
+    u64 dictionary_offset_{0};
+};
+
+//NOTE: decodes frame k + 1 on a worker thread while the caller works on frame k. The frame
+// returned by next() stays valid until the following call, the reader must not be used meanwhile
+template<typename S>
+requires std::derived_from<S, sbase<S>> && seekable<S>
+class sequence_prefetcher {
+public:
+    explicit sequence_prefetcher(sequence_reader<S>& reader, size_t first = 0)
+    : reader_(reader), next_(first) {
+        worker_ = std::jthread([this](std::stop_token stop) { run(stop); });
+        request(next_);
+    }
+
+    sequence_prefetcher(const sequence_prefetcher&) = delete;
+    sequence_prefetcher& operator=(const sequence_prefetcher&) = delete;
+
+    [[nodiscard]] cc::result<const sequence_frame*> next() {
+        if (next_ >= reader_.frame_count()) {
+            return cc::err(cc::error_code::file_eof, "End of sequence");
+        }
+
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return !pending_; });
+        if (!status_) {
+            return cc::err(status_.error());
+        }
+
+        const sequence_frame* current = &slots_[fill_];
+        ++next_;
+        if (next_ < reader_.frame_count()) {
+            fill_ ^= 1;
+            target_ = next_;
+            pending_ = true;
+            lock.unlock();
+            cv_.notify_all();
+        }
+        return current;
+    }
+
+private:
+    void request(size_t k) {
+        if (k >= reader_.frame_count()) {
+            return;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            target_ = k;
+            pending_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void run(std::stop_token stop) {
+        std::unique_lock lock(mutex_);
+        while (cv_.wait(lock, stop, [this] { return pending_; })) {
+
+            size_t slot = fill_;
+            size_t k = target_;
+            lock.unlock();
+            auto res = reader_.read_frame(k, slots_[slot]);
+            lock.lock();
+
+            status_ = res;
+            pending_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    sequence_reader<S>& reader_;
+    std::array<sequence_frame, 2> slots_;
+    size_t next_{0};
+    size_t fill_{0};
+    size_t target_{0};
+    bool pending_{false};
+    cc::result<void> status_;
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::jthread worker_;
+};
+
+} // namespace cc::io
@@ -0,0 +1,109 @@
+#pragma once
+#include "scene.hpp"
+#include <cbox/core/serializer.hpp>
+#include <cbox/math/math.hpp>
+#include <type_traits>
+
+//NOTE: cc::codec specializations for the io scene types. vec and mat need none, they opt in to
+// enable_bulk_copy next to their definitions and go through the bulk path of the primary template
+static_assert(std::is_trivially_copyable_v<cc::vec3f> && std::is_trivially_copyable_v<cc::mat4f>);
+static_assert(sizeof(cc::vec3f) == 3 * sizeof(cc::f32) && sizeof(cc::mat3f) == 9 * sizeof(cc::f32));
+
+namespace cc {
+
+template<>
+struct codec<io::intrinsics> {
+    [[nodiscard]] static size_t size(const io::intrinsics& value) {
+        return serialized_size(value.name) + 4 * sizeof(f32);
+    }
+
+    static void write(byte_writer& out, const io::intrinsics& value) {
+        codec<std::string>::write(out, value.name);
+        out.write_array(std::span<const f32>({value.fx, value.fy, value.cx, value.cy}));
+    }
+
+    [[nodiscard]] static cc::result<void> read(byte_reader& in, io::intrinsics& value) {
+        if (auto res = codec<std::string>::read(in, value.name); !res) {
+            return res;
+        }
+        std::array<f32, 4> params{};
+        if (auto res = in.read_array(std::span<f32>(params)); !res) {
+            return res;
+        }
+        value.fx = params[0];
+        value.fy = params[1];
+        value.cx = params[2];
+        value.cy = params[3];
+        return cc::ok();
+    }
+};
+
+template<>
+struct codec<io::uv> {
+    [[nodiscard]] static size_t size(const io::uv& value) {
+        return serialized_size(value.marker_name) + 2 * sizeof(f32);
+    }
+
+    static void write(byte_writer& out, const io::uv& value) {
+        codec<std::string>::write(out, value.marker_name);
+        out.write(value.u);
+        out.write(value.v);
+    }
+
+    [[nodiscard]] static cc::result<void> read(byte_reader& in, io::uv& value) {
+        if (auto res = codec<std::string>::read(in, value.marker_name); !res) {
+            return res;
+        }
+        if (auto res = in.read(value.u); !res) {
+            return res;
+        }
+        return in.read(value.v);
+    }
+};
+
+//NOTE: cameras, then the per camera observation lists as (name, uvs) pairs
+template<>
+struct codec<io::scene> {
+    [[nodiscard]] static size_t size(const io::scene& value) {
+        size_t size = serialized_size(value.cameras()) + sizeof(u64);
+        for (const auto& [name, uvs] : value.uvs()) {
+            size += serialized_size(name) + serialized_size(uvs);
+        }
+        return size;
+    }
+
+    static void write(byte_writer& out, const io::scene& value) {
+        codec<io::scene::camera_list>::write(out, value.cameras());
+        out.write(static_cast<u64>(value.uvs().size()));
+        for (const auto& [name, uvs] : value.uvs()) {
+            codec<std::string>::write(out, name);
+            codec<io::scene::uv_list>::write(out, uvs);
+        }
+    }
+
+    [[nodiscard]] static cc::result<void> read(byte_reader& in, io::scene& value) {
+        value.clear();
+        if (auto res = codec<io::scene::camera_list>::read(in, value.cameras()); !res) {
+            return res;
+        }
+
+        auto count = in.read_length(2 * sizeof(u64));
+        if (!count) {
+            return cc::err(count.error());
+        }
+        value.uvs().reserve(*count);
+
+        std::string name;
+        for (size_t i = 0; i < *count; ++i) {
+            if (auto res = codec<std::string>::read(in, name); !res) {
+                return res;
+            }
+            if (auto res = codec<io::scene::uv_list>::read(in, value.uvs()[name]); !res) {
+                return res;
+            }
+        }
+        return cc::ok();
+    }
+};
+
+} // namespace cc
@@ -0,0 +1,132 @@
+#pragma once
+#include "../base/sbase.hpp"
+#include "fstream.hpp"
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cc::io {
+
+enum class io_backend {
+    automatic,
+    uring,
+    thread_pool,
+};
+
+struct io_completion {
+    u64 user_data{0};
+    size_t bytes{0};
+    int error{0};
+
+    [[nodiscard]] bool ok() const noexcept { return error == 0; }
+};
+
+//NOTE: plain file descriptor for positional async transfers, it has no file position of its own
+class async_file {
+
+public:
+    async_file() = default;
+    explicit async_file(const std::filesystem::path& path, mode mode = mode::read);
+
+    ~async_file();
+
+    async_file(const async_file&) = delete;
+    async_file& operator=(const async_file&) = delete;
+
+    async_file(async_file&& other) noexcept;
+    async_file& operator=(async_file&& other) noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return fd_ >= 0; }
+    [[nodiscard]] int handle() const noexcept { return fd_; }
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+    void close() noexcept;
+
+    std::filesystem::path path_;
+    int fd_{-1};
+};
+
+//NOTE: batched positional reads/writes into caller owned buffers. prepare_* queues a request,
+// submit() hands every prepared request to the backend and complete() harvests finished ones.
+// Buffers must stay alive until their completion is returned. Completions can report short
+// transfers, at end of file in particular. io_uring is used when the kernel supports it,
+// otherwise pread/pwrite run on a small thread pool shared by every queue of the process
+class io_queue {
+
+public:
+    class backend_base;
+
+    [[nodiscard]] static cc::result<io_queue> create(u32 depth = 64, io_backend backend = io_backend::automatic);
+
+    ~io_queue();
+
+    io_queue(io_queue&& other) noexcept;
+    io_queue& operator=(io_queue&& other) noexcept;
+
+    [[nodiscard]] io_backend backend() const noexcept;
+    [[nodiscard]] u32 depth() const noexcept;
+
+    //NOTE: requests prepared or submitted whose completion has not been returned yet
+    [[nodiscard]] size_t pending() const noexcept;
+
+    [[nodiscard]] cc::result<void> prepare_read(const async_file& file, u64 offset, std::span<std::byte> buffer, u64 user_data);
+    [[nodiscard]] cc::result<void> prepare_write(const async_file& file, u64 offset, std::span<const std::byte> data, u64 user_data);
+
+    [[nodiscard]] cc::result<size_t> submit();
+
+    //NOTE: blocks until at least min_complete requests finished (bounded by pending()),
+    // then returns as many completions as fit in `out`
+    [[nodiscard]] cc::result<size_t> complete(std::span<io_completion> out, size_t min_complete = 1);
+
+private:
+    explicit io_queue(std::unique_ptr<backend_base> impl) noexcept;
+
+    std::unique_ptr<backend_base> impl_;
+};
+
+//NOTE: single file stream over an io_queue. read()/write() are synchronous and advance the stream
+// position, prepare_read/prepare_write + submit() + complete() batch positional transfers on the
+// same queue without touching the position. user_data with all of its upper 32 bits set is
+// reserved for read()/write()
+class async_stream : public sbase<async_stream> {
+
+public:
+    explicit async_stream(const std::filesystem::path& path, mode mode = mode::read, u32 depth = 32,
+                          io_backend backend = io_backend::automatic);
+
+    [[nodiscard]] size_t read_impl(std::span<std::byte> buffer);
+    [[nodiscard]] size_t write_impl(std::span<const std::byte> data);
+
+    void flush_impl();
+
+    [[nodiscard]] bool is_open_impl() const noexcept;
+
+    [[nodiscard]] cc::result<void> prepare_read(u64 offset, std::span<std::byte> buffer, u64 user_data);
+    [[nodiscard]] cc::result<void> prepare_write(u64 offset, std::span<const std::byte> data, u64 user_data);
+    [[nodiscard]] cc::result<size_t> submit();
+    [[nodiscard]] cc::result<size_t> complete(std::span<io_completion> out, size_t min_complete = 1);
+
+    [[nodiscard]] io_backend backend() const noexcept;
+
+    void seek(size_t pos) noexcept { pos_ = pos; }
+    [[nodiscard]] size_t tell() const noexcept { return pos_; }
+    [[nodiscard]] size_t size() const { return file_.size(); }
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return file_.path(); }
+
+    [[nodiscard]] const async_file& file() const noexcept { return file_; }
+
+private:
+    [[nodiscard]] size_t transfer(u64 offset, std::byte* data, size_t size, bool write);
+
+    async_file file_;
+    std::optional<io_queue> queue_;
+    std::vector<io_completion> stash_;
+    u64 sync_serial_{0};
+    size_t pos_{0};
+};
+
+} // namespace cc::io
@@ -0,0 +1,219 @@
+#pragma once
+#include "../base/sbase.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cc::io {
+
+inline constexpr size_t default_block_size = 64 * 1024;
+
+//NOTE: block buffered adapter over any sbase stream. Reads are served from one block refilled
+// in bulk, writes are coalesced until a block is full. Transfers of at least a block bypass the
+// buffer. The adapter owns the wrapped stream, use inner() to reach it
+template<typename S>
+requires std::derived_from<S, sbase<S>>
+class buffered_stream : public sbase<buffered_stream<S>> {
+
+public:
+    explicit buffered_stream(S&& stream, size_t block_size = default_block_size)
+    : stream_(std::move(stream)), block_size_(std::max<size_t>(block_size, 1)) {}
+
+    ~buffered_stream() {
+        flush_writes();
+    }
+
+    buffered_stream(const buffered_stream&) = delete;
+    buffered_stream& operator=(const buffered_stream&) = delete;
+
+    buffered_stream(buffered_stream&& other) noexcept
+    : stream_(std::move(other.stream_))
+    , block_size_(other.block_size_)
+    , rbuf_(std::move(other.rbuf_))
+    , rpos_(std::exchange(other.rpos_, 0))
+    , rend_(std::exchange(other.rend_, 0))
+    , wbuf_(std::move(other.wbuf_))
+    , wlen_(std::exchange(other.wlen_, 0)) {}
+
+    buffered_stream& operator=(buffered_stream&& other) noexcept {
+        if (this != &other) {
+            flush_writes();
+            stream_ = std::move(other.stream_);
+            block_size_ = other.block_size_;
+            rbuf_ = std::move(other.rbuf_);
+            rpos_ = std::exchange(other.rpos_, 0);
+            rend_ = std::exchange(other.rend_, 0);
+            wbuf_ = std::move(other.wbuf_);
+            wlen_ = std::exchange(other.wlen_, 0);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] size_t read_impl(std::span<std::byte> buffer) {
+        size_t total = take_buffered(buffer);
+        buffer = buffer.subspan(total);
+        if (buffer.empty()) {
+            return total;
+        }
+
+        if (buffer.size() >= block_size_) {
+            return total + stream_.read(buffer);
+        }
+        if (!refill()) {
+            return total;
+        }
+        return total + take_buffered(buffer);
+    }
+
+    [[nodiscard]] size_t write_impl(std::span<const std::byte> data) {
+        if (rpos_ != rend_) {
+            //NOTE: the wrapped stream is ahead by the unread bytes, step back before writing
+            if constexpr (seekable<S>) {
+                stream_.seek(stream_.tell() - (rend_ - rpos_));
+            }
+        }
+        rpos_ = rend_ = 0;
+
+        if (wlen_ + data.size() > block_size_ && !flush_writes()) {
+            return 0;
+        }
+        if (data.size() >= block_size_) {
+            return stream_.write(data);
+        }
+
+        if (wbuf_.size() < block_size_) {
+            wbuf_.resize(block_size_);
+        }
+        std::memcpy(wbuf_.data() + wlen_, data.data(), data.size());
+        wlen_ += data.size();
+        return data.size();
+    }
+
+    void flush_impl() {
+        flush_writes();
+        stream_.flush();
+    }
+
+    [[nodiscard]] bool is_open_impl() const noexcept {
+        return stream_.is_open();
+    }
+
+    //NOTE: the view points into the read block and stays valid until the next read call.
+    // '\r' before the newline is stripped, a last line without newline is still returned
+    [[nodiscard]] cc::result<std::string_view> next_line() {
+        size_t scanned = 0;
+        for (;;) {
+            const char* begin = reinterpret_cast<const char*>(rbuf_.data()) + rpos_;
+            size_t available = rend_ - rpos_;
+
+            //NOTE: before the first refill rbuf_ is empty and its data() is null, memchr must not see it
+            if (available > scanned) {
+                if (const void* nl = std::memchr(begin + scanned, '\n', available - scanned)) {
+                    size_t length = static_cast<size_t>(static_cast<const char*>(nl) - begin);
+                    rpos_ += length + 1;
+                    return trim_cr(std::string_view(begin, length));
+                }
+                scanned = available;
+            }
+
+            if (!refill()) {
+                if (rpos_ == rend_) {
+                    return cc::err(cc::error_code::file_eof, "End of file");
+                }
+                std::string_view last(reinterpret_cast<const char*>(rbuf_.data()) + rpos_, rend_ - rpos_);
+                rpos_ = rend_;
+                return trim_cr(last);
+            }
+        }
+    }
+
+    //NOTE: satisfies cc::line_reader, same as next_line()
+    [[nodiscard]] cc::result<std::string_view> read_line() {
+        return next_line();
+    }
+
+    void seek(size_t pos) requires seekable<S> {
+        flush_writes();
+        rpos_ = rend_ = 0;
+        stream_.seek(pos);
+    }
+
+    [[nodiscard]] size_t tell() const requires seekable<S> {
+        return stream_.tell() - (rend_ - rpos_) + wlen_;
+    }
+
+    [[nodiscard]] size_t size() const requires seekable<S> {
+        return std::max(stream_.size(), tell());
+    }
+
+    [[nodiscard]] size_t block_size() const noexcept { return block_size_; }
+
+    [[nodiscard]] S& inner() noexcept { return stream_; }
+    [[nodiscard]] const S& inner() const noexcept { return stream_; }
+
+private:
+    static std::string_view trim_cr(std::string_view line) noexcept {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    size_t take_buffered(std::span<std::byte> buffer) noexcept {
+        size_t count = std::min(buffer.size(), rend_ - rpos_);
+        if (count > 0) {
+            std::memcpy(buffer.data(), rbuf_.data() + rpos_, count);
+            rpos_ += count;
+        }
+        return count;
+    }
+
+    //NOTE: keeps unread bytes, grows the block only when a single line does not fit
+    bool refill() {
+        if (wlen_ > 0) {
+            flush_writes();
+        }
+
+        size_t pending = rend_ - rpos_;
+        if (pending > 0 && rpos_ > 0) {
+            std::memmove(rbuf_.data(), rbuf_.data() + rpos_, pending);
+        }
+        rpos_ = 0;
+        rend_ = pending;
+
+        if (rbuf_.size() < block_size_) {
+            rbuf_.resize(block_size_);
+        } else if (pending == rbuf_.size()) {
+            rbuf_.resize(rbuf_.size() * 2);
+        }
+
+        size_t bytes_read = stream_.read(std::span(rbuf_).subspan(rend_));
+        rend_ += bytes_read;
+        return bytes_read > 0;
+    }
+
+    bool flush_writes() {
+        if (wlen_ == 0) {
+            return true;
+        }
+        size_t written = stream_.write(std::span<const std::byte>(wbuf_.data(), wlen_));
+        bool ok = written == wlen_;
+        wlen_ = 0;
+        return ok;
+    }
+
+    S stream_;
+    size_t block_size_;
+
+    std::vector<std::byte> rbuf_;
+    size_t rpos_{0};
+    size_t rend_{0};
+
+    std::vector<std::byte> wbuf_;
+    size_t wlen_{0};
+};
+
+} // namespace cc::io
@@ -0,0 +1,373 @@
+#pragma once
+#include "../base/sbase.hpp"
+#include "../compress/lz.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <vector>
+
+namespace cc::io {
+
+//NOTE: block compressed stream layout, little endian:
+//  lzs_header | blocks | lzs_block index[block_count] | lzs_footer
+// Blocks are compressed independently with lz_compress, or stored raw when that does not
+// shrink them, so any block can be decoded on its own and on any thread
+inline constexpr std::array<char, 4> lzs_magic{'C', 'B', 'L', 'Z'};
+inline constexpr u16 lzs_version = 1;
+inline constexpr u32 lzs_stored_raw = 0x80000000u;
+inline constexpr size_t lzs_default_block_size = 256 * 1024;
+inline constexpr size_t lzs_max_block_size = 64 * 1024 * 1024;
+
+struct lzs_header {
+    std::array<char, 4> magic{lzs_magic};
+    u16 version{lzs_version};
+    u16 reserved{0};
+    u32 block_size{0};
+    u32 reserved2{0};
+};
+
+struct lzs_block {
+    u64 offset{0};
+    u32 stored_size{0};
+    u32 raw_size{0};
+
+    [[nodiscard]] bool is_raw() const noexcept { return (stored_size & lzs_stored_raw) != 0; }
+    [[nodiscard]] u32 size() const noexcept { return stored_size & ~lzs_stored_raw; }
+};
+
+struct lzs_footer {
+    u64 index_offset{0};
+    u64 block_count{0};
+    u64 raw_size{0};
+    u16 version{lzs_version};
+    u16 reserved{0};
+    std::array<char, 4> magic{lzs_magic};
+};
+
+namespace detail {
+
+[[nodiscard]] inline cc::result<void> decode_lzs_block(const lzs_block& block, std::span<const std::byte> stored,
+                                                     std::span<std::byte> out) noexcept {
+    if (block.is_raw()) {
+        if (stored.size() != block.raw_size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt raw block");
+        }
+        std::memcpy(out.data(), stored.data(), stored.size());
+        return cc::ok();
+    }
+
+    auto size = lz_decompress(stored, out.first(block.raw_size));
+    if (!size) {
+        return cc::err(size.error());
+    }
+    if (*size != block.raw_size) {
+        return cc::err(cc::error_code::parse_invalid_format, "Block decompressed to the wrong size");
+    }
+    return cc::ok();
+}
+
+} // namespace detail
+
+//NOTE: compresses everything written into independent blocks, finish() writes the block index.
+// flush() closes the current block early, so flushing often costs ratio
+template<typename S>
+requires std::derived_from<S, sbase<S>>
+class compressed_writer : public sbase<compressed_writer<S>> {
+
+public:
+    explicit compressed_writer(S& stream, size_t block_size = lzs_default_block_size)
+    : stream_(&stream), block_size_(std::clamp<size_t>(block_size, 4096, lzs_max_block_size)) {
+        raw_.resize(block_size_);
+        packed_.resize(lz_compress_bound(block_size_));
+
+        lzs_header header;
+        header.block_size = static_cast<u32>(block_size_);
+        failed_ = !stream_->write_binary(header);
+        offset_ = sizeof(lzs_header);
+    }
+
+    ~compressed_writer() {
+        if (!finished_) {
+            if (auto res = finish(); !res) {
+                res.error().log();
+            }
+        }
+    }
+
+    compressed_writer(const compressed_writer&) = delete;
+    compressed_writer& operator=(const compressed_writer&) = delete;
+
+    [[nodiscard]] size_t read_impl(std::span<std::byte>) { return 0; }
+
+    [[nodiscard]] size_t write_impl(std::span<const std::byte> data) {
+        if (failed_ || finished_) {
+            return 0;
+        }
+
+        size_t total = 0;
+        while (!data.empty()) {
+            size_t count = std::min(data.size(), block_size_ - fill_);
+            std::memcpy(raw_.data() + fill_, data.data(), count);
+            fill_ += count;
+            total += count;
+            data = data.subspan(count);
+
+            if (fill_ == block_size_ && !emit_block()) {
+                return total;
+            }
+        }
+        return total;
+    }
+
+    void flush_impl() {
+        if (fill_ > 0) {
+            emit_block();
+        }
+        stream_->flush();
+    }
+
+    [[nodiscard]] bool is_open_impl() const noexcept {
+        return !failed_ && !finished_ && stream_->is_open();
+    }
+
+    [[nodiscard]] cc::result<void> finish() {
+        if (finished_) {
+            return cc::ok();
+        }
+        if (fill_ > 0) {
+            emit_block();
+        }
+        finished_ = true;
+        if (failed_) {
+            return cc::err(cc::error_code::file_write_error, "Failed to write compressed block");
+        }
+
+        lzs_footer footer;
+        footer.index_offset = offset_;
+        footer.block_count = index_.size();
+        footer.raw_size = raw_total_;
+        if (!stream_->write_array(std::span<const lzs_block>(index_)) || !stream_->write_binary(footer)) {
+            failed_ = true;
+            return cc::err(cc::error_code::file_write_error, "Failed to write compressed block index");
+        }
+        stream_->flush();
+        return cc::ok();
+    }
+
+    [[nodiscard]] u64 raw_size() const noexcept { return raw_total_ + fill_; }
+    [[nodiscard]] u64 compressed_size() const noexcept { return offset_; }
+    [[nodiscard]] size_t block_size() const noexcept { return block_size_; }
+
+private:
+    bool emit_block() {
+        size_t size = lz_compress(std::span<const std::byte>(raw_.data(), fill_), packed_);
+
+        lzs_block block{offset_, static_cast<u32>(size), static_cast<u32>(fill_)};
+        std::span<const std::byte> stored(packed_.data(), size);
+        if (size >= fill_) {
+            block.stored_size = static_cast<u32>(fill_) | lzs_stored_raw;
+            stored = std::span<const std::byte>(raw_.data(), fill_);
+        }
+
+        if (!stream_->write_array(stored)) {
+            failed_ = true;
+            return false;
+        }
+        index_.push_back(block);
+        offset_ += stored.size();
+        raw_total_ += fill_;
+        fill_ = 0;
+        return true;
+    }
+
+    S* stream_;
+    size_t block_size_;
+    std::vector<std::byte> raw_;
+    std::vector<std::byte> packed_;
+    size_t fill_{0};
+
+    std::vector<lzs_block> index_;
+    u64 offset_{0};
+    u64 raw_total_{0};
+    bool failed_{false};
+    bool finished_{false};
+};
+
+//NOTE: random access reader over a block compressed stream. Reads that cover several whole
+// blocks fetch their compressed bytes in one read and decode the blocks as tasks of the global
+// job system straight into the caller buffer, everything else goes through a one block cache.
+// parallel = false decodes those reads on the calling thread
+template<typename S>
+requires std::derived_from<S, sbase<S>> && seekable<S>
+class compressed_reader : public sbase<compressed_reader<S>> {
+
+public:
+    [[nodiscard]] static cc::result<compressed_reader> open(S& stream, bool parallel = true) {
+        compressed_reader reader(stream, parallel);
+
+        lzs_header header;
+        stream.seek(0);
+        if (!stream.read_array(std::span<lzs_header>(&header, 1)) || header.magic != lzs_magic) {
+            return cc::err(cc::error_code::parse_invalid_format, "Not a block compressed stream");
+        }
+        if (header.version == 0 || header.version > lzs_version || header.block_size == 0 ||
+            header.block_size > lzs_max_block_size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Unsupported block compressed stream");
+        }
+
+        size_t size = stream.size();
+        lzs_footer footer;
+        if (size < sizeof(lzs_header) + sizeof(lzs_footer)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated block compressed stream");
+        }
+        stream.seek(size - sizeof(lzs_footer));
+        if (!stream.read_array(std::span<lzs_footer>(&footer, 1)) || footer.magic != lzs_magic) {
+            return cc::err(cc::error_code::parse_invalid_format, "Missing block compressed footer");
+        }
+        if (footer.block_count > (size - sizeof(lzs_footer)) / sizeof(lzs_block) ||
+            footer.index_offset < sizeof(lzs_header) || footer.index_offset > size ||
+            footer.index_offset + footer.block_count * sizeof(lzs_block) + sizeof(lzs_footer) != size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt block compressed footer");
+        }
+
+        reader.index_.resize(footer.block_count);
+        stream.seek(footer.index_offset);
+        if (!stream.read_array(std::span<lzs_block>(reader.index_))) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated block index");
+        }
+
+        //NOTE: the blocks must tile [header, index) in order, as the writer lays them out. decode_range
+        // relies on that to fetch a run of blocks with one read
+        reader.starts_.reserve(reader.index_.size() + 1);
+        reader.starts_.push_back(0);
+        u64 offset = sizeof(lzs_header);
+        for (const auto& block : reader.index_) {
+            if (block.raw_size > header.block_size || block.offset != offset ||
+                block.size() > footer.index_offset - offset) {
+                return cc::err(cc::error_code::parse_invalid_format, "Corrupt block index entry");
+            }
+            offset += block.size();
+            reader.starts_.push_back(reader.starts_.back() + block.raw_size);
+        }
+        if (offset != footer.index_offset) {
+            return cc::err(cc::error_code::parse_invalid_format, "Block index does not cover the stream");
+        }
+        if (reader.starts_.back() != footer.raw_size) {
+            return cc::err(cc::error_code::parse_invalid_format, "Block index does not match raw size");
+        }
+
+        reader.block_.resize(header.block_size);
+        return reader;
+    }
+
+    [[nodiscard]] size_t read_impl(std::span<std::byte> buffer) {
+        size_t total = 0;
+        while (!buffer.empty() && pos_ < size()) {
+            size_t k = block_of(pos_);
+            size_t in_block = pos_ - starts_[k];
+
+            if (in_block == 0 && parallel_ && cached_ != k) {
+                size_t last = k;
+                while (last < index_.size() && starts_[last + 1] - pos_ <= buffer.size()) {
+                    ++last;
+                }
+                if (last - k >= 2) {
+                    size_t count = starts_[last] - starts_[k];
+                    if (!decode_range(k, last, buffer.first(count))) {
+                        return total;
+                    }
+                    pos_ += count;
+                    total += count;
+                    buffer = buffer.subspan(count);
+                    continue;
+                }
+            }
+
+            if (cached_ != k && !load_block(k)) {
+                return total;
+            }
+            size_t count = std::min(buffer.size(), static_cast<size_t>(index_[k].raw_size) - in_block);
+            std::memcpy(buffer.data(), block_.data() + in_block, count);
+            pos_ += count;
+            total += count;
+            buffer = buffer.subspan(count);
+        }
+        return total;
+    }
+
+    [[nodiscard]] size_t write_impl(std::span<const std::byte>) { return 0; }
+
+    void flush_impl() {}
+
+    [[nodiscard]] bool is_open_impl() const noexcept { return stream_->is_open(); }
+
+    //NOTE: positions are in decompressed bytes, seeking only costs decoding the target block
+    void seek(size_t pos) noexcept { pos_ = std::min<size_t>(pos, size()); }
+    [[nodiscard]] size_t tell() const noexcept { return pos_; }
+    [[nodiscard]] size_t size() const noexcept { return static_cast<size_t>(starts_.back()); }
+
+    [[nodiscard]] size_t block_count() const noexcept { return index_.size(); }
+    [[nodiscard]] const lzs_block& block(size_t k) const noexcept { return index_[k]; }
+    [[nodiscard]] u64 compressed_size() const noexcept { return stream_->size(); }
+
+private:
+    compressed_reader(S& stream, bool parallel) noexcept
+    : stream_(&stream), parallel_(parallel) {}
+
+    [[nodiscard]] size_t block_of(size_t pos) const noexcept {
+        if (cached_ < index_.size() && pos >= starts_[cached_] && pos < starts_[cached_ + 1]) {
+            return cached_;
+        }
+        auto it = std::upper_bound(starts_.begin(), starts_.end(), static_cast<u64>(pos));
+        return static_cast<size_t>(it - starts_.begin()) - 1;
+    }
+
+    bool load_block(size_t k) {
+        const lzs_block& block = index_[k];
+        packed_.resize(block.size());
+        stream_->seek(block.offset);
+        if (!stream_->read_array(std::span<std::byte>(packed_)) ||
+            !detail::decode_lzs_block(block, packed_, block_)) {
+            cached_ = invalid_block;
+            return false;
+        }
+        cached_ = k;
+        return true;
+    }
+
+    //NOTE: blocks [first, last) are contiguous in the file, one read fetches all of them
+    bool decode_range(size_t first, size_t last, std::span<std::byte> out) {
+        CC_PROFILE_SCOPE("io::compressed_reader::decode_range");
+        u64 begin = index_[first].offset;
+        u64 end = index_[last - 1].offset + index_[last - 1].size();
+        packed_.resize(static_cast<size_t>(end - begin));
+        stream_->seek(begin);
+        if (!stream_->read_array(std::span<std::byte>(packed_))) {
+            return false;
+        }
+
+        //NOTE: one block per task, a block is already a few hundred microseconds of decoding
+        auto decoded = cc::parallel_for(first, last, 1, [&](size_t k) {
+            const lzs_block& block = index_[k];
+            auto stored = std::span<const std::byte>(packed_).subspan(block.offset - begin, block.size());
+            auto target = out.subspan(starts_[k] - starts_[first], block.raw_size);
+            return detail::decode_lzs_block(block, stored, target);
+        });
+        return decoded.has_value();
+    }
+
+    static constexpr size_t invalid_block = ~size_t{0};
+
+    S* stream_;
+    bool parallel_;
+    std::vector<lzs_block> index_;
+    std::vector<u64> starts_;
+
+    std::vector<std::byte> packed_;
+    std::vector<std::byte> block_;
+    size_t cached_{invalid_block};
+    size_t pos_{0};
+};
+
+} // namespace cc::io
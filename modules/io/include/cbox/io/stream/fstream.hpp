@@ -34,6 +34,7 @@ public:
 
     void seek(size_t pos);
     [[nodiscard]] size_t tell() const;
+    [[nodiscard]] size_t size() const;
     [[nodiscard]] const std::filesystem::path& path() const noexcept;
 
 
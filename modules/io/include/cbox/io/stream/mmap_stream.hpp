@@ -0,0 +1,68 @@
+#pragma once
+#include "../base/sbase.hpp"
+#include <filesystem>
+#include <span>
+
+namespace cc::io {
+
+enum class access_hint {
+    normal,
+    sequential,
+    random,
+    will_need,
+};
+
+//NOTE: read-only memory mapped file. The whole file is mapped unless a window budget is given,
+// in which case the window follows read()/seek() and never maps more than the budget, rounded down
+// to whole pages (at least one). map_window() clamps to it as well
+class mmap_stream : public sbase<mmap_stream> {
+
+public:
+    explicit mmap_stream(const std::filesystem::path& path, size_t window_budget = 0);
+
+    ~mmap_stream();
+
+    mmap_stream(const mmap_stream&) = delete;
+    mmap_stream& operator=(const mmap_stream&) = delete;
+
+    mmap_stream(mmap_stream&& other) noexcept;
+    mmap_stream& operator=(mmap_stream&& other) noexcept;
+
+    [[nodiscard]] size_t read_impl(std::span<std::byte> buffer);
+    [[nodiscard]] size_t write_impl(std::span<const std::byte> data);
+
+    void flush_impl();
+
+    [[nodiscard]] bool is_open_impl() const noexcept;
+
+    //NOTE: bytes of the current window, starting at window_offset() in the file
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept;
+    [[nodiscard]] size_t window_offset() const noexcept { return map_offset_; }
+    [[nodiscard]] bool is_fully_mapped() const noexcept { return map_offset_ == 0 && map_length_ == size_; }
+
+    [[nodiscard]] cc::result<void> map_window(size_t offset, size_t length);
+    [[nodiscard]] cc::result<void> advise(access_hint hint);
+
+    void seek(size_t pos);
+    [[nodiscard]] size_t tell() const noexcept { return pos_; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] const std::filesystem::path& path() const noexcept;
+
+private:
+    void unmap() noexcept;
+    void close() noexcept;
+    [[nodiscard]] bool ensure_mapped(size_t pos);
+
+    std::filesystem::path path_;
+    int fd_{-1};
+    size_t size_{0};
+    size_t pos_{0};
+    size_t window_budget_{0};
+
+    std::byte* map_{nullptr};
+    size_t map_offset_{0};
+    size_t map_length_{0};
+    access_hint hint_{access_hint::normal};
+};
+
+} // namespace cc::io
@@ -0,0 +1,20 @@
+#include <cbox/io/base/metrics.hpp>
+
+namespace cc::io::metric {
+
+cc::metrics::counter& observations_read() {
+    static auto& observations = cc::metrics::get_counter("cbox_io_observations_total", "Observations read from scenes and sequences");
+    return observations;
+}
+
+cc::metrics::histogram& scene_load_time() {
+    static auto& latency = cc::metrics::get_histogram("cbox_io_scene_load_ns", "Scene file load time in nanoseconds");
+    return latency;
+}
+
+cc::metrics::histogram& dense_scene_load_time() {
+    static auto& latency = cc::metrics::get_histogram("cbox_io_dense_scene_load_ns", "Dense scene file load time in nanoseconds");
+    return latency;
+}
+
+} // namespace cc::io::metric
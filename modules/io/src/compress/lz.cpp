@@ -0,0 +1,179 @@
+#include "cbox/io/compress/lz.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace cc::io {
+
+namespace {
+
+constexpr u32 hash_bits = 14;
+
+//NOTE: the tail is always emitted as literals so the match finder can read 4 bytes freely
+constexpr size_t tail_literals = 5;
+
+u32 load32(const std::byte* p) noexcept {
+    u32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+u32 hash32(u32 value) noexcept {
+    return (value * 2654435761u) >> (32 - hash_bits);
+}
+
+std::byte* put_length(std::byte* op, size_t length) noexcept {
+    while (length >= 255) {
+        *op++ = std::byte{255};
+        length -= 255;
+    }
+    *op++ = static_cast<std::byte>(length);
+    return op;
+}
+
+std::byte* put_sequence(std::byte* op, const std::byte* literals, size_t literal_length,
+                        size_t offset, size_t match_length) noexcept {
+    std::byte* token = op++;
+    u8 value = static_cast<u8>(std::min<size_t>(literal_length, 15) << 4);
+    if (literal_length >= 15) {
+        op = put_length(op, literal_length - 15);
+    }
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length > 0) {
+        *op++ = static_cast<std::byte>(offset & 0xff);
+        *op++ = static_cast<std::byte>(offset >> 8);
+
+        size_t code = match_length - lz_min_match;
+        value |= static_cast<u8>(std::min<size_t>(code, 15));
+        if (code >= 15) {
+            op = put_length(op, code - 15);
+        }
+    }
+    *token = static_cast<std::byte>(value);
+    return op;
+}
+
+bool get_length(const std::byte*& ip, const std::byte* end, size_t& length) noexcept {
+    u8 value;
+    do {
+        if (ip == end) {
+            return false;
+        }
+        value = static_cast<u8>(*ip++);
+        length += value;
+    } while (value == 255);
+    return true;
+}
+
+} // namespace
+
+size_t lz_compress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept {
+    if (dst.size() < lz_compress_bound(src.size())) {
+        return 0;
+    }
+
+    const std::byte* base = src.data();
+    const std::byte* ip = base;
+    const std::byte* anchor = base;
+    const std::byte* end = base + src.size();
+    std::byte* op = dst.data();
+
+    if (src.size() > lz_min_match + tail_literals) {
+        const std::byte* limit = end - tail_literals;
+        std::array<u32, size_t{1} << hash_bits> table{};
+
+        while (ip < limit) {
+            u32 sequence = load32(ip);
+            u32 h = hash32(sequence);
+            const std::byte* ref = base + table[h];
+            table[h] = static_cast<u32>(ip - base);
+
+            if (ref < ip && static_cast<size_t>(ip - ref) <= lz_max_offset && load32(ref) == sequence) {
+                size_t length = lz_min_match;
+                while (ip + length < limit && ref[length] == ip[length]) {
+                    ++length;
+                }
+
+                op = put_sequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), length);
+                ip += length;
+                anchor = ip;
+                continue;
+            }
+
+            //NOTE: step further the longer nothing matched, incompressible data passes quickly
+            ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+        }
+    }
+
+    op = put_sequence(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return static_cast<size_t>(op - dst.data());
+}
+
+cc::result<size_t> lz_decompress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept {
+    const std::byte* ip = src.data();
+    const std::byte* iend = ip + src.size();
+    std::byte* op = dst.data();
+    std::byte* oend = op + dst.size();
+
+    while (ip < iend) {
+        u8 token = static_cast<u8>(*ip++);
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !get_length(ip, iend, literal_length)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated LZ literal length");
+        }
+        if (literal_length > static_cast<size_t>(iend - ip) || literal_length > static_cast<size_t>(oend - op)) {
+            return cc::err(cc::error_code::parse_invalid_format, "LZ literals out of bounds");
+        }
+        //NOTE: short runs copy a fixed 16 bytes when both sides have room, the extra bytes are
+        // overwritten by the next sequence
+        if (literal_length <= 16 && iend - ip >= 16 && oend - op >= 16) {
+            std::memcpy(op, ip, 16);
+        } else {
+            std::memcpy(op, ip, literal_length);
+        }
+        ip += literal_length;
+        op += literal_length;
+
+        if (ip == iend) {
+            break;
+        }
+
+        if (iend - ip < 2) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated LZ match offset");
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+
+        size_t match_length = token & 0x0f;
+        if (match_length == 15 && !get_length(ip, iend, match_length)) {
+            return cc::err(cc::error_code::parse_invalid_format, "Truncated LZ match length");
+        }
+        match_length += lz_min_match;
+
+        if (offset == 0 || offset > static_cast<size_t>(op - dst.data()) ||
+            match_length > static_cast<size_t>(oend - op)) {
+            return cc::err(cc::error_code::parse_invalid_format, "LZ match out of bounds");
+        }
+
+        const std::byte* ref = op - offset;
+        if (offset >= 16 && match_length <= 16 && oend - op >= 16) {
+            std::memcpy(op, ref, 16);
+            op += match_length;
+        } else if (offset >= match_length) {
+            std::memcpy(op, ref, match_length);
+            op += match_length;
+        } else {
+            //NOTE: overlapping match repeats the last `offset` bytes, copy forward byte by byte
+            for (size_t i = 0; i < match_length; ++i) {
+                *op++ = ref[i];
+            }
+        }
+    }
+
+    return static_cast<size_t>(op - dst.data());
+}
+
+} // namespace cc::io
@@ -0,0 +1,397 @@
+#include "cbox/io/scene/binary.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+namespace cc::io {
+
+namespace {
+
+constexpr size_t align_up(size_t value) noexcept {
+    return (value + scnb_alignment - 1) / scnb_alignment * scnb_alignment;
+}
+
+template<typename T>
+std::span<const T> section_span(std::span<const std::byte> image, const scnb_section& section) noexcept {
+    return {reinterpret_cast<const T*>(image.data() + section.offset), section.size / sizeof(T)};
+}
+
+template<typename T>
+std::span<const std::byte> as_bytes_of(std::span<const T> data) noexcept {
+    return std::as_bytes(data);
+}
+
+cc::result<void> write_all(fstream& out, std::span<const std::byte> data) {
+    if (out.write(data) != data.size()) {
+        return cc::err(cc::error_code::file_write_error, "Write failed");
+    }
+    return cc::ok();
+}
+
+cc::result<void> write_padding(fstream& out, size_t written) {
+    static constexpr std::array<std::byte, scnb_alignment> zeros{};
+    size_t pad = align_up(written) - written;
+    return write_all(out, std::span(zeros).first(pad));
+}
+
+} // namespace
+
+cc::result<scnb_view> scnb_view::open(std::span<const std::byte> image) {
+    CC_PROFILE_SCOPE("io::scnb_view::open");
+    static_assert(std::endian::native == std::endian::little, ".scnb sections are used in place as little endian");
+
+    scnb_view view;
+    if (image.size() < sizeof(scnb_header)) {
+        return cc::err(cc::error_code::parse_invalid_format, "Image too small for a .scnb header");
+    }
+    if (reinterpret_cast<std::uintptr_t>(image.data()) % alignof(scnb_header) != 0) {
+        return cc::err(cc::error_code::validation_invalid_state, ".scnb image is not aligned");
+    }
+
+    std::memcpy(&view.header_, image.data(), sizeof(scnb_header));
+    const auto& h = view.header_;
+
+    if (h.magic != scnb_magic) {
+        return cc::err(cc::error_code::parse_invalid_format, "Not a .scnb file");
+    }
+    if (h.endian != scnb_endian_tag) {
+        return cc::err(cc::error_code::parse_invalid_format, ".scnb endianness mismatch");
+    }
+    if (h.version == 0 || h.version > scnb_version) {
+        return cc::err(cc::error_code::parse_invalid_format, "Unsupported .scnb version");
+    }
+    if (h.section_count != static_cast<u32>(scnb_section_kind::count)) {
+        return cc::err(cc::error_code::parse_invalid_format, "Unexpected .scnb section count");
+    }
+
+    for (u32 i = 0; i < h.section_count; ++i) {
+        const auto& s = h.sections[i];
+        if (s.kind != static_cast<scnb_section_kind>(i) || s.offset % scnb_alignment != 0 ||
+            s.offset > image.size() || s.size > image.size() - s.offset) {
+            return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnb section table");
+        }
+    }
+
+    auto section = [&](scnb_section_kind kind) -> const scnb_section& {
+        return h.sections[static_cast<size_t>(kind)];
+    };
+
+    size_t name_count = size_t{h.camera_count} + h.marker_count;
+    auto names = section_span<std::byte>(image, section(scnb_section_kind::names));
+    if (names.size() < (name_count + 1) * sizeof(u32)) {
+        return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnb name table");
+    }
+    view.name_offsets_ = {reinterpret_cast<const u32*>(names.data()), name_count + 1};
+    auto chars = names.subspan((name_count + 1) * sizeof(u32));
+    view.name_bytes_ = {reinterpret_cast<const char*>(chars.data()), chars.size()};
+    if (!std::ranges::is_sorted(view.name_offsets_)) {
+        return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnb name offsets");
+    }
+    if (view.name_offsets_.back() > view.name_bytes_.size()) {
+        return cc::err(cc::error_code::parse_invalid_format, "Truncated .scnb name bytes");
+    }
+
+    view.intrinsics_ = section_span<f32>(image, section(scnb_section_kind::intrinsics));
+    view.offsets_ = section_span<u32>(image, section(scnb_section_kind::offsets));
+    view.marker_ids_ = section_span<marker_id>(image, section(scnb_section_kind::marker_ids));
+    view.u_ = section_span<f32>(image, section(scnb_section_kind::u));
+    view.v_ = section_span<f32>(image, section(scnb_section_kind::v));
+
+    if (view.intrinsics_.size() != size_t{h.camera_count} * 4 ||
+        view.offsets_.size() != size_t{h.camera_count} + 1 ||
+        view.marker_ids_.size() != h.observation_count ||
+        view.u_.size() != h.observation_count || view.v_.size() != h.observation_count ||
+        view.offsets_.back() != h.observation_count) {
+        return cc::err(cc::error_code::parse_invalid_format, "Inconsistent .scnb section sizes");
+    }
+
+    //NOTE: with the last offset pinned above, ascending offsets keep every camera range in bounds
+    if (!std::ranges::is_sorted(view.offsets_)) {
+        return cc::err(cc::error_code::parse_invalid_format, "Corrupt .scnb observation offsets");
+    }
+    if (!std::ranges::all_of(view.marker_ids_, [&](marker_id m) { return m < h.marker_count; })) {
+        return cc::err(cc::error_code::parse_invalid_format, "Out of range .scnb marker id");
+    }
+
+    return view;
+}
+
+std::string_view scnb_view::camera_name(camera_id id) const noexcept {
+    if (id >= header_.camera_count) {
+        return {};
+    }
+    return {name_bytes_.data() + name_offsets_[id], name_offsets_[id + 1] - name_offsets_[id]};
+}
+
+std::string_view scnb_view::marker_name(marker_id id) const noexcept {
+    if (id >= header_.marker_count) {
+        return {};
+    }
+    size_t i = size_t{header_.camera_count} + id;
+    return {name_bytes_.data() + name_offsets_[i], name_offsets_[i + 1] - name_offsets_[i]};
+}
+
+camera_view scnb_view::camera(camera_id id) const noexcept {
+    if (id >= header_.camera_count) {
+        return {};
+    }
+
+    size_t begin = offsets_[id];
+    size_t count = offsets_[id + 1] - begin;
+    return {id, marker_ids_.subspan(begin, count), u_.subspan(begin, count), v_.subspan(begin, count)};
+}
+
+cc::result<dense_scene> scnb_view::to_dense() const {
+    CC_PROFILE_SCOPE("io::scnb_view::to_dense");
+    dense_scene out;
+    out.reserve(camera_count(), observation_count());
+
+    for (marker_id m = 0; m < marker_count(); ++m) {
+        (void)out.intern_marker(marker_name(m));
+    }
+
+    for (camera_id c = 0; c < camera_count(); ++c) {
+        auto k = intrinsics_of(c);
+        if (auto id = out.add_camera(camera_name(c), k[0], k[1], k[2], k[3]); !id) {
+            return cc::err(id.error());
+        }
+
+        auto view = camera(c);
+        for (size_t i = 0; i < view.size(); ++i) {
+            if (auto res = out.add_observation(view.markers[i], view.u[i], view.v[i]); !res) {
+                return cc::err(res.error());
+            }
+        }
+    }
+    return out;
+}
+
+cc::result<scnb_file> scnb_file::open(const std::filesystem::path& path) {
+    mmap_stream stream(path);
+    if (!stream.is_open()) {
+        return cc::err(cc::error_code::file_not_found, "Failed to open .scnb file");
+    }
+
+    auto view = scnb_view::open(stream.bytes());
+    if (!view) {
+        return cc::err(view.error());
+    }
+    return scnb_file(std::move(stream), *view);
+}
+
+cc::result<void> write_scnb(const dense_scene& scene, fstream& out) {
+    CC_PROFILE_SCOPE("io::write_scnb");
+    if (!out.is_open()) {
+        return cc::err(cc::error_code::file_write_error, "Stream is not open");
+    }
+
+    const auto& cameras = scene.camera_names();
+    const auto& markers = scene.marker_names();
+    size_t name_count = cameras.size() + markers.size();
+
+    std::vector<u32> name_offsets;
+    name_offsets.reserve(name_count + 1);
+    name_offsets.push_back(0);
+    for (u32 i = 0; i < cameras.size(); ++i) {
+        name_offsets.push_back(name_offsets.back() + static_cast<u32>(cameras.name(i).size()));
+    }
+    for (u32 i = 0; i < markers.size(); ++i) {
+        name_offsets.push_back(name_offsets.back() + static_cast<u32>(markers.name(i).size()));
+    }
+
+    std::vector<f32> intrinsics(scene.camera_count() * 4);
+    for (size_t c = 0; c < scene.camera_count(); ++c) {
+        intrinsics[c * 4 + 0] = scene.fx()[c];
+        intrinsics[c * 4 + 1] = scene.fy()[c];
+        intrinsics[c * 4 + 2] = scene.cx()[c];
+        intrinsics[c * 4 + 3] = scene.cy()[c];
+    }
+
+    scnb_header header;
+    header.camera_count = static_cast<u32>(scene.camera_count());
+    header.marker_count = static_cast<u32>(scene.marker_count());
+    header.observation_count = scene.observation_count();
+
+    const std::array<size_t, static_cast<size_t>(scnb_section_kind::count)> sizes{
+        name_offsets.size() * sizeof(u32) + name_offsets.back(),
+        intrinsics.size() * sizeof(f32),
+        scene.offsets().size_bytes(),
+        scene.marker_ids().size_bytes(),
+        scene.u().size_bytes(),
+        scene.v().size_bytes(),
+    };
+
+    size_t offset = align_up(sizeof(scnb_header));
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        header.sections[i] = {static_cast<scnb_section_kind>(i), 0, offset, sizes[i]};
+        offset = align_up(offset + sizes[i]);
+    }
+
+    size_t written = 0;
+    auto emit = [&](std::span<const std::byte> data) -> cc::result<void> {
+        if (auto res = write_all(out, data); !res) {
+            return res;
+        }
+        written += data.size();
+        return cc::ok();
+    };
+
+    const std::array<std::span<const std::byte>, 5> columns{
+        as_bytes_of(std::span<const f32>(intrinsics)),
+        as_bytes_of(scene.offsets()),
+        as_bytes_of(scene.marker_ids()),
+        as_bytes_of(scene.u()),
+        as_bytes_of(scene.v()),
+    };
+
+    if (auto res = emit(std::as_bytes(std::span(&header, 1))); !res) {
+        return res;
+    }
+    if (auto res = write_padding(out, written); !res) {
+        return res;
+    }
+    written = align_up(written);
+
+    if (auto res = emit(as_bytes_of(std::span<const u32>(name_offsets))); !res) {
+        return res;
+    }
+    for (u32 i = 0; i < cameras.size(); ++i) {
+        if (auto res = emit(std::as_bytes(std::span(cameras.name(i)))); !res) {
+            return res;
+        }
+    }
+    for (u32 i = 0; i < markers.size(); ++i) {
+        if (auto res = emit(std::as_bytes(std::span(markers.name(i)))); !res) {
+            return res;
+        }
+    }
+
+    for (const auto& column : columns) {
+        if (auto res = write_padding(out, written); !res) {
+            return res;
+        }
+        written = align_up(written);
+
+        if (auto res = emit(column); !res) {
+            return res;
+        }
+    }
+
+    if (auto res = write_padding(out, written); !res) {
+        return res;
+    }
+
+    out.flush();
+    return cc::ok();
+}
+
+cc::result<void> write_scn(const dense_scene& scene, fstream& out) {
+    CC_PROFILE_SCOPE("io::write_scn");
+    if (!out.is_open()) {
+        return cc::err(cc::error_code::file_write_error, "Stream is not open");
+    }
+
+    //NOTE: floats are written in shortest round-trip form so text -> binary -> text is lossless.
+    // The line buffer fits the longest name plus a keyword and two floats, so no name is cut
+    size_t longest = 0;
+    for (u32 i = 0; i < scene.camera_names().size(); ++i) {
+        longest = std::max(longest, scene.camera_names().name(i).size());
+    }
+    for (u32 i = 0; i < scene.marker_names().size(); ++i) {
+        longest = std::max(longest, scene.marker_names().name(i).size());
+    }
+    std::vector<char> line(longest + 96);
+    auto put_line = [&](char* end) {
+        *end++ = '\n';
+        size_t size = static_cast<size_t>(end - line.data());
+        return write_all(out, std::as_bytes(std::span(line.data(), size)));
+    };
+    auto put_name = [&](char* p, std::string_view name) -> char* {
+        std::memcpy(p, name.data(), name.size());
+        return p + name.size();
+    };
+    auto put_float = [&](char* p, f32 value) -> char* {
+        return std::to_chars(p, line.data() + line.size(), value).ptr;
+    };
+
+    for (camera_id c = 0; c < scene.camera_count(); ++c) {
+        if (c != 0) {
+            if (auto res = put_line(line.data()); !res) {
+                return res;
+            }
+        }
+
+        char* p = line.data();
+        std::memcpy(p, "camera ", 7);
+        if (auto res = put_line(put_name(p + 7, scene.camera_name(c))); !res) {
+            return res;
+        }
+
+        const std::array<std::pair<const char*, f32>, 4> params{{
+            {"fx ", scene.fx()[c]}, {"fy ", scene.fy()[c]}, {"cx ", scene.cx()[c]}, {"cy ", scene.cy()[c]}}};
+        for (const auto& [key, value] : params) {
+            std::memcpy(line.data(), key, 3);
+            if (auto res = put_line(put_float(line.data() + 3, value)); !res) {
+                return res;
+            }
+        }
+
+        auto view = scene.camera(c);
+        for (size_t i = 0; i < view.size(); ++i) {
+            p = line.data();
+            std::memcpy(p, "uv ", 3);
+            p = put_name(p + 3, scene.marker_name(view.markers[i]));
+            *p++ = ' ';
+            p = put_float(p, view.u[i]);
+            *p++ = ' ';
+            p = put_float(p, view.v[i]);
+            if (auto res = put_line(p); !res) {
+                return res;
+            }
+        }
+    }
+
+    out.flush();
+    return cc::ok();
+}
+
+cc::result<void> save_scnb(const dense_scene& scene, const std::filesystem::path& path) {
+    fstream out(path, mode::write);
+    if (!out.is_open()) {
+        return cc::err(cc::error_code::file_access_denied, "Failed to create .scnb file");
+    }
+    return write_scnb(scene, out);
+}
+
+cc::result<void> save_scn(const dense_scene& scene, const std::filesystem::path& path) {
+    fstream out(path, mode::write);
+    if (!out.is_open()) {
+        return cc::err(cc::error_code::file_access_denied, "Failed to create .scn file");
+    }
+    return write_scn(scene, out);
+}
+
+cc::result<void> convert_scn_to_scnb(const std::filesystem::path& src, const std::filesystem::path& dst) {
+    auto scene = load_dense_scene(src);
+    if (!scene) {
+        return cc::err(scene.error());
+    }
+    return save_scnb(*scene, dst);
+}
+
+cc::result<void> convert_scnb_to_scn(const std::filesystem::path& src, const std::filesystem::path& dst) {
+    auto file = scnb_file::open(src);
+    if (!file) {
+        return cc::err(file.error());
+    }
+
+    auto scene = file->view().to_dense();
+    if (!scene) {
+        return cc::err(scene.error());
+    }
+    return save_scn(*scene, dst);
+}
+
+} // namespace cc::io
@@ -0,0 +1,252 @@
+#include "cbox/io/scene/dense.hpp"
+#include "cbox/io/base/metrics.hpp"
+#include "cbox/io/stream/mmap_stream.hpp"
+
+namespace cc::io {
+
+interner::interner(const interner& other)
+: ids_(other.ids_), names_(ids_.size()) {
+    for (const auto& [name, id] : ids_) {
+        names_[id] = &name;
+    }
+}
+
+interner& interner::operator=(const interner& other) {
+    if (this != &other) {
+        ids_ = other.ids_;
+        names_.assign(ids_.size(), nullptr);
+        for (const auto& [name, id] : ids_) {
+            names_[id] = &name;
+        }
+    }
+    return *this;
+}
+
+u32 interner::intern(std::string_view name) {
+    if (auto it = ids_.find(name); it != ids_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<u32>(names_.size());
+    auto [it, inserted] = ids_.emplace(std::string(name), id);
+    names_.push_back(&it->first);
+    return id;
+}
+
+u32 interner::find(std::string_view name) const noexcept {
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : invalid_id;
+}
+
+void interner::reserve(size_t count) {
+    ids_.reserve(count);
+    names_.reserve(count);
+}
+
+void interner::clear() noexcept {
+    ids_.clear();
+    names_.clear();
+}
+
+cc::result<camera_id> dense_scene::add_camera(std::string_view name, f32 fx, f32 fy, f32 cx, f32 cy) {
+    if (cameras_.find(name) != invalid_id) {
+        return cc::err(cc::error_code::validation_invalid_state, "Camera already present in dense scene");
+    }
+
+    camera_id id = cameras_.intern(name);
+    fx_.push_back(fx);
+    fy_.push_back(fy);
+    cx_.push_back(cx);
+    cy_.push_back(cy);
+    offsets_.push_back(offsets_.back());
+    return id;
+}
+
+cc::result<void> dense_scene::add_observation(marker_id marker, f32 u, f32 v) {
+    if (fx_.empty()) {
+        return cc::err(cc::error_code::validation_invalid_state, "Observation added before any camera");
+    }
+    if (marker >= markers_.size()) {
+        return cc::err(cc::error_code::validation_out_of_range, "Unknown marker id");
+    }
+
+    marker_ids_.push_back(marker);
+    u_.push_back(u);
+    v_.push_back(v);
+    ++offsets_.back();
+    return cc::ok();
+}
+
+cc::result<void> dense_scene::add_observation(std::string_view marker, f32 u, f32 v) {
+    if (fx_.empty()) {
+        return cc::err(cc::error_code::validation_invalid_state, "Observation added before any camera");
+    }
+    return add_observation(markers_.intern(marker), u, v);
+}
+
+void dense_scene::set_intrinsics(camera_id id, f32 fx, f32 fy, f32 cx, f32 cy) noexcept {
+    if (id >= camera_count()) {
+        return;
+    }
+    fx_[id] = fx;
+    fy_[id] = fy;
+    cx_[id] = cx;
+    cy_[id] = cy;
+}
+
+camera_view dense_scene::camera(camera_id id) const noexcept {
+    if (id >= camera_count()) {
+        return {};
+    }
+
+    size_t begin = offsets_[id];
+    size_t count = offsets_[id + 1] - begin;
+    return {
+        id,
+        std::span(marker_ids_).subspan(begin, count),
+        std::span(u_).subspan(begin, count),
+        std::span(v_).subspan(begin, count),
+    };
+}
+
+intrinsics dense_scene::camera_intrinsics(camera_id id) const {
+    if (id >= camera_count()) {
+        return {};
+    }
+    return {std::string(cameras_.name(id)), fx_[id], fy_[id], cx_[id], cy_[id]};
+}
+
+pinhole<f32> dense_scene::camera_pinhole(camera_id id) const noexcept {
+    if (id >= camera_count()) {
+        return {};
+    }
+    return {fx_[id], fy_[id], cx_[id], cy_[id]};
+}
+
+void dense_scene::reserve(size_t cameras, size_t observations) {
+    cameras_.reserve(cameras);
+    fx_.reserve(cameras);
+    fy_.reserve(cameras);
+    cx_.reserve(cameras);
+    cy_.reserve(cameras);
+    offsets_.reserve(cameras + 1);
+    marker_ids_.reserve(observations);
+    u_.reserve(observations);
+    v_.reserve(observations);
+}
+
+void dense_scene::clear() noexcept {
+    cameras_.clear();
+    markers_.clear();
+    fx_.clear();
+    fy_.clear();
+    cx_.clear();
+    cy_.clear();
+    offsets_.assign(1, 0);
+    marker_ids_.clear();
+    u_.clear();
+    v_.clear();
+}
+
+cc::result<dense_scene> dense_scene::from_scene(const scene& src) {
+    size_t observations = 0;
+    for (const auto& [name, uvs] : src.uvs()) {
+        observations += uvs.size();
+    }
+
+    dense_scene out;
+    out.reserve(src.cameras().size(), observations);
+
+    for (const auto& cam : src.cameras()) {
+        if (auto id = out.add_camera(cam.name, cam.fx, cam.fy, cam.cx, cam.cy); !id) {
+            return cc::err(id.error());
+        }
+
+        for (const auto& obs : src.uvs_for_camera(cam.name)) {
+            if (auto res = out.add_observation(obs.marker_name, obs.u, obs.v); !res) {
+                return cc::err(res.error());
+            }
+        }
+    }
+    return out;
+}
+
+scene dense_scene::to_scene(std::pmr::memory_resource* resource) const {
+    scene out(resource);
+    out.cameras().reserve(camera_count());
+
+    for (camera_id id = 0; id < camera_count(); ++id) {
+        out.cameras().push_back(camera_intrinsics(id));
+
+        auto view = camera(id);
+        auto& uvs = out.uvs()[out.cameras().back().name];
+        uvs.reserve(view.size());
+        for (size_t i = 0; i < view.size(); ++i) {
+            uvs.emplace_back(std::string(marker_name(view.markers[i])), view.u[i], view.v[i]);
+        }
+    }
+    return out;
+}
+
+cc::result<void> dense_scene_builder::operator()(const scn_record& record) {
+    if (record.tag == scn_tag::camera) {
+        auto id = scene_.add_camera(record.name, 0.0f, 0.0f, 0.0f, 0.0f);
+        if (!id) {
+            return cc::err(id.error());
+        }
+        camera_ = *id;
+        return cc::ok();
+    }
+
+    if (camera_ == invalid_id) {
+        return cc::err(cc::error_code::validation_invalid_state, "Scene record before any camera");
+    }
+
+    switch (record.tag) {
+        case scn_tag::fx: scene_.fx_[camera_] = record.x; break;
+        case scn_tag::fy: scene_.fy_[camera_] = record.x; break;
+        case scn_tag::cx: scene_.cx_[camera_] = record.x; break;
+        case scn_tag::cy: scene_.cy_[camera_] = record.x; break;
+        case scn_tag::uv: return scene_.add_observation(record.name, record.x, record.y);
+        default: break;
+    }
+    return cc::ok();
+}
+
+cc::result<void> reproject_markers(const dense_scene& scene, std::span<const mat4f> world_to_camera,
+                                   const points3f& positions, std::vector<points2f>& out) {
+    CC_PROFILE_SCOPE("io::reproject_markers");
+    if (world_to_camera.size() != scene.camera_count()) {
+        return cc::err(cc::error_code::validation_out_of_range, "Pose count does not match camera count");
+    }
+    if (positions.size() != scene.marker_count()) {
+        return cc::err(cc::error_code::validation_out_of_range, "Position count does not match marker count");
+    }
+
+    out.resize(scene.camera_count());
+    for (camera_id id = 0; id < scene.camera_count(); ++id) {
+        (void)reproject(world_to_camera[id], scene.camera_pinhole(id), positions, out[id]);
+    }
+    return cc::ok();
+}
+
+cc::result<dense_scene> load_dense_scene(const std::filesystem::path& path) {
+    CC_PROFILE_SCOPE("io::load_dense_scene");
+    cc::metrics::timer timer(metric::dense_scene_load_time());
+    mmap_stream stream(path);
+    if (!stream.is_open()) {
+        return cc::err(cc::error_code::file_not_found, "Failed to open scene file");
+    }
+    (void)stream.advise(access_hint::sequential);
+
+    dense_scene out;
+    scn_reader reader(0);
+    if (auto res = reader.parse(stream.bytes(), dense_scene_builder(out)); !res) {
+        return cc::err(res.error());
+    }
+
+    metric::observations_read().add(out.observation_count());
+    return out;
+}
+
+} // namespace cc::io
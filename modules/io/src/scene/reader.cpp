@@ -0,0 +1,155 @@
+#include "cbox/io/scene/reader.hpp"
+#include "cbox/io/base/metrics.hpp"
+#include "cbox/io/stream/mmap_stream.hpp"
+#include <charconv>
+
+namespace cc::io {
+
+namespace {
+
+constexpr bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+std::string_view next_token(std::string_view& line) noexcept {
+    size_t begin = 0;
+    while (begin < line.size() && is_space(line[begin])) {
+        ++begin;
+    }
+
+    size_t end = begin;
+    while (end < line.size() && !is_space(line[end])) {
+        ++end;
+    }
+
+    std::string_view token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
+
+bool parse_float(std::string_view token, f32& out) noexcept {
+    if (token.empty()) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), out);
+    return ec == std::errc{} && ptr == token.data() + token.size();
+}
+
+scn_tag keyword_tag(std::string_view key) noexcept {
+    if (key.size() == 2) {
+        if (key == "uv") return scn_tag::uv;
+        if (key == "fx") return scn_tag::fx;
+        if (key == "fy") return scn_tag::fy;
+        if (key == "cx") return scn_tag::cx;
+        if (key == "cy") return scn_tag::cy;
+    } else if (key == "camera") {
+        return scn_tag::camera;
+    }
+    return scn_tag::none;
+}
+
+} // namespace
+
+cc::result<scn_record> parse_scn_line(std::string_view line) noexcept {
+    std::string_view key = next_token(line);
+    if (key.empty() || key.front() == '#') {
+        return scn_record{};
+    }
+
+    scn_record record;
+    record.tag = keyword_tag(key);
+
+    switch (record.tag) {
+        case scn_tag::camera:
+            record.name = next_token(line);
+            if (record.name.empty()) {
+                return cc::err(cc::error_code::parse_missing_field, "camera record without a name");
+            }
+            break;
+
+        case scn_tag::fx:
+        case scn_tag::fy:
+        case scn_tag::cx:
+        case scn_tag::cy:
+            if (!parse_float(next_token(line), record.x)) {
+                return cc::err(cc::error_code::parse_type_mismatch, "Invalid intrinsic value");
+            }
+            break;
+
+        case scn_tag::uv:
+            record.name = next_token(line);
+            if (record.name.empty()) {
+                return cc::err(cc::error_code::parse_missing_field, "uv record without a marker name");
+            }
+            if (!parse_float(next_token(line), record.x) || !parse_float(next_token(line), record.y)) {
+                return cc::err(cc::error_code::parse_type_mismatch, "Invalid uv coordinate");
+            }
+            break;
+
+        case scn_tag::none:
+            return cc::err(cc::error_code::parse_unexpected_token, "Unknown scene record");
+    }
+
+    if (!next_token(line).empty()) {
+        return cc::err(cc::error_code::parse_unexpected_token, "Trailing tokens in scene record");
+    }
+
+    return record;
+}
+
+cc::result<void> scene_builder::operator()(const scn_record& record) {
+    if (record.tag == scn_tag::camera) {
+        //NOTE: a repeated name would add a second camera whose uvs merge into the first one's list,
+        // rejected the same way dense_scene::add_camera does
+        auto [uvs, inserted] = scene_.uvs().try_emplace(record.name);
+        if (!inserted) {
+            return cc::err(cc::error_code::validation_invalid_state, "Camera already present in scene");
+        }
+        camera_ = &scene_.cameras().emplace_back(std::string(record.name), 0.0f, 0.0f, 0.0f, 0.0f);
+        uvs_ = &uvs->second;
+        return cc::ok();
+    }
+
+    if (!camera_) {
+        return cc::err(cc::error_code::validation_invalid_state, "Scene record before any camera");
+    }
+
+    switch (record.tag) {
+        case scn_tag::fx: camera_->fx = record.x; break;
+        case scn_tag::fy: camera_->fy = record.x; break;
+        case scn_tag::cx: camera_->cx = record.x; break;
+        case scn_tag::cy: camera_->cy = record.x; break;
+        case scn_tag::uv: uvs_->emplace_back(std::string(record.name), record.x, record.y); break;
+        default: break;
+    }
+    return cc::ok();
+}
+
+cc::result<scene> parse_scene(std::string_view text, std::pmr::memory_resource* resource) {
+    CC_PROFILE_SCOPE("io::parse_scene");
+    scene out(resource);
+    scn_reader reader(0);
+    if (auto res = reader.parse(text, scene_builder(out)); !res) {
+        return cc::err(res.error());
+    }
+    return out;
+}
+
+cc::result<scene> load_scene(const std::filesystem::path& path, std::pmr::memory_resource* resource) {
+    CC_PROFILE_SCOPE("io::load_scene");
+    cc::metrics::timer timer(metric::scene_load_time());
+    mmap_stream stream(path);
+    if (!stream.is_open()) {
+        return cc::err(cc::error_code::file_not_found, "Failed to open scene file");
+    }
+    (void)stream.advise(access_hint::sequential);
+
+    scene out(resource);
+    scn_reader reader(0);
+    if (auto res = reader.parse(stream.bytes(), scene_builder(out)); !res) {
+        return cc::err(res.error());
+    }
+    return out;
+}
+
+} // namespace cc::io
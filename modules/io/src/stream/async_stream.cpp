@@ -0,0 +1,684 @@
+#include "cbox/io/stream/async_stream.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <stop_token>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define CBOX_IO_HAS_URING 1
+#endif
+
+namespace cc::io {
+
+namespace {
+
+//NOTE: user_data of the synchronous read()/write() path of async_stream, the low half is a serial
+// so a transfer abandoned after an error can never be taken for a later one
+constexpr u64 sync_tag = ~u64{0} << 32;
+
+constexpr bool is_sync_tag(u64 user_data) noexcept {
+    return (user_data & sync_tag) == sync_tag;
+}
+
+//NOTE: Linux caps a single read/write at this many bytes, larger requests complete short
+constexpr size_t max_transfer = 0x7ffff000;
+
+} // namespace
+
+class io_queue::backend_base {
+public:
+    struct io_request {
+        int fd{-1};
+        u64 offset{0};
+        std::byte* data{nullptr};
+        size_t size{0};
+        u64 user_data{0};
+        bool write{false};
+    };
+
+    explicit backend_base(u32 depth) noexcept
+    : depth_(depth) {}
+
+    virtual ~backend_base() = default;
+
+    [[nodiscard]] virtual io_backend kind() const noexcept = 0;
+    [[nodiscard]] virtual cc::result<void> prepare(const io_request& request) = 0;
+    [[nodiscard]] virtual cc::result<size_t> submit() = 0;
+    [[nodiscard]] virtual cc::result<size_t> complete(std::span<io_completion> out, size_t min_complete) = 0;
+
+    u32 depth_;
+    size_t prepared_{0};
+    size_t in_flight_{0};
+};
+
+namespace {
+
+using io_request = io_queue::backend_base::io_request;
+
+#ifdef CBOX_IO_HAS_URING
+
+int uring_setup(u32 entries, io_uring_params* params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uring_enter(int fd, u32 to_submit, u32 min_complete, u32 flags) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+//NOTE: raw io_uring rings without liburing. We own the SQ tail and the CQ head, the kernel
+// owns the other ends, so only those two indices need release stores and acquire loads
+class uring_backend final : public io_queue::backend_base {
+public:
+    static cc::result<std::unique_ptr<io_queue::backend_base>> create(u32 depth) {
+        io_uring_params params{};
+        int fd = uring_setup(depth, &params);
+        if (fd < 0) {
+            return cc::err(cc::error_code::file_access_denied, "io_uring is not available");
+        }
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+            ::close(fd);
+            return cc::err(cc::error_code::file_access_denied, "Kernel io_uring lacks read/write opcodes");
+        }
+
+        auto backend = std::unique_ptr<uring_backend>(new uring_backend(fd, depth));
+        if (!backend->map(params)) {
+            return cc::err(cc::error_code::file_access_denied, "Failed to map io_uring rings");
+        }
+        return std::unique_ptr<io_queue::backend_base>(std::move(backend));
+    }
+
+    ~uring_backend() override {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqes_bytes_);
+        }
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_bytes_);
+        }
+        if (sq_ring_ != nullptr) {
+            ::munmap(sq_ring_, sq_bytes_);
+        }
+        ::close(fd_);
+    }
+
+    [[nodiscard]] io_backend kind() const noexcept override { return io_backend::uring; }
+
+    [[nodiscard]] cc::result<void> prepare(const io_request& request) override {
+        u32 index = local_tail_ & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = request.fd;
+        sqe.off = request.offset;
+        sqe.addr = reinterpret_cast<u64>(request.data);
+        sqe.len = static_cast<u32>(std::min(request.size, max_transfer));
+        sqe.user_data = request.user_data;
+
+        sq_array_[index] = index;
+        ++local_tail_;
+        return cc::ok();
+    }
+
+    [[nodiscard]] cc::result<size_t> submit() override {
+        u32 to_submit = local_tail_ - submitted_tail_;
+        if (to_submit == 0) {
+            return size_t{0};
+        }
+
+        std::atomic_ref<u32>(*sq_tail_).store(local_tail_, std::memory_order_release);
+        for (;;) {
+            int ret = uring_enter(fd_, to_submit, 0, 0);
+            if (ret >= 0) {
+                submitted_tail_ += static_cast<u32>(ret);
+                return static_cast<size_t>(ret);
+            }
+            if (errno != EINTR) {
+                return cc::err(cc::error_code::file_read_error, "io_uring_enter submit failed");
+            }
+        }
+    }
+
+    [[nodiscard]] cc::result<size_t> complete(std::span<io_completion> out, size_t min_complete) override {
+        size_t count = 0;
+        for (;;) {
+            u32 head = *cq_head_;
+            u32 tail = std::atomic_ref<u32>(*cq_tail_).load(std::memory_order_acquire);
+            while (head != tail && count < out.size()) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                out[count++] = {
+                    cqe.user_data,
+                    cqe.res >= 0 ? static_cast<size_t>(cqe.res) : 0,
+                    cqe.res < 0 ? -cqe.res : 0,
+                };
+                ++head;
+            }
+            std::atomic_ref<u32>(*cq_head_).store(head, std::memory_order_release);
+
+            if (count >= min_complete) {
+                return count;
+            }
+
+            int ret = uring_enter(fd_, 0, static_cast<u32>(min_complete - count), IORING_ENTER_GETEVENTS);
+            if (ret < 0 && errno != EINTR) {
+                return cc::err(cc::error_code::file_read_error, "io_uring_enter wait failed");
+            }
+        }
+    }
+
+private:
+    uring_backend(int fd, u32 depth) noexcept
+    : backend_base(depth), fd_(fd) {}
+
+    bool map(const io_uring_params& params) {
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(u32);
+        cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) {
+            sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        }
+
+        sq_ring_ = map_region(sq_bytes_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == nullptr) {
+            return false;
+        }
+        cq_ring_ = single ? sq_ring_ : map_region(cq_bytes_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == nullptr) {
+            return false;
+        }
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map_region(sqes_bytes_, IORING_OFF_SQES));
+        if (sqes_ == nullptr) {
+            return false;
+        }
+
+        auto* sq = static_cast<std::byte*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<u32*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<std::byte*>(cq_ring_);
+        cq_head_ = reinterpret_cast<u32*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        local_tail_ = submitted_tail_ = *sq_tail_;
+        return true;
+    }
+
+    void* map_region(size_t bytes, off_t offset) const noexcept {
+        void* ptr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    int fd_;
+
+    void* sq_ring_{nullptr};
+    void* cq_ring_{nullptr};
+    io_uring_sqe* sqes_{nullptr};
+    size_t sq_bytes_{0};
+    size_t cq_bytes_{0};
+    size_t sqes_bytes_{0};
+
+    u32* sq_tail_{nullptr};
+    u32* sq_array_{nullptr};
+    u32 sq_mask_{0};
+    u32 local_tail_{0};
+    u32 submitted_tail_{0};
+
+    u32* cq_head_{nullptr};
+    u32* cq_tail_{nullptr};
+    u32 cq_mask_{0};
+    io_uring_cqe* cqes_{nullptr};
+};
+
+#endif
+
+class pool_backend;
+
+//NOTE: the worker threads behind every pool_backend, started on first use and shared by all queues
+// of the process so opening many streams does not multiply threads. Requests of all queues wait in
+// one FIFO, each completion goes back to the queue that submitted it
+class io_workers {
+public:
+    [[nodiscard]] static io_workers& instance() {
+        static io_workers workers;
+        return workers;
+    }
+
+    void push(pool_backend* owner, std::span<const io_request> requests) {
+        {
+            std::lock_guard lock(mutex_);
+            for (const auto& request : requests) {
+                queue_.emplace_back(owner, request);
+            }
+        }
+        cv_.notify_all();
+    }
+
+    //NOTE: drops the requests of `owner` no worker has picked up yet and returns their count
+    size_t cancel(const pool_backend* owner) {
+        std::lock_guard lock(mutex_);
+        return std::erase_if(queue_, [owner](const auto& entry) { return entry.first == owner; });
+    }
+
+private:
+    io_workers() {
+        size_t count = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this](std::stop_token stop) { run(stop); });
+        }
+    }
+
+    void run(std::stop_token stop);
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<std::pair<pool_backend*, io_request>> queue_;
+
+    std::vector<std::jthread> workers_;
+};
+
+//NOTE: fallback backend, the shared io_workers run blocking pread/pwrite for submitted requests
+class pool_backend final : public io_queue::backend_base {
+public:
+    explicit pool_backend(u32 depth)
+    : backend_base(depth), workers_(io_workers::instance()) {}
+
+    //NOTE: a running request still writes into its completion list, wait for those
+    ~pool_backend() override {
+        size_t cancelled = workers_.cancel(this);
+        std::unique_lock lock(mutex_);
+        outstanding_ -= cancelled;
+        done_cv_.wait(lock, [this] { return outstanding_ == 0; });
+    }
+
+    [[nodiscard]] io_backend kind() const noexcept override { return io_backend::thread_pool; }
+
+    [[nodiscard]] cc::result<void> prepare(const io_request& request) override {
+        prepared_requests_.push_back(request);
+        return cc::ok();
+    }
+
+    [[nodiscard]] cc::result<size_t> submit() override {
+        size_t count = prepared_requests_.size();
+        if (count == 0) {
+            return size_t{0};
+        }
+        {
+            std::lock_guard lock(mutex_);
+            outstanding_ += count;
+        }
+        workers_.push(this, prepared_requests_);
+        prepared_requests_.clear();
+        return count;
+    }
+
+    [[nodiscard]] cc::result<size_t> complete(std::span<io_completion> out, size_t min_complete) override {
+        std::unique_lock lock(mutex_);
+        done_cv_.wait(lock, [&] { return done_.size() >= min_complete; });
+
+        size_t count = std::min(out.size(), done_.size());
+        std::copy_n(done_.begin(), count, out.begin());
+        done_.erase(done_.begin(), done_.begin() + static_cast<std::ptrdiff_t>(count));
+        return count;
+    }
+
+    static io_completion execute(const io_request& request) noexcept {
+        io_completion completion{request.user_data, 0, 0};
+        while (completion.bytes < request.size) {
+            size_t size = std::min(request.size - completion.bytes, max_transfer);
+            auto offset = static_cast<off_t>(request.offset + completion.bytes);
+            ssize_t ret = request.write ? ::pwrite(request.fd, request.data + completion.bytes, size, offset)
+                                        : ::pread(request.fd, request.data + completion.bytes, size, offset);
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                completion.error = errno;
+                break;
+            }
+            if (ret == 0) {
+                break;
+            }
+            completion.bytes += static_cast<size_t>(ret);
+        }
+        return completion;
+    }
+
+    //NOTE: called by a worker, `this` must not be touched once the lock is released
+    void finish(const io_completion& completion) {
+        std::lock_guard lock(mutex_);
+        done_.push_back(completion);
+        --outstanding_;
+        done_cv_.notify_all();
+    }
+
+private:
+    io_workers& workers_;
+    std::vector<io_request> prepared_requests_;
+
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+    std::deque<io_completion> done_;
+    size_t outstanding_{0};
+};
+
+void io_workers::run(std::stop_token stop) {
+    std::unique_lock lock(mutex_);
+    while (cv_.wait(lock, stop, [this] { return !queue_.empty(); })) {
+        auto [owner, request] = queue_.front();
+        queue_.pop_front();
+
+        lock.unlock();
+        owner->finish(pool_backend::execute(request));
+        lock.lock();
+    }
+}
+
+} // namespace
+
+async_file::async_file(const std::filesystem::path& path, mode mode)
+: path_(path) {
+    int flags = O_CLOEXEC;
+    switch (mode) {
+        case mode::read:
+            flags |= O_RDONLY;
+            break;
+        case mode::write:
+            flags |= O_WRONLY | O_CREAT | O_TRUNC;
+            break;
+        case mode::read_write:
+            flags |= O_RDWR;
+            break;
+    }
+
+    fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) {
+        cc::log::Error("Failed to open file: {}", path.string());
+    }
+}
+
+async_file::~async_file() {
+    close();
+}
+
+async_file::async_file(async_file&& other) noexcept
+: path_(std::move(other.path_)), fd_(std::exchange(other.fd_, -1)) {}
+
+async_file& async_file::operator=(async_file&& other) noexcept {
+    if (this != &other) {
+        close();
+        path_ = std::move(other.path_);
+        fd_ = std::exchange(other.fd_, -1);
+    }
+    return *this;
+}
+
+size_t async_file::size() const {
+    struct stat st{};
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+        return 0;
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
+void async_file::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+cc::result<io_queue> io_queue::create(u32 depth, io_backend backend) {
+    if (depth == 0) {
+        return cc::err(cc::error_code::validation_out_of_range, "io_queue depth must be positive");
+    }
+
+    if (backend != io_backend::thread_pool) {
+#ifdef CBOX_IO_HAS_URING
+        auto uring = uring_backend::create(depth);
+        if (uring) {
+            return io_queue(std::move(*uring));
+        }
+        if (backend == io_backend::uring) {
+            return cc::err(uring.error());
+        }
+#else
+        if (backend == io_backend::uring) {
+            return cc::err(cc::error_code::file_access_denied, "io_uring is not available in this build");
+        }
+#endif
+    }
+    return io_queue(std::make_unique<pool_backend>(depth));
+}
+
+io_queue::io_queue(std::unique_ptr<backend_base> impl) noexcept
+: impl_(std::move(impl)) {}
+
+io_queue::~io_queue() = default;
+
+io_queue::io_queue(io_queue&& other) noexcept = default;
+io_queue& io_queue::operator=(io_queue&& other) noexcept = default;
+
+io_backend io_queue::backend() const noexcept {
+    return impl_->kind();
+}
+
+u32 io_queue::depth() const noexcept {
+    return impl_->depth_;
+}
+
+size_t io_queue::pending() const noexcept {
+    return impl_->prepared_ + impl_->in_flight_;
+}
+
+cc::result<void> io_queue::prepare_read(const async_file& file, u64 offset, std::span<std::byte> buffer, u64 user_data) {
+    if (pending() >= impl_->depth_) {
+        return cc::err(cc::error_code::validation_invalid_state, "io_queue is full");
+    }
+    if (auto res = impl_->prepare({file.handle(), offset, buffer.data(), buffer.size(), user_data, false}); !res) {
+        return res;
+    }
+    ++impl_->prepared_;
+    return cc::ok();
+}
+
+cc::result<void> io_queue::prepare_write(const async_file& file, u64 offset, std::span<const std::byte> data, u64 user_data) {
+    if (pending() >= impl_->depth_) {
+        return cc::err(cc::error_code::validation_invalid_state, "io_queue is full");
+    }
+    //NOTE: the backends never write through the pointer of a write request
+    auto* bytes = const_cast<std::byte*>(data.data());
+    if (auto res = impl_->prepare({file.handle(), offset, bytes, data.size(), user_data, true}); !res) {
+        return res;
+    }
+    ++impl_->prepared_;
+    return cc::ok();
+}
+
+cc::result<size_t> io_queue::submit() {
+    auto submitted = impl_->submit();
+    if (!submitted) {
+        return submitted;
+    }
+    impl_->prepared_ -= *submitted;
+    impl_->in_flight_ += *submitted;
+    return submitted;
+}
+
+cc::result<size_t> io_queue::complete(std::span<io_completion> out, size_t min_complete) {
+    if (impl_->prepared_ > 0) {
+        if (auto res = submit(); !res) {
+            return res;
+        }
+    }
+
+    min_complete = std::min({min_complete, impl_->in_flight_, out.size()});
+    auto completed = impl_->complete(out, min_complete);
+    if (!completed) {
+        return completed;
+    }
+    impl_->in_flight_ -= *completed;
+    return completed;
+}
+
+async_stream::async_stream(const std::filesystem::path& path, mode mode, u32 depth, io_backend backend)
+: file_(path, mode) {
+    if (!file_.is_open()) {
+        return;
+    }
+
+    auto queue = io_queue::create(depth, backend);
+    if (!queue) {
+        queue.error().log();
+        return;
+    }
+    queue_.emplace(std::move(*queue));
+}
+
+size_t async_stream::read_impl(std::span<std::byte> buffer) {
+    size_t bytes_read = transfer(pos_, buffer.data(), buffer.size(), false);
+    pos_ += bytes_read;
+    return bytes_read;
+}
+
+size_t async_stream::write_impl(std::span<const std::byte> data) {
+    size_t written = transfer(pos_, const_cast<std::byte*>(data.data()), data.size(), true);
+    pos_ += written;
+    return written;
+}
+
+void async_stream::flush_impl() {
+    //NOTE: nothing is buffered here, a transfer is done once its completion is returned
+}
+
+bool async_stream::is_open_impl() const noexcept {
+    return file_.is_open() && queue_.has_value();
+}
+
+cc::result<void> async_stream::prepare_read(u64 offset, std::span<std::byte> buffer, u64 user_data) {
+    if (!queue_) {
+        return cc::err(cc::error_code::validation_invalid_state, "Stream is not open");
+    }
+    return queue_->prepare_read(file_, offset, buffer, user_data);
+}
+
+cc::result<void> async_stream::prepare_write(u64 offset, std::span<const std::byte> data, u64 user_data) {
+    if (!queue_) {
+        return cc::err(cc::error_code::validation_invalid_state, "Stream is not open");
+    }
+    return queue_->prepare_write(file_, offset, data, user_data);
+}
+
+cc::result<size_t> async_stream::submit() {
+    if (!queue_) {
+        return cc::err(cc::error_code::validation_invalid_state, "Stream is not open");
+    }
+    return queue_->submit();
+}
+
+cc::result<size_t> async_stream::complete(std::span<io_completion> out, size_t min_complete) {
+    if (!queue_) {
+        return cc::err(cc::error_code::validation_invalid_state, "Stream is not open");
+    }
+
+    //NOTE: completions harvested by a synchronous read()/write() are handed out first. The stash is
+    // only trimmed once the queue call succeeded, so an error does not lose them
+    size_t count = std::min(out.size(), stash_.size());
+    std::copy_n(stash_.begin(), count, out.begin());
+
+    //NOTE: completions of abandoned synchronous transfers are dropped, which may take another round
+    size_t filled = count;
+    size_t wanted = min_complete > count ? min_complete - count : 0;
+    for (;;) {
+        auto more = queue_->complete(out.subspan(filled), wanted);
+        if (!more) {
+            if (filled == count) {
+                return more;
+            }
+            break;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < *more; ++i) {
+            if (!is_sync_tag(out[filled + i].user_data)) {
+                out[filled + kept++] = out[filled + i];
+            }
+        }
+        filled += kept;
+        wanted = wanted > kept ? wanted - kept : 0;
+        if (wanted == 0 || *more == 0) {
+            break;
+        }
+    }
+
+    stash_.erase(stash_.begin(), stash_.begin() + static_cast<std::ptrdiff_t>(count));
+    return filled;
+}
+
+io_backend async_stream::backend() const noexcept {
+    return queue_ ? queue_->backend() : io_backend::automatic;
+}
+
+size_t async_stream::transfer(u64 offset, std::byte* data, size_t size, bool write) {
+    if (!is_open_impl()) {
+        return 0;
+    }
+
+    //NOTE: a completion carrying another sync tag belongs to a transfer that returned early on an
+    // error, it is dropped instead of being stashed or taken for this one
+    auto harvest = [this](io_completion& completion) -> bool {
+        auto res = queue_->complete(std::span(&completion, 1));
+        if (!res || *res == 0) {
+            return false;
+        }
+        if (!is_sync_tag(completion.user_data)) {
+            stash_.push_back(completion);
+        }
+        return true;
+    };
+
+    size_t done = 0;
+    io_completion completion{};
+    while (done < size) {
+        while (queue_->pending() >= queue_->depth()) {
+            if (!harvest(completion)) {
+                return done;
+            }
+        }
+
+        u64 tag = sync_tag | (sync_serial_++ & ~sync_tag);
+        auto prepared = write ? queue_->prepare_write(file_, offset + done, {data + done, size - done}, tag)
+                              : queue_->prepare_read(file_, offset + done, {data + done, size - done}, tag);
+        if (!prepared) {
+            return done;
+        }
+
+        do {
+            if (!harvest(completion)) {
+                return done;
+            }
+        } while (completion.user_data != tag);
+
+        if (!completion.ok() || completion.bytes == 0) {
+            break;
+        }
+        done += completion.bytes;
+    }
+    return done;
+}
+
+} // namespace cc::io
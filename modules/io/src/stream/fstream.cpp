@@ -78,6 +78,7 @@ cc::result<std::string> fstream::read_line() {
 }
 
 void fstream::seek(size_t pos) {
+    stream_.clear();
     stream_.seekg(pos);
 }
 
@@ -85,6 +86,12 @@ size_t fstream::tell() const {
     return const_cast<std::fstream&>(stream_).tellg();
 }
 
+size_t fstream::size() const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path_, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+}
+
 const std::filesystem::path& fstream::path() const noexcept {
     return path_;
 }
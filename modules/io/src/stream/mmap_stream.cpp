@@ -0,0 +1,198 @@
+#include "cbox/io/stream/mmap_stream.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace cc::io {
+
+namespace {
+
+size_t page_size() noexcept {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+int to_madvise(access_hint hint) noexcept {
+    switch (hint) {
+        case access_hint::sequential: return MADV_SEQUENTIAL;
+        case access_hint::random: return MADV_RANDOM;
+        case access_hint::will_need: return MADV_WILLNEED;
+        case access_hint::normal:
+        default: return MADV_NORMAL;
+    }
+}
+
+} // namespace
+
+mmap_stream::mmap_stream(const std::filesystem::path& path, size_t window_budget)
+: path_(path) {
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        cc::log::Error("Failed to open file: {}", path.string());
+        return;
+    }
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        cc::log::Error("Failed to stat file: {}", path.string());
+        close();
+        return;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    if (window_budget != 0) {
+        window_budget_ = std::max(page_size(), window_budget / page_size() * page_size());
+    }
+
+    if (size_ != 0 && !map_window(0, window_budget_ ? window_budget_ : size_)) {
+        cc::log::Error("Failed to map file: {}", path.string());
+        close();
+    }
+}
+
+mmap_stream::~mmap_stream() {
+    close();
+}
+
+mmap_stream::mmap_stream(mmap_stream&& other) noexcept
+    : path_(std::move(other.path_))
+    , fd_(std::exchange(other.fd_, -1))
+    , size_(std::exchange(other.size_, 0))
+    , pos_(std::exchange(other.pos_, 0))
+    , window_budget_(other.window_budget_)
+    , map_(std::exchange(other.map_, nullptr))
+    , map_offset_(std::exchange(other.map_offset_, 0))
+    , map_length_(std::exchange(other.map_length_, 0))
+    , hint_(other.hint_) {}
+
+mmap_stream& mmap_stream::operator=(mmap_stream&& other) noexcept {
+    if (this != &other) {
+        close();
+        path_ = std::move(other.path_);
+        fd_ = std::exchange(other.fd_, -1);
+        size_ = std::exchange(other.size_, 0);
+        pos_ = std::exchange(other.pos_, 0);
+        window_budget_ = other.window_budget_;
+        map_ = std::exchange(other.map_, nullptr);
+        map_offset_ = std::exchange(other.map_offset_, 0);
+        map_length_ = std::exchange(other.map_length_, 0);
+        hint_ = other.hint_;
+    }
+    return *this;
+}
+
+size_t mmap_stream::read_impl(std::span<std::byte> buffer) {
+    size_t total = 0;
+    while (total < buffer.size() && pos_ < size_) {
+        if (!ensure_mapped(pos_)) {
+            break;
+        }
+
+        size_t window_pos = pos_ - map_offset_;
+        size_t count = std::min(buffer.size() - total, map_length_ - window_pos);
+        std::copy_n(map_ + window_pos, count, buffer.data() + total);
+
+        total += count;
+        pos_ += count;
+    }
+    return total;
+}
+
+size_t mmap_stream::write_impl(std::span<const std::byte>) {
+    return 0;
+}
+
+void mmap_stream::flush_impl() {}
+
+bool mmap_stream::is_open_impl() const noexcept {
+    return fd_ >= 0;
+}
+
+std::span<const std::byte> mmap_stream::bytes() const noexcept {
+    return {map_, map_length_};
+}
+
+cc::result<void> mmap_stream::map_window(size_t offset, size_t length) {
+    if (fd_ < 0) {
+        return cc::err(cc::error_code::validation_invalid_state, "File is not open");
+    }
+    if (offset >= size_) {
+        return cc::err(cc::error_code::validation_out_of_range, "Window offset past end of file");
+    }
+
+    //NOTE: the mapping starts on the page holding `offset`, that lead-in counts against the budget.
+    // The budget is whole pages, so the window still reaches at least one byte past `offset`
+    size_t aligned = offset / page_size() * page_size();
+    size_t span_len = std::min(length + (offset - aligned), size_ - aligned);
+    if (window_budget_ != 0) {
+        span_len = std::min(span_len, window_budget_);
+    }
+
+    if (map_ && aligned == map_offset_ && span_len == map_length_) {
+        return cc::ok();
+    }
+
+    unmap();
+
+    void* addr = ::mmap(nullptr, span_len, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(aligned));
+    if (addr == MAP_FAILED) {
+        return cc::err(cc::error_code::file_read_error, "mmap failed");
+    }
+
+    map_ = static_cast<std::byte*>(addr);
+    map_offset_ = aligned;
+    map_length_ = span_len;
+
+    if (hint_ != access_hint::normal) {
+        ::madvise(map_, map_length_, to_madvise(hint_));
+    }
+    return cc::ok();
+}
+
+cc::result<void> mmap_stream::advise(access_hint hint) {
+    hint_ = hint;
+    if (!map_) {
+        return cc::ok();
+    }
+    if (::madvise(map_, map_length_, to_madvise(hint)) != 0) {
+        return cc::err(cc::error_code::validation_invalid_state, "madvise failed");
+    }
+    return cc::ok();
+}
+
+void mmap_stream::seek(size_t pos) {
+    pos_ = std::min(pos, size_);
+}
+
+const std::filesystem::path& mmap_stream::path() const noexcept {
+    return path_;
+}
+
+bool mmap_stream::ensure_mapped(size_t pos) {
+    if (map_ && pos >= map_offset_ && pos < map_offset_ + map_length_) {
+        return true;
+    }
+    return map_window(pos, window_budget_ ? window_budget_ : size_ - pos).has_value();
+}
+
+void mmap_stream::unmap() noexcept {
+    if (map_) {
+        ::munmap(map_, map_length_);
+        map_ = nullptr;
+        map_offset_ = 0;
+        map_length_ = 0;
+    }
+}
+
+void mmap_stream::close() noexcept {
+    unmap();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+} // namespace cc::io
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "points.hpp"
+#include "../mat/fwd.hpp"
+#include "../mat/mat4.hpp"
+#include "../pose/affine3.hpp"
+#include "../pose/rigid3.hpp"
+#include <cstddef>
+
+//NOTE: whole batch kernels over points<N, T>, compiled in scalar, AVX2 and AVX-512 variants and
+// picked at startup with cc::cpu::dispatch (cc::cpu::force selects a variant for tests). Outputs
+// are resized to the input, and an output may be the input itself. Defined for float and double
+namespace cc {
+
+//NOTE: applies the affine part of `m` (the bottom row is ignored)
+template<floating_point T>
+void transform(const mat<4, 4, T>& m, const points3<T>& in, points3<T>& out);
+
+//NOTE: camera space to pixels, u = fx * x / z + cx. Points with z <= 0 come out as NaN, returns
+// how many are in front of the camera
+template<floating_point T>
+std::size_t project(const pinhole<T>& k, const points3<T>& in, points2<T>& out);
+
+//NOTE: transform and project in one pass, no camera space batch is written
+template<floating_point T>
+std::size_t reproject(const mat<4, 4, T>& world_to_camera, const pinhole<T>& k, const points3<T>& in,
+                      points2<T>& out);
+
+template<floating_point T>
+void transform(const affine3<T>& a, const points3<T>& in, points3<T>& out) {
+    transform(a.to_mat4(), in, out);
+}
+
+template<floating_point T>
+void transform(const rigid3<T>& r, const points3<T>& in, points3<T>& out) {
+    transform(r.to_mat4(), in, out);
+}
+
+template<floating_point T>
+std::size_t reproject(const affine3<T>& world_to_camera, const pinhole<T>& k, const points3<T>& in,
+                      points2<T>& out) {
+    return reproject(world_to_camera.to_mat4(), k, in, out);
+}
+
+template<floating_point T>
+std::size_t reproject(const rigid3<T>& world_to_camera, const pinhole<T>& k, const points3<T>& in,
+                      points2<T>& out) {
+    return reproject(world_to_camera.to_mat4(), k, in, out);
+}
+
+//NOTE: pixels to the normalized image plane, x = (u - cx) / fx
+template<floating_point T>
+void normalize(const pinhole<T>& k, const points2<T>& in, points2<T>& out);
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../vec/fwd.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace cc {
+
+//NOTE: pinhole camera, the same four numbers io::intrinsics stores
+template<floating_point T>
+struct pinhole {
+    T fx{1};
+    T fy{1};
+    T cx{0};
+    T cy{0};
+};
+
+namespace detail {
+
+template<typename T, std::size_t Align>
+struct aligned_allocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = aligned_allocator<U, Align>; };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Align});
+    }
+
+    template<typename U>
+    friend constexpr bool operator==(const aligned_allocator&, const aligned_allocator<U, Align>&) noexcept {
+        return true;
+    }
+};
+
+} // namespace detail
+
+//NOTE: struct-of-arrays batch of N dimensional points, one column per component. Columns start
+// on a cache line so batch kernels load whole vectors of one component at a time
+template<std::size_t N, floating_point T>
+requires(N == 2 || N == 3)
+class points {
+public:
+    static constexpr std::size_t dims = N;
+    static constexpr std::size_t alignment = 64;
+    using value_type = T;
+    using column = std::vector<T, detail::aligned_allocator<T, alignment>>;
+
+    points() = default;
+
+    explicit points(std::size_t count) { resize(count); }
+
+    explicit points(std::span<const vec<N, T>> values) {
+        reserve(values.size());
+        for (const auto& v : values) {
+            push_back(v);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return cols_[0].size(); }
+    [[nodiscard]] bool empty() const noexcept { return cols_[0].empty(); }
+
+    void resize(std::size_t count) {
+        for (auto& c : cols_) {
+            c.resize(count);
+        }
+    }
+
+    void reserve(std::size_t count) {
+        for (auto& c : cols_) {
+            c.reserve(count);
+        }
+    }
+
+    void clear() noexcept {
+        for (auto& c : cols_) {
+            c.clear();
+        }
+    }
+
+    void push_back(const vec<N, T>& v) {
+        for (std::size_t d = 0; d < N; ++d) {
+            cols_[d].push_back(v[d]);
+        }
+    }
+
+    [[nodiscard]] vec<N, T> operator[](std::size_t i) const noexcept {
+        assert(i < size());
+        if constexpr (N == 2) {
+            return {cols_[0][i], cols_[1][i]};
+        } else {
+            return {cols_[0][i], cols_[1][i], cols_[2][i]};
+        }
+    }
+
+    void set(std::size_t i, const vec<N, T>& v) noexcept {
+        assert(i < size());
+        for (std::size_t d = 0; d < N; ++d) {
+            cols_[d][i] = v[d];
+        }
+    }
+
+    [[nodiscard]] T* data(std::size_t d) noexcept { return cols_[d].data(); }
+    [[nodiscard]] const T* data(std::size_t d) const noexcept { return cols_[d].data(); }
+
+    [[nodiscard]] std::span<T> x() noexcept { return cols_[0]; }
+    [[nodiscard]] std::span<const T> x() const noexcept { return cols_[0]; }
+    [[nodiscard]] std::span<T> y() noexcept { return cols_[1]; }
+    [[nodiscard]] std::span<const T> y() const noexcept { return cols_[1]; }
+    [[nodiscard]] std::span<T> z() noexcept requires(N == 3) { return cols_[2]; }
+    [[nodiscard]] std::span<const T> z() const noexcept requires(N == 3) { return cols_[2]; }
+
+private:
+    std::array<column, N> cols_;
+};
+
+template<floating_point T> using points2 = points<2, T>;
+template<floating_point T> using points3 = points<3, T>;
+
+using points2f = points2<float>;
+using points3f = points3<float>;
+using points2d = points2<double>;
+using points3d = points3<double>;
+
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+//NOTE: kept out of math.hpp, the decompositions depend on cbox::core for cc::result and each
+// size instantiated costs seconds of compile time
+// IWYU pragma: begin_exports
+#include "decomp/lu.hpp"
+#include "decomp/qr.hpp"
+#include "decomp/ldlt.hpp"
+#include "decomp/svd.hpp"
+// IWYU pragma: end_exports
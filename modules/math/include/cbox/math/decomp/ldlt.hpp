@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/decomp.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+#include "../vec/vec4.hpp"
+#include "../mat/base.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <cbox/core/result.hpp>
+#include <array>
+#include <cstddef>
+
+namespace cc {
+
+//NOTE: A = L D L^T for a symmetric A, only the lower triangle is read. The square root free form of
+// Cholesky, so it also takes semidefinite matrices (normal equations of a degenerate fit): a pivot
+// at or below the rank tolerance becomes zero with an empty L column and lowers the rank. No
+// pivoting, an indefinite A factors only if no leading minor vanishes
+template<std::size_t N, floating_point T>
+class ldlt {
+public:
+    using matrix_type = mat<N, N, T>;
+    using vector_type = vec<N, T>;
+
+    constexpr explicit ldlt(const matrix_type& a) noexcept : l_(matrix_type::identity()) {
+        T scale = T{0};
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t i = j; i < N; ++i) {
+                scale = max(scale, detail::decomp::abs(a(i, j)));
+            }
+        }
+        T tol = detail::decomp::tolerance<N, N>(scale);
+
+        detail::decomp::unroll<0, N>([&](auto j) {
+            //NOTE: l_(j, k) * d_[k] of the row being finished, reused by every row below it
+            std::array<T, N> ld{};
+            T dj = a(j, j);
+            detail::decomp::unroll<0, j>([&](auto k) {
+                ld[k] = l_(j, k) * d_[k];
+                dj -= ld[k] * l_(j, k);
+            });
+
+            if (detail::decomp::abs(dj) <= tol) {
+                d_[j] = T{0};
+                positive_ = false;
+                return;
+            }
+            d_[j] = dj;
+            ++rank_;
+            if (dj < T{0}) positive_ = false;
+
+            T inv = T{1} / dj;
+            detail::decomp::unroll<j + 1, N>([&](auto i) {
+                T acc = a(i, j);
+                detail::decomp::unroll<0, j>([&](auto k) { acc -= l_(i, k) * ld[k]; });
+                l_(i, j) = acc * inv;
+            });
+        });
+    }
+
+    constexpr std::size_t rank() const noexcept { return rank_; }
+    constexpr bool invertible() const noexcept { return rank_ == N; }
+
+    //NOTE: every pivot above the tolerance and positive, the matrix is symmetric positive definite
+    constexpr bool positive() const noexcept { return positive_; }
+
+    constexpr T det() const noexcept {
+        T r = T{1};
+        for (std::size_t i = 0; i < N; ++i) {
+            r *= d_[i];
+        }
+        return r;
+    }
+
+    constexpr const matrix_type& l() const noexcept { return l_; }
+
+    constexpr vector_type d() const noexcept {
+        vector_type v{};
+        for (std::size_t i = 0; i < N; ++i) {
+            v[i] = d_[i];
+        }
+        return v;
+    }
+
+    //NOTE: the Cholesky factor L sqrt(D), A = C C^T
+    constexpr result<matrix_type> cholesky() const noexcept {
+        if (!positive_) {
+            return err(error_code::validation_invalid_state, "Cholesky of a matrix that is not positive definite");
+        }
+        matrix_type c{};
+        for (std::size_t j = 0; j < N; ++j) {
+            T s = detail::decomp::sqrt(d_[j]);
+            for (std::size_t i = j; i < N; ++i) {
+                c(i, j) = l_(i, j) * s;
+            }
+        }
+        return c;
+    }
+
+    constexpr result<vector_type> solve(const vector_type& b) const noexcept {
+        if (rank_ < N) {
+            return err(error_code::validation_invalid_state, "LDLT solve on a singular matrix");
+        }
+        std::array<T, N> x{};
+        for (std::size_t i = 0; i < N; ++i) {
+            x[i] = b[i];
+        }
+        substitute(x);
+
+        vector_type out{};
+        for (std::size_t i = 0; i < N; ++i) {
+            out[i] = x[i];
+        }
+        return out;
+    }
+
+    template<std::size_t K>
+    constexpr result<mat<N, K, T>> solve(const mat<N, K, T>& b) const noexcept {
+        if (rank_ < N) {
+            return err(error_code::validation_invalid_state, "LDLT solve on a singular matrix");
+        }
+        mat<N, K, T> out{};
+        for (std::size_t j = 0; j < K; ++j) {
+            std::array<T, N> x{};
+            for (std::size_t i = 0; i < N; ++i) {
+                x[i] = b(i, j);
+            }
+            substitute(x);
+            for (std::size_t i = 0; i < N; ++i) {
+                out(i, j) = x[i];
+            }
+        }
+        return out;
+    }
+
+    constexpr result<matrix_type> inverse() const noexcept {
+        return solve(matrix_type::identity());
+    }
+
+private:
+    constexpr void substitute(std::array<T, N>& x) const noexcept {
+        detail::decomp::unroll<1, N>([&](auto i) {
+            detail::decomp::unroll<0, i>([&](auto j) { x[i] -= l_(i, j) * x[j]; });
+        });
+        detail::decomp::unroll<0, N>([&](auto i) { x[i] /= d_[i]; });
+        detail::decomp::unroll<0, N>([&](auto n) {
+            constexpr std::size_t i = N - 1 - n;
+            detail::decomp::unroll<i + 1, N>([&](auto j) { x[i] -= l_(j, i) * x[j]; });
+        });
+    }
+
+    matrix_type l_;
+    std::array<T, N> d_{};
+    std::size_t rank_ = 0;
+    bool positive_ = true;
+};
+
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/decomp.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+#include "../vec/vec4.hpp"
+#include "../mat/base.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <cbox/core/result.hpp>
+#include <array>
+#include <cstddef>
+
+namespace cc {
+
+//NOTE: P A Q = L U with rook pivoting, factored in the constructor. L (unit diagonal) and U share
+// one matrix. A pivot at or below the rank tolerance leaves its column uneliminated and lowers the
+// rank, and solve/inverse then fail instead of returning garbage. Exchanging columns as well as
+// rows keeps the last pivots of a rank deficient matrix at the rounding level; with rows alone
+// they are that noise amplified by the conditioning of the rows above, and 1 to 3 percent of
+// singular matrices came out full rank. Meant for the small fixed sizes of geometry code:
+// everything is on the stack and unrolled per size, and usable in constant expressions
+template<std::size_t N, floating_point T>
+class lu {
+public:
+    using matrix_type = mat<N, N, T>;
+    using vector_type = vec<N, T>;
+
+    constexpr explicit lu(const matrix_type& a) noexcept : lu_(a) {
+        for (std::size_t i = 0; i < N; ++i) {
+            row_perm_[i] = i;
+            col_perm_[i] = i;
+        }
+        T tol = detail::decomp::tolerance<N, N>(detail::decomp::max_abs(a));
+
+        detail::decomp::unroll<0, N>([&](auto k_) {
+            constexpr std::size_t k = k_;
+            //NOTE: the pivot is the largest entry of both its row and its column, usually found
+            // after a scan or two where a search of the whole block costs as much as the
+            // elimination. Every round moves to a strictly larger entry, so the scans end. Which
+            // entry wins is data dependent, so they are selects instead of branches
+            std::size_t prow = k;
+            std::size_t pcol = k;
+            T best = detail::decomp::abs(lu_(k, k));
+            detail::decomp::unroll<k + 1, N>([&](auto r) {
+                T v = detail::decomp::abs(lu_(r, k));
+                bool larger = v > best;
+                best = larger ? v : best;
+                prow = larger ? std::size_t{r} : prow;
+            });
+            for (;;) {
+                std::size_t col = pcol;
+                detail::decomp::unroll<k, N>([&](auto c) {
+                    T v = detail::decomp::abs(lu_(prow, c));
+                    bool larger = v > best;
+                    best = larger ? v : best;
+                    col = larger ? std::size_t{c} : col;
+                });
+                if (col == pcol) break;
+                pcol = col;
+
+                std::size_t row = prow;
+                detail::decomp::unroll<k, N>([&](auto r) {
+                    T v = detail::decomp::abs(lu_(r, pcol));
+                    bool larger = v > best;
+                    best = larger ? v : best;
+                    row = larger ? std::size_t{r} : row;
+                });
+                if (row == prow) break;
+                prow = row;
+            }
+
+            //NOTE: up to 4x4 the swaps are selects against every candidate row and column, which keeps
+            // all indices constant and the matrix in registers. Above that the N (N - k) selects cost
+            // more than the mispredicted branch of a swap through the runtime pivot index
+            if constexpr (N <= 4) {
+                detail::decomp::unroll<k + 1, N>([&](auto r) {
+                    bool take = prow == r;
+                    detail::decomp::unroll<0, N>([&](auto c) {
+                        T x = lu_(k, c), y = lu_(r, c);
+                        lu_(k, c) = take ? y : x;
+                        lu_(r, c) = take ? x : y;
+                    });
+                });
+                detail::decomp::unroll<k + 1, N>([&](auto c) {
+                    bool take = pcol == c;
+                    detail::decomp::unroll<0, N>([&](auto r) {
+                        T x = lu_(r, k), y = lu_(r, c);
+                        lu_(r, k) = take ? y : x;
+                        lu_(r, c) = take ? x : y;
+                    });
+                });
+            } else {
+                if (prow != k) {
+                    detail::decomp::unroll<0, N>([&](auto c) {
+                        detail::decomp::swap(lu_(k, c), lu_(prow, c));
+                    });
+                }
+                if (pcol != k) {
+                    detail::decomp::unroll<0, N>([&](auto r) {
+                        detail::decomp::swap(lu_(r, k), lu_(r, pcol));
+                    });
+                }
+            }
+            detail::decomp::swap(row_perm_[k], row_perm_[prow]);
+            detail::decomp::swap(col_perm_[k], col_perm_[pcol]);
+            odd_ ^= (prow != k) != (pcol != k);
+
+            if (best <= tol) {
+                detail::decomp::unroll<k + 1, N>([&](auto r) { lu_(r, k) = T{0}; });
+                return;
+            }
+            ++rank_;
+
+            T inv = T{1} / lu_(k, k);
+            detail::decomp::unroll<k + 1, N>([&](auto r) { lu_(r, k) *= inv; });
+            detail::decomp::unroll<k + 1, N>([&](auto c) {
+                T u = lu_(k, c);
+                detail::decomp::unroll<k + 1, N>([&](auto r) { lu_(r, c) -= lu_(r, k) * u; });
+            });
+        });
+    }
+
+    constexpr std::size_t rank() const noexcept { return rank_; }
+    constexpr bool invertible() const noexcept { return rank_ == N; }
+
+    //NOTE: zero once the matrix is numerically singular
+    constexpr T det() const noexcept {
+        if (rank_ < N) return T{0};
+        T d = odd_ ? T{-1} : T{1};
+        for (std::size_t i = 0; i < N; ++i) {
+            d *= lu_(i, i);
+        }
+        return d;
+    }
+
+    //NOTE: row i of P A is row row_permutation()[i] of A
+    constexpr const std::array<std::size_t, N>& row_permutation() const noexcept { return row_perm_; }
+
+    //NOTE: column j of A Q is column column_permutation()[j] of A
+    constexpr const std::array<std::size_t, N>& column_permutation() const noexcept { return col_perm_; }
+
+    //NOTE: L below the diagonal, U on and above it
+    constexpr const matrix_type& packed() const noexcept { return lu_; }
+
+    constexpr matrix_type l() const noexcept {
+        matrix_type m = matrix_type::identity();
+        for (std::size_t c = 0; c < N; ++c) {
+            for (std::size_t r = c + 1; r < N; ++r) {
+                m(r, c) = lu_(r, c);
+            }
+        }
+        return m;
+    }
+
+    constexpr matrix_type u() const noexcept {
+        matrix_type m{};
+        for (std::size_t c = 0; c < N; ++c) {
+            for (std::size_t r = 0; r <= c; ++r) {
+                m(r, c) = lu_(r, c);
+            }
+        }
+        return m;
+    }
+
+    constexpr result<vector_type> solve(const vector_type& b) const noexcept {
+        if (rank_ < N) {
+            return err(error_code::validation_invalid_state, "LU solve on a singular matrix");
+        }
+        std::array<T, N> x{};
+        for (std::size_t i = 0; i < N; ++i) {
+            x[i] = b[row_perm_[i]];
+        }
+        substitute(x);
+
+        vector_type out{};
+        for (std::size_t i = 0; i < N; ++i) {
+            out[col_perm_[i]] = x[i];
+        }
+        return out;
+    }
+
+    template<std::size_t K>
+    constexpr result<mat<N, K, T>> solve(const mat<N, K, T>& b) const noexcept {
+        if (rank_ < N) {
+            return err(error_code::validation_invalid_state, "LU solve on a singular matrix");
+        }
+        mat<N, K, T> out{};
+        for (std::size_t j = 0; j < K; ++j) {
+            std::array<T, N> x{};
+            for (std::size_t i = 0; i < N; ++i) {
+                x[i] = b(row_perm_[i], j);
+            }
+            substitute(x);
+            for (std::size_t i = 0; i < N; ++i) {
+                out(col_perm_[i], j) = x[i];
+            }
+        }
+        return out;
+    }
+
+    //NOTE: unlike cc::inverse, a singular matrix is an error and not the identity
+    constexpr result<matrix_type> inverse() const noexcept {
+        return solve(matrix_type::identity());
+    }
+
+private:
+    //NOTE: forward substitution with the unit L, then back substitution with U, on an already
+    // row permuted right hand side. The result is Q^T x
+    constexpr void substitute(std::array<T, N>& x) const noexcept {
+        detail::decomp::unroll<1, N>([&](auto i) {
+            detail::decomp::unroll<0, i>([&](auto j) { x[i] -= lu_(i, j) * x[j]; });
+        });
+        detail::decomp::unroll<0, N>([&](auto n) {
+            constexpr std::size_t i = N - 1 - n;
+            detail::decomp::unroll<i + 1, N>([&](auto j) { x[i] -= lu_(i, j) * x[j]; });
+            x[i] /= lu_(i, i);
+        });
+    }
+
+    matrix_type lu_;
+    std::array<std::size_t, N> row_perm_{};
+    std::array<std::size_t, N> col_perm_{};
+    std::size_t rank_ = 0;
+    bool odd_ = false;
+};
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/decomp.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+#include "../vec/vec4.hpp"
+#include "../mat/base.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <cbox/core/result.hpp>
+#include <array>
+#include <cstddef>
+
+namespace cc {
+
+//NOTE: A P = Q R by Householder reflections with column pivoting, for square and tall matrices.
+// R sits on and above the diagonal and the reflectors below it (their leading 1 implied), Q is
+// never formed unless asked for. Each step takes the remaining column of largest norm, so the
+// diagonal of R does not increase and a rank deficient matrix ends in pivots at the rounding
+// level instead of pivots amplified by the conditioning of the columns before them. solve() is
+// the least squares solution of an overdetermined system
+template<std::size_t R, std::size_t C, floating_point T>
+requires(R >= C)
+class qr {
+public:
+    using matrix_type = mat<R, C, T>;
+
+    constexpr explicit qr(const matrix_type& a) noexcept : qr_(a) {
+        //NOTE: squared norms of the columns left, below the rows already reduced. Each step
+        // recomputes them while it updates the columns instead of downdating, which loses digits
+        // once a column is mostly eliminated
+        std::array<T, C> norms{};
+        for (std::size_t j = 0; j < C; ++j) {
+            perm_[j] = j;
+            for (std::size_t i = 0; i < R; ++i) {
+                norms[j] += qr_(i, j) * qr_(i, j);
+            }
+        }
+        T tol = detail::decomp::tolerance<R, C>(detail::decomp::max_abs(a));
+
+        detail::decomp::unroll<0, C>([&](auto k_) {
+            constexpr std::size_t k = k_;
+            std::size_t pivot = k;
+            T maxn = norms[k];
+            detail::decomp::unroll<k + 1, C>([&](auto j) {
+                bool larger = norms[j] > maxn;
+                maxn = larger ? norms[j] : maxn;
+                pivot = larger ? std::size_t{j} : pivot;
+            });
+
+            //NOTE: selects up to 4 columns, a branch on the runtime index above, as in lu
+            if constexpr (C <= 4) {
+                detail::decomp::unroll<k + 1, C>([&](auto j) {
+                    bool take = pivot == j;
+                    detail::decomp::unroll<0, R>([&](auto i) {
+                        T x = qr_(i, k), y = qr_(i, j);
+                        qr_(i, k) = take ? y : x;
+                        qr_(i, j) = take ? x : y;
+                    });
+                });
+            } else if (pivot != k) {
+                detail::decomp::unroll<0, R>([&](auto i) {
+                    detail::decomp::swap(qr_(i, k), qr_(i, pivot));
+                });
+            }
+            detail::decomp::swap(perm_[k], perm_[pivot]);
+            norms[pivot] = norms[k];
+
+            T alpha = qr_(k, k);
+            T tail = T{0};
+            detail::decomp::unroll<k + 1, R>([&](auto i) { tail += qr_(i, k) * qr_(i, k); });
+
+            if (tail != T{0}) {
+                T beta = detail::decomp::sqrt(alpha * alpha + tail);
+                if (alpha > T{0}) beta = -beta;
+                tau_[k] = (beta - alpha) / beta;
+                T scale = T{1} / (alpha - beta);
+                detail::decomp::unroll<k + 1, R>([&](auto i) { qr_(i, k) *= scale; });
+                qr_(k, k) = beta;
+
+                detail::decomp::unroll<k + 1, C>([&](auto j) {
+                    T w = qr_(k, j);
+                    detail::decomp::unroll<k + 1, R>([&](auto i) { w += qr_(i, k) * qr_(i, j); });
+                    w *= tau_[k];
+                    qr_(k, j) -= w;
+                    T n = T{0};
+                    detail::decomp::unroll<k + 1, R>([&](auto i) {
+                        qr_(i, j) -= w * qr_(i, k);
+                        n += qr_(i, j) * qr_(i, j);
+                    });
+                    norms[j] = n;
+                });
+            } else {
+                detail::decomp::unroll<k + 1, C>([&](auto j) {
+                    T n = T{0};
+                    detail::decomp::unroll<k + 1, R>([&](auto i) { n += qr_(i, j) * qr_(i, j); });
+                    norms[j] = n;
+                });
+            }
+
+            if (detail::decomp::abs(qr_(k, k)) > tol) {
+                ++rank_;
+            }
+        });
+    }
+
+    constexpr std::size_t rank() const noexcept { return rank_; }
+    constexpr bool full_rank() const noexcept { return rank_ == C; }
+
+    //NOTE: column j of A P is column permutation()[j] of A
+    constexpr const std::array<std::size_t, C>& permutation() const noexcept { return perm_; }
+
+    //NOTE: R on and above the diagonal, reflectors below it
+    constexpr const matrix_type& packed() const noexcept { return qr_; }
+
+    //NOTE: the thin Q, R x C with orthonormal columns, Q r() is A P
+    constexpr matrix_type q() const noexcept {
+        matrix_type m{};
+        for (std::size_t j = 0; j < C; ++j) {
+            std::array<T, R> col{};
+            col[j] = T{1};
+            detail::decomp::unroll<0, C>([&](auto n) { reflect<C - 1 - n>(col); });
+            for (std::size_t i = 0; i < R; ++i) {
+                m(i, j) = col[i];
+            }
+        }
+        return m;
+    }
+
+    constexpr mat<C, C, T> r() const noexcept {
+        mat<C, C, T> m{};
+        for (std::size_t c = 0; c < C; ++c) {
+            for (std::size_t i = 0; i <= c; ++i) {
+                m(i, c) = qr_(i, c);
+            }
+        }
+        return m;
+    }
+
+    //NOTE: minimizes |A x - b|, the exact solution when A is square
+    constexpr result<vec<C, T>> solve(const vec<R, T>& b) const noexcept {
+        if (rank_ < C) {
+            return err(error_code::validation_invalid_state, "QR solve on a rank deficient matrix");
+        }
+        std::array<T, R> y{};
+        for (std::size_t i = 0; i < R; ++i) {
+            y[i] = b[i];
+        }
+        detail::decomp::unroll<0, C>([&](auto k) { reflect<k>(y); });
+
+        std::array<T, C> z{};
+        detail::decomp::unroll<0, C>([&](auto n) {
+            constexpr std::size_t i = C - 1 - n;
+            T acc = y[i];
+            detail::decomp::unroll<i + 1, C>([&](auto j) { acc -= qr_(i, j) * z[j]; });
+            z[i] = acc / qr_(i, i);
+        });
+
+        vec<C, T> x{};
+        for (std::size_t i = 0; i < C; ++i) {
+            x[perm_[i]] = z[i];
+        }
+        return x;
+    }
+
+private:
+    //NOTE: applies H_k = I - tau_k v_k v_k^T, H_k is its own inverse so this serves Q and Q^T
+    template<std::size_t K>
+    constexpr void reflect(std::array<T, R>& x) const noexcept {
+        if (tau_[K] == T{0}) return;
+        T w = x[K];
+        detail::decomp::unroll<K + 1, R>([&](auto i) { w += qr_(i, K) * x[i]; });
+        w *= tau_[K];
+        x[K] -= w;
+        detail::decomp::unroll<K + 1, R>([&](auto i) { x[i] -= w * qr_(i, K); });
+    }
+
+    matrix_type qr_;
+    std::array<T, C> tau_{};
+    std::array<std::size_t, C> perm_{};
+    std::size_t rank_ = 0;
+};
+
+}
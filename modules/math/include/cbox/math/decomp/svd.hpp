@@ -0,0 +1,212 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/decomp.hpp"
+#include "../vec/base.hpp"
+#include "../vec/vec2.hpp"
+#include "../vec/vec3.hpp"
+#include "../vec/vec4.hpp"
+#include "../mat/base.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <cbox/core/result.hpp>
+#include <array>
+#include <cstddef>
+
+namespace cc {
+
+//NOTE: A = U S V^T by one sided Jacobi: plane rotations orthogonalize the columns of A, their
+// lengths are the singular values and the accumulated rotations are V. Slower than bidiagonal
+// QR on large matrices, but simple, accurate for small singular values, and at the sizes here
+// (DLT systems up to about 12 columns) a few sweeps converge.
+//
+// Any shape is accepted. U is R x C and S holds C values sorted largest first; when R < C the
+// trailing C - R values are zero. U columns of zero singular values are left zero, V is always
+// a full orthonormal basis, so null_vector() works for the underdetermined DLT systems
+template<std::size_t R, std::size_t C, floating_point T>
+class svd {
+public:
+    using matrix_type = mat<R, C, T>;
+
+    static constexpr int max_sweeps = 32;
+
+    constexpr explicit svd(const matrix_type& a) noexcept : u_(a), v_(mat<C, C, T>::identity()) {
+        //NOTE: a column this short is zero up to rounding, its noise would otherwise keep the
+        // sweeps going forever against the relative test below. A column that drops under it
+        // stops being rotated, so it stays under the rank tolerance: max(R, C) eps |A|_F is at
+        // most max(R, C) sqrt(C) eps s_0
+        T frob = T{0};
+        for (std::size_t j = 0; j < C; ++j) {
+            for (std::size_t i = 0; i < R; ++i) {
+                frob += a(i, j) * a(i, j);
+            }
+        }
+        T negligible = static_cast<T>(R > C ? R : C) * epsilon<T> * detail::decomp::sqrt(frob);
+        negligible *= negligible;
+
+        bool rotated = true;
+        for (int sweep = 0; sweep < max_sweeps && rotated; ++sweep) {
+            rotated = false;
+            for (std::size_t p = 0; p + 1 < C; ++p) {
+                for (std::size_t q = p + 1; q < C; ++q) {
+                    T alpha = T{0}, beta = T{0}, gamma = T{0};
+                    for (std::size_t i = 0; i < R; ++i) {
+                        alpha += u_(i, p) * u_(i, p);
+                        beta += u_(i, q) * u_(i, q);
+                        gamma += u_(i, p) * u_(i, q);
+                    }
+                    //NOTE: |gamma| <= eps sqrt(alpha beta) without the square roots, the negligible
+                    // test keeps alpha * beta clear of underflow
+                    if (alpha <= negligible || beta <= negligible ||
+                        gamma * gamma <= epsilon<T> * epsilon<T> * alpha * beta) {
+                        continue;
+                    }
+                    rotated = true;
+
+                    //NOTE: t is the tangent of the rotation angle, the smaller root of
+                    // t^2 + 2 zeta t - 1 with zeta = (beta - alpha) / (2 gamma). Once |zeta| passes
+                    // 1 / eps, t = 1 / (2 zeta) is exact and zeta itself may not be representable
+                    T diff = beta - alpha;
+                    T t;
+                    if (detail::decomp::abs(T{2} * gamma) < detail::decomp::abs(diff) * epsilon<T>) {
+                        t = gamma / diff;
+                    } else {
+                        T zeta = diff / (T{2} * gamma);
+                        t = T{1} / (detail::decomp::abs(zeta) + detail::decomp::sqrt(T{1} + zeta * zeta));
+                        if (zeta < T{0}) t = -t;
+                    }
+                    T c = T{1} / detail::decomp::sqrt(T{1} + t * t);
+                    T s = c * t;
+                    rotate(u_, p, q, c, s);
+                    rotate(v_, p, q, c, s);
+                }
+            }
+        }
+        converged_ = !rotated;
+
+        for (std::size_t j = 0; j < C; ++j) {
+            T n = T{0};
+            for (std::size_t i = 0; i < R; ++i) {
+                n += u_(i, j) * u_(i, j);
+            }
+            s_[j] = detail::decomp::sqrt(n);
+        }
+
+        //NOTE: selection sort, at most C swaps of a U and a V column
+        for (std::size_t j = 0; j + 1 < C; ++j) {
+            std::size_t best = j;
+            for (std::size_t k = j + 1; k < C; ++k) {
+                if (s_[k] > s_[best]) best = k;
+            }
+            if (best != j) {
+                detail::decomp::swap(s_[j], s_[best]);
+                detail::decomp::swap(u_[j], u_[best]);
+                detail::decomp::swap(v_[j], v_[best]);
+            }
+        }
+
+        T tol = detail::decomp::tolerance<R, C>(s_[0]);
+        for (std::size_t j = 0; j < C; ++j) {
+            if (s_[j] > tol) {
+                ++rank_;
+                T inv = T{1} / s_[j];
+                for (std::size_t i = 0; i < R; ++i) {
+                    u_(i, j) *= inv;
+                }
+            } else {
+                for (std::size_t i = 0; i < R; ++i) {
+                    u_(i, j) = T{0};
+                }
+            }
+        }
+    }
+
+    constexpr std::size_t rank() const noexcept { return rank_; }
+
+    //NOTE: false when max_sweeps ran out with columns still not orthogonal, the factors are then
+    // only approximate and solve() refuses
+    constexpr bool converged() const noexcept { return converged_; }
+
+    constexpr const matrix_type& u() const noexcept { return u_; }
+    constexpr const mat<C, C, T>& v() const noexcept { return v_; }
+
+    constexpr vec<C, T> singular_values() const noexcept {
+        vec<C, T> s{};
+        for (std::size_t j = 0; j < C; ++j) {
+            s[j] = s_[j];
+        }
+        return s;
+    }
+
+    //NOTE: ratio of the largest to the smallest singular value, infinity when rank deficient
+    constexpr T cond() const noexcept {
+        return s_[C - 1] > T{0} ? s_[0] / s_[C - 1] : infinity<T>;
+    }
+
+    //NOTE: the unit x minimizing |A x|, the last column of V. The DLT solution of triangulation
+    // and homography estimation
+    constexpr vec<C, T> null_vector() const noexcept {
+        vec<C, T> x{};
+        for (std::size_t i = 0; i < C; ++i) {
+            x[i] = v_(i, C - 1);
+        }
+        return x;
+    }
+
+    //NOTE: the minimum norm least squares solution, singular values below the rank tolerance are
+    // dropped instead of inverted. Works for any rank, fails only if the iteration did not converge
+    constexpr result<vec<C, T>> solve(const vec<R, T>& b) const noexcept {
+        if (!converged_) {
+            return err(error_code::validation_invalid_state, "SVD did not converge");
+        }
+        vec<C, T> x{};
+        for (std::size_t j = 0; j < rank_; ++j) {
+            T w = T{0};
+            for (std::size_t i = 0; i < R; ++i) {
+                w += u_(i, j) * b[i];
+            }
+            w /= s_[j];
+            for (std::size_t i = 0; i < C; ++i) {
+                x[i] += v_(i, j) * w;
+            }
+        }
+        return x;
+    }
+
+    constexpr result<mat<C, R, T>> pseudo_inverse() const noexcept {
+        if (!converged_) {
+            return err(error_code::validation_invalid_state, "SVD did not converge");
+        }
+        mat<C, R, T> m{};
+        for (std::size_t j = 0; j < rank_; ++j) {
+            T inv = T{1} / s_[j];
+            for (std::size_t c = 0; c < R; ++c) {
+                T w = u_(c, j) * inv;
+                for (std::size_t r = 0; r < C; ++r) {
+                    m(r, c) += v_(r, j) * w;
+                }
+            }
+        }
+        return m;
+    }
+
+private:
+    template<std::size_t M>
+    static constexpr void rotate(mat<M, C, T>& m, std::size_t p, std::size_t q, T c, T s) noexcept {
+        for (std::size_t i = 0; i < M; ++i) {
+            T mp = m(i, p);
+            T mq = m(i, q);
+            m(i, p) = c * mp - s * mq;
+            m(i, q) = s * mp + c * mq;
+        }
+    }
+
+    matrix_type u_;
+    mat<C, C, T> v_;
+    std::array<T, C> s_{};
+    std::size_t rank_ = 0;
+    bool converged_ = false;
+};
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "arithmetic.hpp"
+#include "../common/functions.hpp"
+#include "../common/constants.hpp"
+#include "../mat/fwd.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace cc::detail::decomp {
+
+//NOTE: std::sqrt is only usable in constant expressions as a GCC extension. Under consteval the
+// argument is scaled into [1/4, 4] and a few Newton steps from 1 get within an ulp of it
+template<floating_point T>
+constexpr T sqrt(T v) noexcept {
+    if consteval {
+        if (v != v || v == infinity<T>) return v;
+        if (v < T{0}) return std::numeric_limits<T>::quiet_NaN();
+        if (v == T{0}) return T{0};
+
+        T scale = T{1};
+        while (v > T{4}) {
+            v *= T{0.25};
+            scale *= T{2};
+        }
+        while (v < T{0.25}) {
+            v *= T{4};
+            scale *= T{0.5};
+        }
+        T r = T{1};
+        for (int i = 0; i < 8; ++i) {
+            r = T{0.5} * (r + v / r);
+        }
+        return r * scale;
+    } else {
+        return std::sqrt(v);
+    }
+}
+
+//NOTE: cc::abs is a ternary that GCC keeps as a compare and branch, which mispredicts on the
+// random signs of a pivot search. fabs is a single mask
+template<floating_point T>
+constexpr T abs(T v) noexcept {
+    if consteval {
+        return v < T{0} ? -v : v;
+    } else {
+        return std::fabs(v);
+    }
+}
+
+template<std::size_t R, std::size_t C, floating_point T>
+constexpr T max_abs(const mat<R, C, T>& a) noexcept {
+    T m = T{0};
+    for (std::size_t j = 0; j < C; ++j) {
+        for (std::size_t i = 0; i < R; ++i) {
+            m = max(m, decomp::abs(a(i, j)));
+        }
+    }
+    return m;
+}
+
+//NOTE: values at or below 2 n sqrt(n) eps scale count as zero, n = max(R, C). The usual
+// n eps scale is too tight: on random n x n matrices with a row that is the sum of two others,
+// the rounding left in the last singular value reaches 2.1 n eps scale at n = 12 and the last
+// pivot of lu and qr 1.0 n eps scale. The extra 2 sqrt(n) leaves a margin of 2.5 from 3x3 to
+// 12x12. In float it also zeroes full rank matrices with a condition number above about 1e5
+template<std::size_t R, std::size_t C, floating_point T>
+constexpr T tolerance(T scale) noexcept {
+    constexpr std::size_t n = R > C ? R : C;
+    return T{2} * static_cast<T>(n) * decomp::sqrt(static_cast<T>(n)) * epsilon<T> * scale;
+}
+
+//NOTE: f(integral_constant<I>) for I in [Begin, End), expanded at compile time. The triangular
+// loops of the factorizations have trip counts like N - k - 1 that the loop vectorizer handles
+// with prologues and remainders costing more than the few lanes they fill, unrolled every index
+// and bound is a constant
+template<std::size_t Begin, std::size_t End, typename F>
+constexpr void unroll(F&& f) noexcept {
+    if constexpr (Begin < End) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (f(std::integral_constant<std::size_t, Begin + I>{}), ...);
+        }(std::make_index_sequence<End - Begin>{});
+    }
+}
+
+template<typename T>
+constexpr void swap(T& a, T& b) noexcept {
+    T tmp = a;
+    a = b;
+    b = tmp;
+}
+
+} // namespace cc::detail::decomp
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <type_traits>
+
+//NOTE: 4 lane kernels for the float mat4/vec4 operations and the affine product. Written with
+// GCC/Clang vector extensions, so the same code lowers to SSE/AVX on x86 and NEON on ARM for
+// whatever ISA the translation unit targets. Other compilers and CBOX_MATH_NO_SIMD builds use the
+// scalar code.
+//
+// Nothing here may depend on the ISA macros (__AVX__ and friends). These are inline functions,
+// and translation units built with different -m flags must still see one definition of every
+// kernel and of the mat4 operators that select them
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(CBOX_MATH_NO_SIMD)
+#define CBOX_MATH_SIMD 1
+#else
+#define CBOX_MATH_SIMD 0
+#endif
+
+#if CBOX_MATH_SIMD
+
+#define CBOX_SIMD_INLINE inline __attribute__((always_inline))
+
+namespace cc::detail::simd {
+
+using f32x4 = float __attribute__((vector_size(16)));
+
+template<typename T> struct lanes;
+template<> struct lanes<float> { using type = f32x4; };
+
+//NOTE: no 4 lane double. It needs 32 byte registers to gain anything, which only exist with AVX,
+// and as two 16 byte halves it measured slower than the scalar code
+
+template<typename T>
+inline constexpr bool enabled = requires { typename lanes<T>::type; };
+
+template<typename T>
+using v4 = typename lanes<T>::type;
+
+template<typename T> inline constexpr bool fast_transpose = enabled<T>;
+template<typename T> inline constexpr bool fast_det = enabled<T>;
+
+template<typename T>
+CBOX_SIMD_INLINE v4<T> load(const T* p) noexcept {
+    v4<T> v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+template<typename T>
+CBOX_SIMD_INLINE void store(T* p, v4<T> v) noexcept {
+    __builtin_memcpy(p, &v, sizeof(v));
+}
+
+//NOTE: lanes 0-3 pick from `a`, 4-7 from `b`
+template<int X, int Y, int Z, int W, typename V>
+CBOX_SIMD_INLINE V shuffle(V a, V b) noexcept {
+    return __builtin_shufflevector(a, b, X, Y, Z, W);
+}
+
+template<int X, int Y, int Z, int W, typename V>
+CBOX_SIMD_INLINE V swizzle(V a) noexcept {
+    return shuffle<X, Y, Z, W>(a, a);
+}
+
+//NOTE: c0 * w[0] + c1 * w[1] + c2 * w[2] + c3 * w[3], one output column of a product. One load
+// and a splat per lane, which SSE and NEON need and AVX lowers to register broadcasts
+template<typename T>
+CBOX_SIMD_INLINE v4<T> combine(v4<T> c0, v4<T> c1, v4<T> c2, v4<T> c3, const T* w) noexcept {
+    v4<T> v = load(w);
+    return c0 * swizzle<0, 0, 0, 0>(v) + c1 * swizzle<1, 1, 1, 1>(v) + c2 * swizzle<2, 2, 2, 2>(v) +
+           c3 * swizzle<3, 3, 3, 3>(v);
+}
+
+//NOTE: all matrices are four columns of four, `out` may alias the inputs
+template<typename T>
+CBOX_SIMD_INLINE void mat4_mul(const T* a, const T* b, T* out) noexcept {
+    v4<T> a0 = load(a), a1 = load(a + 4), a2 = load(a + 8), a3 = load(a + 12);
+    v4<T> r0 = combine(a0, a1, a2, a3, b);
+    v4<T> r1 = combine(a0, a1, a2, a3, b + 4);
+    v4<T> r2 = combine(a0, a1, a2, a3, b + 8);
+    v4<T> r3 = combine(a0, a1, a2, a3, b + 12);
+    store(out, r0);
+    store(out + 4, r1);
+    store(out + 8, r2);
+    store(out + 12, r3);
+}
+
+//NOTE: the vector side is splat lane by lane from scalars. A vec4 is usually just built from
+// scalar stores, and reading it back as one vector stalls on store forwarding
+template<typename T>
+CBOX_SIMD_INLINE void mat4_mul_vec(const T* m, const T* v, T* out) noexcept {
+    store(out, load(m) * v[0] + load(m + 4) * v[1] + load(m + 8) * v[2] + load(m + 12) * v[3]);
+}
+
+template<typename T>
+CBOX_SIMD_INLINE void transpose4(v4<T>& c0, v4<T>& c1, v4<T>& c2, v4<T>& c3) noexcept {
+    v4<T> t0 = shuffle<0, 4, 1, 5>(c0, c1);
+    v4<T> t1 = shuffle<0, 4, 1, 5>(c2, c3);
+    v4<T> t2 = shuffle<2, 6, 3, 7>(c0, c1);
+    v4<T> t3 = shuffle<2, 6, 3, 7>(c2, c3);
+    c0 = shuffle<0, 1, 4, 5>(t0, t1);
+    c1 = shuffle<2, 3, 6, 7>(t0, t1);
+    c2 = shuffle<0, 1, 4, 5>(t2, t3);
+    c3 = shuffle<2, 3, 6, 7>(t2, t3);
+}
+
+template<typename T>
+CBOX_SIMD_INLINE void mat4_transpose(const T* m, T* out) noexcept {
+    v4<T> c0 = load(m), c1 = load(m + 4), c2 = load(m + 8), c3 = load(m + 12);
+    transpose4<T>(c0, c1, c2, c3);
+    store(out, c0);
+    store(out + 4, c1);
+    store(out + 8, c2);
+    store(out + 12, c3);
+}
+
+//NOTE: v * m, a dot product of `v` with every column
+template<typename T>
+CBOX_SIMD_INLINE void vec_mul_mat4(const T* v, const T* m, T* out) noexcept {
+    v4<T> c0 = load(m), c1 = load(m + 4), c2 = load(m + 8), c3 = load(m + 12);
+    transpose4<T>(c0, c1, c2, c3);
+    store(out, c0 * v[0] + c1 * v[1] + c2 * v[2] + c3 * v[3]);
+}
+
+//NOTE: a 2x2 block held in one vector as (b00, b01, b10, b11)
+template<typename V>
+CBOX_SIMD_INLINE V mat2_mul(V a, V b) noexcept {
+    return a * swizzle<0, 3, 0, 3>(b) + swizzle<1, 0, 3, 2>(a) * swizzle<2, 1, 2, 1>(b);
+}
+
+//NOTE: adj(a) * b
+template<typename V>
+CBOX_SIMD_INLINE V mat2_adj_mul(V a, V b) noexcept {
+    return swizzle<3, 3, 0, 0>(a) * b - swizzle<1, 1, 2, 2>(a) * swizzle<2, 3, 0, 1>(b);
+}
+
+//NOTE: a * adj(b)
+template<typename V>
+CBOX_SIMD_INLINE V mat2_mul_adj(V a, V b) noexcept {
+    return a * swizzle<3, 0, 3, 0>(b) - swizzle<1, 0, 3, 2>(a) * swizzle<2, 1, 2, 1>(b);
+}
+
+//NOTE: 2x2 block inverse. The kernel reads the four columns as the rows of the transpose,
+// inverts that and writes rows back as columns, which gives the inverse of the original since
+// inv(Mt) = inv(M)t. The blocks of the transpose are
+//
+//   A B    A = rows 0-1 cols 0-1, B = rows 0-1 cols 2-3
+//   C D    C = rows 2-3 cols 0-1, D = rows 2-3 cols 2-3
+//
+// det(M) = |A||D| + |B||C| - tr(adj(A)B adj(D)C), the inverse blocks are built from the same
+// adjugate products. Returns the determinant, `out` is only written when `|det| > eps`
+template<typename T>
+CBOX_SIMD_INLINE T mat4_inverse(const T* m, T* out, T eps) noexcept {
+    using V = v4<T>;
+    V r0 = load(m), r1 = load(m + 4), r2 = load(m + 8), r3 = load(m + 12);
+
+    V a = shuffle<0, 1, 4, 5>(r0, r1);
+    V b = shuffle<2, 3, 6, 7>(r0, r1);
+    V c = shuffle<0, 1, 4, 5>(r2, r3);
+    V d = shuffle<2, 3, 6, 7>(r2, r3);
+
+    //NOTE: (|A|, |B|, |C|, |D|)
+    V det_sub = shuffle<0, 2, 4, 6>(r0, r2) * shuffle<1, 3, 5, 7>(r1, r3) -
+                shuffle<1, 3, 5, 7>(r0, r2) * shuffle<0, 2, 4, 6>(r1, r3);
+    V det_a = swizzle<0, 0, 0, 0>(det_sub);
+    V det_b = swizzle<1, 1, 1, 1>(det_sub);
+    V det_c = swizzle<2, 2, 2, 2>(det_sub);
+    V det_d = swizzle<3, 3, 3, 3>(det_sub);
+
+    V d_c = mat2_adj_mul(d, c);
+    V a_b = mat2_adj_mul(a, b);
+
+    V tr = a_b * swizzle<0, 2, 1, 3>(d_c);
+    T det = det_sub[0] * det_sub[3] + det_sub[1] * det_sub[2] - ((tr[0] + tr[1]) + (tr[2] + tr[3]));
+    if (!(det > eps || det < -eps)) {
+        return det;
+    }
+
+    V x = det_d * a - mat2_mul(b, d_c);
+    V w = det_a * d - mat2_mul(c, a_b);
+    V y = det_b * c - mat2_mul_adj(d, a_b);
+    V z = det_c * b - mat2_mul_adj(a, d_c);
+
+    //NOTE: (1, -1, -1, 1) / det applies the adjugate signs of every block
+    T inv = T{1} / det;
+    V scale{inv, -inv, -inv, inv};
+    x *= scale;
+    y *= scale;
+    z *= scale;
+    w *= scale;
+
+    store(out, shuffle<3, 1, 7, 5>(x, y));
+    store(out + 4, shuffle<2, 0, 6, 4>(x, y));
+    store(out + 8, shuffle<3, 1, 7, 5>(z, w));
+    store(out + 12, shuffle<2, 0, 6, 4>(z, w));
+    return det;
+}
+
+template<typename T>
+CBOX_SIMD_INLINE T mat4_det(const T* m) noexcept {
+    using V = v4<T>;
+    V r0 = load(m), r1 = load(m + 4), r2 = load(m + 8), r3 = load(m + 12);
+
+    V a = shuffle<0, 1, 4, 5>(r0, r1);
+    V b = shuffle<2, 3, 6, 7>(r0, r1);
+    V c = shuffle<0, 1, 4, 5>(r2, r3);
+    V d = shuffle<2, 3, 6, 7>(r2, r3);
+
+    V det_sub = shuffle<0, 2, 4, 6>(r0, r2) * shuffle<1, 3, 5, 7>(r1, r3) -
+                shuffle<1, 3, 5, 7>(r0, r2) * shuffle<0, 2, 4, 6>(r1, r3);
+    V tr = mat2_adj_mul(a, b) * swizzle<0, 2, 1, 3>(mat2_adj_mul(d, c));
+    return det_sub[0] * det_sub[3] + det_sub[1] * det_sub[2] - ((tr[0] + tr[1]) + (tr[2] + tr[3]));
+}
+
+//NOTE: 3x4 affine transforms stored as three rows of (linear, translation). Row i of a * b is
+// a(i, 0) * b.row0 + a(i, 1) * b.row1 + a(i, 2) * b.row2 + a(i, 3) * (0, 0, 0, 1). A double row
+// is two 16 byte halves, which unlike the 4x4 kernels still beats the scalar code
+using f64x2 = double __attribute__((vector_size(16)));
+
+template<typename T>
+inline constexpr bool fast_affine = enabled<T> || std::is_same_v<T, double>;
+
+template<typename T>
+CBOX_SIMD_INLINE void affine_mul(const T* a, const T* b, T* out) noexcept {
+    if constexpr (enabled<T>) {
+        v4<T> b0 = load(b), b1 = load(b + 4), b2 = load(b + 8);
+        v4<T> w{T{0}, T{0}, T{0}, T{1}};
+        store(out, b0 * a[0] + b1 * a[1] + b2 * a[2] + w * a[3]);
+        store(out + 4, b0 * a[4] + b1 * a[5] + b2 * a[6] + w * a[7]);
+        store(out + 8, b0 * a[8] + b1 * a[9] + b2 * a[10] + w * a[11]);
+    } else {
+        f64x2 b0l, b0h, b1l, b1h, b2l, b2h;
+        __builtin_memcpy(&b0l, b, 16);
+        __builtin_memcpy(&b0h, b + 2, 16);
+        __builtin_memcpy(&b1l, b + 4, 16);
+        __builtin_memcpy(&b1h, b + 6, 16);
+        __builtin_memcpy(&b2l, b + 8, 16);
+        __builtin_memcpy(&b2h, b + 10, 16);
+        for (int i = 0; i < 3; ++i) {
+            const T* x = a + 4 * i;
+            f64x2 lo = b0l * x[0] + b1l * x[1] + b2l * x[2];
+            f64x2 hi = b0h * x[0] + b1h * x[1] + b2h * x[2] + f64x2{T{0}, x[3]};
+            __builtin_memcpy(out + 4 * i, &lo, 16);
+            __builtin_memcpy(out + 4 * i + 2, &hi, 16);
+        }
+    }
+}
+
+} // namespace cc::detail::simd
+
+#undef CBOX_SIMD_INLINE
+
+#else
+
+namespace cc::detail::simd {
+
+template<typename T>
+inline constexpr bool enabled = false;
+template<typename T>
+inline constexpr bool fast_transpose = false;
+template<typename T>
+inline constexpr bool fast_det = false;
+template<typename T>
+inline constexpr bool fast_affine = false;
+
+//NOTE: declared so the `if constexpr (enabled<T>)` branches still name something, never defined
+template<typename T> void mat4_mul(const T* a, const T* b, T* out) noexcept;
+template<typename T> void mat4_mul_vec(const T* m, const T* v, T* out) noexcept;
+template<typename T> void mat4_transpose(const T* m, T* out) noexcept;
+template<typename T> void vec_mul_mat4(const T* v, const T* m, T* out) noexcept;
+template<typename T> T mat4_inverse(const T* m, T* out, T eps) noexcept;
+template<typename T> T mat4_det(const T* m) noexcept;
+template<typename T> void affine_mul(const T* a, const T* b, T* out) noexcept;
+
+} // namespace cc::detail::simd
+
+#endif
@@ -3,6 +3,7 @@
 #include "../mat/fwd.hpp"
 #include "../vec/fwd.hpp"
 #include "../detail/arithmetic.hpp"
+#include "../detail/simd.hpp"
 #include <cstddef>
 
 namespace cc {
@@ -53,6 +54,13 @@ constexpr vec<3, T> operator*(const vec<3, T>& v, const mat<3, 3, T>& m) noexcep
 
 template<arithmetic T>
 constexpr vec<4, T> operator*(const mat<4, 4, T>& m, const vec<4, T>& v) noexcept {
+    if constexpr (detail::simd::enabled<T>) {
+        if !consteval {
+            vec<4, T> r;
+            detail::simd::mat4_mul_vec(m.data(), v.data(), r.data());
+            return r;
+        }
+    }
     return vec<4, T>(
         m(0, 0) * v[0] + m(0, 1) * v[1] + m(0, 2) * v[2] + m(0, 3) * v[3],
         m(1, 0) * v[0] + m(1, 1) * v[1] + m(1, 2) * v[2] + m(1, 3) * v[3],
@@ -63,6 +71,13 @@ constexpr vec<4, T> operator*(const mat<4, 4, T>& m, const vec<4, T>& v) noexcep
 
 template<arithmetic T>
 constexpr vec<4, T> operator*(const vec<4, T>& v, const mat<4, 4, T>& m) noexcept {
+    if constexpr (detail::simd::enabled<T>) {
+        if !consteval {
+            vec<4, T> r;
+            detail::simd::vec_mul_mat4(v.data(), m.data(), r.data());
+            return r;
+        }
+    }
     return vec<4, T>(
         v[0] * m(0, 0) + v[1] * m(1, 0) + v[2] * m(2, 0) + v[3] * m(3, 0),
         v[0] * m(0, 1) + v[1] * m(1, 1) + v[2] * m(2, 1) + v[3] * m(3, 1),
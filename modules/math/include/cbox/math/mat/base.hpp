@@ -3,6 +3,7 @@
 #include "../detail/arithmetic.hpp"
 #include "../common/functions.hpp"
 #include "../common/constants.hpp"
+#include <cbox/core/bulk_copy.hpp>
 #include <array>
 #include <cstddef>
 #include <cassert>
@@ -214,6 +215,10 @@ private:
     std::array<col_type, Cols> data_{};
 };
 
+//NOTE: lets the serializer copy a mat as one block, its columns are packed
+template<std::size_t R, std::size_t C, arithmetic T>
+inline constexpr bool enable_bulk_copy<mat<R, C, T>> = sizeof(mat<R, C, T>) == R * C * sizeof(T);
+
 template<std::size_t R, std::size_t C, std::size_t K, arithmetic T>
 constexpr mat<R, K, T> operator*(const mat<R, C, T>& a, const mat<C, K, T>& b) noexcept {
     mat<R, K, T> r{};
@@ -269,6 +274,7 @@ constexpr T det(const mat<N, N, T>& m) noexcept {
     return sign == 1 ? d : -d;
 }
 
+//NOTE: a singular matrix gives the identity, lu<N, T>::inverse reports it as an error instead
 template<std::size_t N, floating_point T>
 inline mat<N, N, T> inverse(const mat<N, N, T>& m) noexcept {
     mat<N, N, T> a(m);
@@ -2,6 +2,7 @@
 
 #include "fwd.hpp"
 #include "../detail/arithmetic.hpp"
+#include "../detail/simd.hpp"
 #include "../common/functions.hpp"
 #include <array>
 #include <cassert>
@@ -150,7 +151,16 @@ public:
         return a;
     }
 
+    //NOTE: float uses the SIMD kernels at runtime, double and constant evaluation keep the
+    // scalar expressions below
     friend constexpr mat operator*(const mat& a, const mat& b) noexcept {
+        if constexpr (detail::simd::enabled<T>) {
+            if !consteval {
+                mat r;
+                detail::simd::mat4_mul(a.data(), b.data(), r.data());
+                return r;
+            }
+        }
         return mat(layout::rowm,
             a.m00 * b.m00 + a.m01 * b.m10 + a.m02 * b.m20 + a.m03 * b.m30,
             a.m00 * b.m01 + a.m01 * b.m11 + a.m02 * b.m21 + a.m03 * b.m31,
@@ -175,7 +185,14 @@ public:
     }
 
     constexpr mat transpose() const noexcept {
-        return mat(layout::colm,
+        if constexpr (detail::simd::fast_transpose<T>) {
+            if !consteval {
+                mat r;
+                detail::simd::mat4_transpose(data(), r.data());
+                return r;
+            }
+        }
+        return mat(layout::rowm,
             m00, m10, m20, m30,
             m01, m11, m21, m31,
             m02, m12, m22, m32,
@@ -197,6 +214,11 @@ public:
     }
 
     constexpr T det() const noexcept {
+        if constexpr (detail::simd::fast_det<T>) {
+            if !consteval {
+                return detail::simd::mat4_det(data());
+            }
+        }
         T a0 = m00 * m11 - m01 * m10;
         T a1 = m00 * m12 - m02 * m10;
         T a2 = m00 * m13 - m03 * m10;
@@ -214,6 +236,11 @@ public:
     }
 
     mat inverse() const noexcept requires floating_point<T> {
+        if constexpr (detail::simd::enabled<T>) {
+            mat r;
+            T d = detail::simd::mat4_inverse(data(), r.data(), epsilon<T>);
+            return abs(d) > epsilon<T> ? r : identity();
+        }
         T a0 = m00 * m11 - m01 * m10;
         T a1 = m00 * m12 - m02 * m10;
         T a2 = m00 * m13 - m03 * m10;
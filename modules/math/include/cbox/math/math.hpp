@@ -22,6 +22,17 @@
 
 #include "interop/op.hpp"
 #include "interop/transform.hpp"
+
+#include "quat/quat.hpp"
+#include "quat/dualquat.hpp"
+#include "quat/format.hpp"
+
+#include "pose/affine3.hpp"
+#include "pose/rigid3.hpp"
+#include "pose/format.hpp"
+
+#include "batch/points.hpp"
+#include "batch/kernels.hpp"
 // IWYU pragma: end_exports
 
 namespace cc{
@@ -58,4 +69,16 @@ using mat2d = mat2<double>;
 using mat3d = mat3<double>;
 using mat4d = mat4<double>;
 
+using quatf = quat<float>;
+using quatd = quat<double>;
+
+using dualquatf = dualquat<float>;
+using dualquatd = dualquat<double>;
+
+using affine3f = affine3<float>;
+using affine3d = affine3<double>;
+
+using rigid3f = rigid3<float>;
+using rigid3d = rigid3<double>;
+
 }
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../detail/simd.hpp"
+#include "../vec/vec3.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace cc {
+
+//NOTE: 3x4 affine transform, p' = linear * p + translation, with the (0, 0, 0, 1) bottom row of
+// the mat4 implied and never multiplied. Unlike mat, the storage is row major: each row is one
+// 4 lane vector, so compose is three rows of four multiply-adds
+template<floating_point T>
+class affine3 {
+public:
+    static constexpr std::size_t rows = 3;
+    static constexpr std::size_t cols = 4;
+    using value_type = T;
+    using row_type = std::array<T, 4>;
+
+    constexpr affine3() noexcept
+        : rows_{row_type{T{1}, T{0}, T{0}, T{0}}, row_type{T{0}, T{1}, T{0}, T{0}}, row_type{T{0}, T{0}, T{1}, T{0}}} {}
+
+    //NOTE: the twelve values row by row, each row ends with its translation component
+    constexpr affine3(T v00, T v01, T v02, T v03,
+                      T v10, T v11, T v12, T v13,
+                      T v20, T v21, T v22, T v23) noexcept
+        : rows_{row_type{v00, v01, v02, v03}, row_type{v10, v11, v12, v13}, row_type{v20, v21, v22, v23}} {}
+
+    constexpr affine3(const mat<3, 3, T>& linear, const vec<3, T>& translation) noexcept
+        : rows_{row_type{linear(0, 0), linear(0, 1), linear(0, 2), translation[0]},
+                row_type{linear(1, 0), linear(1, 1), linear(1, 2), translation[1]},
+                row_type{linear(2, 0), linear(2, 1), linear(2, 2), translation[2]}} {}
+
+    //NOTE: keeps the top three rows, the bottom row of `m` is assumed to be (0, 0, 0, 1)
+    constexpr explicit affine3(const mat<4, 4, T>& m) noexcept
+        : rows_{row_type{m(0, 0), m(0, 1), m(0, 2), m(0, 3)},
+                row_type{m(1, 0), m(1, 1), m(1, 2), m(1, 3)},
+                row_type{m(2, 0), m(2, 1), m(2, 2), m(2, 3)}} {}
+
+    template<floating_point U>
+    constexpr explicit affine3(const affine3<U>& other) noexcept {
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                rows_[r][c] = static_cast<T>(other(r, c));
+            }
+        }
+    }
+
+    static constexpr affine3 identity() noexcept { return {}; }
+
+    static constexpr affine3 from_translation(const vec<3, T>& t) noexcept {
+        return {mat<3, 3, T>::identity(), t};
+    }
+
+    static constexpr affine3 from_scale(const vec<3, T>& s) noexcept {
+        return {mat<3, 3, T>(layout::rowm,
+                             s[0], T{0}, T{0},
+                             T{0}, s[1], T{0},
+                             T{0}, T{0}, s[2]),
+                vec<3, T>{}};
+    }
+
+    constexpr T& operator()(std::size_t r, std::size_t c) noexcept {
+        assert(r < 3 && c < 4);
+        return rows_[r][c];
+    }
+
+    constexpr const T& operator()(std::size_t r, std::size_t c) const noexcept {
+        assert(r < 3 && c < 4);
+        return rows_[r][c];
+    }
+
+    constexpr row_type& row(std::size_t r) noexcept {
+        assert(r < 3);
+        return rows_[r];
+    }
+
+    constexpr const row_type& row(std::size_t r) const noexcept {
+        assert(r < 3);
+        return rows_[r];
+    }
+
+    constexpr T* data() noexcept { return &rows_[0][0]; }
+    constexpr const T* data() const noexcept { return &rows_[0][0]; }
+
+    constexpr mat<3, 3, T> linear() const noexcept {
+        return mat<3, 3, T>(layout::rowm,
+                            rows_[0][0], rows_[0][1], rows_[0][2],
+                            rows_[1][0], rows_[1][1], rows_[1][2],
+                            rows_[2][0], rows_[2][1], rows_[2][2]);
+    }
+
+    constexpr vec<3, T> translation() const noexcept { return {rows_[0][3], rows_[1][3], rows_[2][3]}; }
+
+    constexpr void set_translation(const vec<3, T>& t) noexcept {
+        rows_[0][3] = t[0];
+        rows_[1][3] = t[1];
+        rows_[2][3] = t[2];
+    }
+
+    constexpr mat<4, 4, T> to_mat4() const noexcept {
+        return mat<4, 4, T>(layout::rowm,
+                            rows_[0][0], rows_[0][1], rows_[0][2], rows_[0][3],
+                            rows_[1][0], rows_[1][1], rows_[1][2], rows_[1][3],
+                            rows_[2][0], rows_[2][1], rows_[2][2], rows_[2][3],
+                            T{0},        T{0},        T{0},        T{1});
+    }
+
+    constexpr vec<3, T> transform_vector(const vec<3, T>& v) const noexcept {
+        return {rows_[0][0] * v[0] + rows_[0][1] * v[1] + rows_[0][2] * v[2],
+                rows_[1][0] * v[0] + rows_[1][1] * v[1] + rows_[1][2] * v[2],
+                rows_[2][0] * v[0] + rows_[2][1] * v[1] + rows_[2][2] * v[2]};
+    }
+
+    constexpr vec<3, T> transform_point(const vec<3, T>& p) const noexcept {
+        return {rows_[0][0] * p[0] + rows_[0][1] * p[1] + rows_[0][2] * p[2] + rows_[0][3],
+                rows_[1][0] * p[0] + rows_[1][1] * p[1] + rows_[1][2] * p[2] + rows_[1][3],
+                rows_[2][0] * p[0] + rows_[2][1] * p[1] + rows_[2][2] * p[2] + rows_[2][3]};
+    }
+
+    //NOTE: a 3x3 inverse instead of the 4x4 one. Like mat::inverse, a singular linear part gives
+    // the identity transform. rigid3 inverts a rotation with a transpose instead
+    affine3 inverse() const noexcept {
+        mat<3, 3, T> l = linear();
+        if (abs(l.det()) <= epsilon<T>) {
+            return identity();
+        }
+        mat<3, 3, T> inv = l.inverse();
+        vec<3, T> t = translation();
+        return {inv, -vec<3, T>(inv(0, 0) * t[0] + inv(0, 1) * t[1] + inv(0, 2) * t[2],
+                                inv(1, 0) * t[0] + inv(1, 1) * t[1] + inv(1, 2) * t[2],
+                                inv(2, 0) * t[0] + inv(2, 1) * t[1] + inv(2, 2) * t[2])};
+    }
+
+    friend constexpr affine3 operator*(const affine3& a, const affine3& b) noexcept {
+        if constexpr (detail::simd::fast_affine<T>) {
+            if !consteval {
+                affine3 r;
+                detail::simd::affine_mul(a.data(), b.data(), r.data());
+                return r;
+            }
+        }
+        const auto& x = a.rows_;
+        const auto& y = b.rows_;
+        return affine3(
+            x[0][0] * y[0][0] + x[0][1] * y[1][0] + x[0][2] * y[2][0],
+            x[0][0] * y[0][1] + x[0][1] * y[1][1] + x[0][2] * y[2][1],
+            x[0][0] * y[0][2] + x[0][1] * y[1][2] + x[0][2] * y[2][2],
+            x[0][0] * y[0][3] + x[0][1] * y[1][3] + x[0][2] * y[2][3] + x[0][3],
+
+            x[1][0] * y[0][0] + x[1][1] * y[1][0] + x[1][2] * y[2][0],
+            x[1][0] * y[0][1] + x[1][1] * y[1][1] + x[1][2] * y[2][1],
+            x[1][0] * y[0][2] + x[1][1] * y[1][2] + x[1][2] * y[2][2],
+            x[1][0] * y[0][3] + x[1][1] * y[1][3] + x[1][2] * y[2][3] + x[1][3],
+
+            x[2][0] * y[0][0] + x[2][1] * y[1][0] + x[2][2] * y[2][0],
+            x[2][0] * y[0][1] + x[2][1] * y[1][1] + x[2][2] * y[2][1],
+            x[2][0] * y[0][2] + x[2][1] * y[1][2] + x[2][2] * y[2][2],
+            x[2][0] * y[0][3] + x[2][1] * y[1][3] + x[2][2] * y[2][3] + x[2][3]
+        );
+    }
+
+    friend constexpr vec<3, T> operator*(const affine3& a, const vec<3, T>& p) noexcept {
+        return a.transform_point(p);
+    }
+
+    constexpr affine3& operator*=(const affine3& rhs) noexcept {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    friend constexpr bool operator==(const affine3& a, const affine3& b) noexcept {
+        for (std::size_t r = 0; r < 3; ++r) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                if (!approx_equal(a.rows_[r][c], b.rows_[r][c])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    std::array<row_type, 3> rows_;
+};
+
+}
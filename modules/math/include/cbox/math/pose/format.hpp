@@ -0,0 +1,36 @@
+#pragma once
+#include <format>
+#include "./affine3.hpp"
+#include "./rigid3.hpp"
+
+namespace std {
+template <cc::floating_point T>
+struct formatter<cc::affine3<T>> {
+    constexpr auto parse(std::format_parse_context& ctx) { return ctx.begin(); }
+
+    auto format(const cc::affine3<T>& a, std::format_context& ctx) const {
+        auto out = ctx.out();
+        out = std::format_to(out, "affine3(\n");
+        for (std::size_t i = 0; i < 3; ++i) {
+            out = std::format_to(out, "  [{}, {}, {}, {}]{}\n", a(i, 0), a(i, 1), a(i, 2), a(i, 3),
+                                 i + 1 < 3 ? "," : "");
+        }
+        return std::format_to(out, ")");
+    }
+};
+
+template <cc::floating_point T>
+struct formatter<cc::rigid3<T>> {
+    constexpr auto parse(std::format_parse_context& ctx) { return ctx.begin(); }
+
+    auto format(const cc::rigid3<T>& r, std::format_context& ctx) const {
+        auto out = ctx.out();
+        out = std::format_to(out, "rigid3(\n");
+        for (std::size_t i = 0; i < 3; ++i) {
+            out = std::format_to(out, "  [{}, {}, {}, {}]{}\n", r(i, 0), r(i, 1), r(i, 2), r(i, 3),
+                                 i + 1 < 3 ? "," : "");
+        }
+        return std::format_to(out, ")");
+    }
+};
+} // namespace std
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "affine3.hpp"
+#include "../quat/quat.hpp"
+#include "../quat/dualquat.hpp"
+
+namespace cc {
+
+//NOTE: rotation followed by translation, the usual camera pose or extrinsic. Same storage as
+// affine3, but the linear part is known to be orthonormal so the inverse is a transpose. Converts
+// implicitly to affine3 and losslessly to mat4
+template<floating_point T>
+class rigid3 {
+public:
+    using value_type = T;
+
+    constexpr rigid3() noexcept = default;
+    constexpr rigid3(const mat<3, 3, T>& rotation, const vec<3, T>& translation) noexcept
+        : m_(rotation, translation) {}
+    constexpr rigid3(const quat<T>& rotation, const vec<3, T>& translation) noexcept
+        : m_(rotation.to_mat3(), translation) {}
+
+    constexpr explicit rigid3(const dualquat<T>& q) noexcept : m_(q.real.to_mat3(), q.translation()) {}
+
+    //NOTE: the upper 3x3 of `m` is taken as is and must already be a rotation
+    constexpr explicit rigid3(const mat<4, 4, T>& m) noexcept : m_(m) {}
+
+    template<floating_point U>
+    constexpr explicit rigid3(const rigid3<U>& other) noexcept : m_(affine3<U>(other)) {}
+
+    static constexpr rigid3 identity() noexcept { return {}; }
+
+    static constexpr rigid3 from_translation(const vec<3, T>& t) noexcept {
+        return {mat<3, 3, T>::identity(), t};
+    }
+
+    constexpr operator const affine3<T>&() const noexcept { return m_; }
+
+    constexpr const T& operator()(std::size_t r, std::size_t c) const noexcept { return m_(r, c); }
+    constexpr const T* data() const noexcept { return m_.data(); }
+
+    constexpr mat<3, 3, T> rotation() const noexcept { return m_.linear(); }
+    constexpr vec<3, T> translation() const noexcept { return m_.translation(); }
+    constexpr void set_translation(const vec<3, T>& t) noexcept { m_.set_translation(t); }
+
+    constexpr mat<4, 4, T> to_mat4() const noexcept { return m_.to_mat4(); }
+
+    quat<T> to_quat() const noexcept { return quat<T>::from_mat(rotation()); }
+
+    dualquat<T> to_dualquat() const noexcept { return {to_quat(), translation()}; }
+
+    constexpr vec<3, T> transform_point(const vec<3, T>& p) const noexcept { return m_.transform_point(p); }
+
+    constexpr vec<3, T> transform_vector(const vec<3, T>& v) const noexcept { return m_.transform_vector(v); }
+
+    //NOTE: (R, t)^-1 = (R^T, -R^T t), no determinant and no division
+    constexpr rigid3 inverse() const noexcept {
+        const affine3<T>& m = m_;
+        T tx = m(0, 3), ty = m(1, 3), tz = m(2, 3);
+        return rigid3(affine3<T>(
+            m(0, 0), m(1, 0), m(2, 0), -(m(0, 0) * tx + m(1, 0) * ty + m(2, 0) * tz),
+            m(0, 1), m(1, 1), m(2, 1), -(m(0, 1) * tx + m(1, 1) * ty + m(2, 1) * tz),
+            m(0, 2), m(1, 2), m(2, 2), -(m(0, 2) * tx + m(1, 2) * ty + m(2, 2) * tz)));
+    }
+
+    //NOTE: Gram-Schmidt on the columns, for long chains of composed poses that drift away from
+    // orthonormal. The first column keeps its direction
+    rigid3 norm() const noexcept {
+        vec<3, T> x{m_(0, 0), m_(1, 0), m_(2, 0)};
+        vec<3, T> y{m_(0, 1), m_(1, 1), m_(2, 1)};
+        x = x.norm();
+        y = (y - x * x.dot(y)).norm();
+        vec<3, T> z = x.cross(y);
+        return {mat<3, 3, T>(layout::colm, x.x, x.y, x.z, y.x, y.y, y.z, z.x, z.y, z.z), translation()};
+    }
+
+    friend constexpr rigid3 operator*(const rigid3& a, const rigid3& b) noexcept { return rigid3(a.m_ * b.m_); }
+
+    friend constexpr vec<3, T> operator*(const rigid3& a, const vec<3, T>& p) noexcept {
+        return a.transform_point(p);
+    }
+
+    constexpr rigid3& operator*=(const rigid3& rhs) noexcept {
+        m_ *= rhs.m_;
+        return *this;
+    }
+
+    friend constexpr bool operator==(const rigid3& a, const rigid3& b) noexcept { return a.m_ == b.m_; }
+
+private:
+    constexpr explicit rigid3(const affine3<T>& m) noexcept : m_(m) {}
+
+    affine3<T> m_;
+};
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "quat.hpp"
+
+namespace cc {
+
+//NOTE: rigid transform as real + dual e with e^2 = 0. The real part is the rotation, the dual part
+// is t * real / 2 for a translation t applied after it. Like quat, `a * b` applies `b` first
+template<floating_point T>
+class dualquat {
+public:
+    using value_type = T;
+
+    quat<T> real{};
+    quat<T> dual{T{0}, T{0}, T{0}, T{0}};
+
+    constexpr dualquat() noexcept = default;
+    constexpr dualquat(const quat<T>& real_, const quat<T>& dual_) noexcept : real(real_), dual(dual_) {}
+
+    //NOTE: rotate by `rotation`, then translate by `translation`
+    constexpr dualquat(const quat<T>& rotation, const vec<3, T>& translation) noexcept
+        : real(rotation), dual(quat<T>(translation, T{0}) * rotation * T{0.5}) {}
+
+    template<floating_point U>
+    constexpr explicit dualquat(const dualquat<U>& other) noexcept
+        : real(quat<T>(other.real)), dual(quat<T>(other.dual)) {}
+
+    static constexpr dualquat identity() noexcept { return {}; }
+
+    static constexpr dualquat from_translation(const vec<3, T>& translation) noexcept {
+        return {quat<T>::identity(), translation};
+    }
+
+    //NOTE: `m` must be rigid, a rotation in the upper 3x3 and a translation in the last column
+    static dualquat from_mat(const mat<4, 4, T>& m) noexcept {
+        return {quat<T>::from_mat(m), vec<3, T>(m(0, 3), m(1, 3), m(2, 3))};
+    }
+
+    constexpr const quat<T>& rotation() const noexcept { return real; }
+
+    constexpr vec<3, T> translation() const noexcept {
+        return (dual * real.conjugate()).xyz() * T{2};
+    }
+
+    //NOTE: scales both parts by 1 / |real|, which keeps rotation and translation intact
+    dualquat norm() const noexcept {
+        T l = real.len();
+        assert(l > T{0});
+        T inv = T{1} / l;
+        return {real * inv, dual * inv};
+    }
+
+    //NOTE: the inverse of a unit dual quaternion
+    constexpr dualquat conjugate() const noexcept { return {real.conjugate(), dual.conjugate()}; }
+
+    constexpr vec<3, T> transform_point(const vec<3, T>& p) const noexcept {
+        return real.rotate(p) + translation();
+    }
+
+    constexpr vec<3, T> transform_vector(const vec<3, T>& v) const noexcept { return real.rotate(v); }
+
+    constexpr mat<4, 4, T> to_mat4() const noexcept {
+        mat<4, 4, T> m = real.to_mat4();
+        vec<3, T> t = translation();
+        m(0, 3) = t.x;
+        m(1, 3) = t.y;
+        m(2, 3) = t.z;
+        return m;
+    }
+
+    constexpr dualquat& operator*=(const dualquat& rhs) noexcept {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    friend constexpr dualquat operator*(const dualquat& a, const dualquat& b) noexcept {
+        return {a.real * b.real, a.real * b.dual + a.dual * b.real};
+    }
+
+    friend constexpr dualquat operator*(const dualquat& q, T s) noexcept { return {q.real * s, q.dual * s}; }
+    friend constexpr dualquat operator*(T s, const dualquat& q) noexcept { return {q.real * s, q.dual * s}; }
+    friend constexpr dualquat operator+(const dualquat& a, const dualquat& b) noexcept {
+        return {a.real + b.real, a.dual + b.dual};
+    }
+    friend constexpr dualquat operator-(const dualquat& q) noexcept { return {-q.real, -q.dual}; }
+
+    friend constexpr bool operator==(const dualquat& a, const dualquat& b) noexcept = default;
+};
+
+//NOTE: dual quaternion linear blending, the usual choice for skinning. The rotation follows nlerp
+// and the translation does not move along a screw, use sclerp where that matters
+template<floating_point T>
+dualquat<T> nlerp(const dualquat<T>& a, const dualquat<T>& b, T t) noexcept {
+    dualquat<T> end = a.real.dot(b.real) < T{0} ? -b : b;
+    return (a * (T{1} - t) + end * t).norm();
+}
+
+namespace detail {
+
+//NOTE: q^t for a unit dual quaternion, written as a screw (angle theta about axis l, slide d along
+// it, moment m) where the power only scales theta and d
+template<floating_point T>
+dualquat<T> screw_pow(const dualquat<T>& q, T t) noexcept {
+    const quat<T>& r = q.real;
+    T half = std::acos(clamp(r.w, T{-1}, T{1}));
+    T s = std::sin(half);
+    if (abs(s) < epsilon<T> * T{64}) {
+        //NOTE: no rotation, a pure translation scales linearly
+        return dualquat<T>(quat<T>::identity(), q.translation() * t);
+    }
+
+    T inv_s = T{1} / s;
+    vec<3, T> axis = r.xyz() * inv_s;
+    T slide = T{-2} * q.dual.w * inv_s;
+    vec<3, T> moment = (q.dual.xyz() - axis * (slide * T{0.5} * r.w)) * inv_s;
+
+    T half_t = half * t;
+    T slide_t = slide * t;
+    T st = std::sin(half_t), ct = std::cos(half_t);
+    return {quat<T>(axis * st, ct), quat<T>(axis * (ct * slide_t * T{0.5}) + moment * st, -slide_t * T{0.5} * st)};
+}
+
+} // namespace detail
+
+//NOTE: screw linear interpolation, constant speed along the screw motion from `a` to `b`
+template<floating_point T>
+dualquat<T> sclerp(const dualquat<T>& a, const dualquat<T>& b, T t) noexcept {
+    dualquat<T> end = a.real.dot(b.real) < T{0} ? -b : b;
+    return a * detail::screw_pow(a.conjugate() * end, t);
+}
+
+}
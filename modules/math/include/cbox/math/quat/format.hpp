@@ -0,0 +1,25 @@
+#pragma once
+#include <format>
+#include "./quat.hpp"
+#include "./dualquat.hpp"
+
+namespace std {
+template <cc::floating_point T>
+struct formatter<cc::quat<T>> {
+    constexpr auto parse(std::format_parse_context& ctx) { return ctx.begin(); }
+
+    auto format(const cc::quat<T>& q, std::format_context& ctx) const {
+        return std::format_to(ctx.out(), "quat({}, {}, {}, {})", q.x, q.y, q.z, q.w);
+    }
+};
+
+template <cc::floating_point T>
+struct formatter<cc::dualquat<T>> {
+    constexpr auto parse(std::format_parse_context& ctx) { return ctx.begin(); }
+
+    auto format(const cc::dualquat<T>& q, std::format_context& ctx) const {
+        return std::format_to(ctx.out(), "dualquat({}, {}, {}, {} | {}, {}, {}, {})", q.real.x, q.real.y, q.real.z,
+                              q.real.w, q.dual.x, q.dual.y, q.dual.z, q.dual.w);
+    }
+};
+} // namespace std
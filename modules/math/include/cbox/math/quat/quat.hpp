@@ -0,0 +1,243 @@
+#pragma once
+
+#include "../detail/arithmetic.hpp"
+#include "../common/functions.hpp"
+#include "../common/constants.hpp"
+#include "../vec/vec3.hpp"
+#include "../vec/vec4.hpp"
+#include "../mat/mat3.hpp"
+#include "../mat/mat4.hpp"
+
+#include <cassert>
+#include <cmath>
+
+namespace cc {
+
+//NOTE: rotation quaternion x i + y j + z k + w. Composition follows the matrices, `a * b` rotates
+// by `b` first and then by `a`, and to_mat3(a * b) == to_mat3(a) * to_mat3(b)
+template<floating_point T>
+class quat {
+public:
+    using value_type = T;
+
+    T x{0};
+    T y{0};
+    T z{0};
+    T w{1};
+
+    constexpr quat() noexcept = default;
+    constexpr quat(T x_, T y_, T z_, T w_) noexcept : x(x_), y(y_), z(z_), w(w_) {}
+    constexpr quat(const vec<3, T>& v, T w_) noexcept : x(v.x), y(v.y), z(v.z), w(w_) {}
+
+    template<floating_point U>
+    constexpr explicit quat(const quat<U>& other) noexcept
+        : x(static_cast<T>(other.x)), y(static_cast<T>(other.y)), z(static_cast<T>(other.z)),
+          w(static_cast<T>(other.w)) {}
+
+    static constexpr quat identity() noexcept { return {}; }
+
+    //NOTE: `axis` must be unit length
+    static quat from_axis_angle(const vec<3, T>& axis, T angle) noexcept {
+        T s = std::sin(angle * T{0.5});
+        return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * T{0.5})};
+    }
+
+    static quat rotation_x(T angle) noexcept {
+        return {std::sin(angle * T{0.5}), T{0}, T{0}, std::cos(angle * T{0.5})};
+    }
+
+    static quat rotation_y(T angle) noexcept {
+        return {T{0}, std::sin(angle * T{0.5}), T{0}, std::cos(angle * T{0.5})};
+    }
+
+    static quat rotation_z(T angle) noexcept {
+        return {T{0}, T{0}, std::sin(angle * T{0.5}), std::cos(angle * T{0.5})};
+    }
+
+    //NOTE: same convention as rotate(const vec3&), rotation_x * rotation_y * rotation_z
+    static quat from_euler(const vec<3, T>& angles) noexcept {
+        T cx = std::cos(angles.x * T{0.5}), sx = std::sin(angles.x * T{0.5});
+        T cy = std::cos(angles.y * T{0.5}), sy = std::sin(angles.y * T{0.5});
+        T cz = std::cos(angles.z * T{0.5}), sz = std::sin(angles.z * T{0.5});
+        return {sx * cy * cz + cx * sy * sz,
+                cx * sy * cz - sx * cy * sz,
+                cx * cy * sz + sx * sy * cz,
+                cx * cy * cz - sx * sy * sz};
+    }
+
+    //NOTE: the rotation part of `m`, which must be orthonormal (Shepperd's method, branches on the
+    // largest diagonal term so the square root never sees a small argument)
+    static quat from_mat(const mat<3, 3, T>& m) noexcept {
+        T trace = m(0, 0) + m(1, 1) + m(2, 2);
+        if (trace > T{0}) {
+            T s = std::sqrt(trace + T{1}) * T{2};
+            return {(m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s, (m(1, 0) - m(0, 1)) / s, s * T{0.25}};
+        }
+        if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2)) {
+            T s = std::sqrt(T{1} + m(0, 0) - m(1, 1) - m(2, 2)) * T{2};
+            return {s * T{0.25}, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s, (m(2, 1) - m(1, 2)) / s};
+        }
+        if (m(1, 1) > m(2, 2)) {
+            T s = std::sqrt(T{1} + m(1, 1) - m(0, 0) - m(2, 2)) * T{2};
+            return {(m(0, 1) + m(1, 0)) / s, s * T{0.25}, (m(1, 2) + m(2, 1)) / s, (m(0, 2) - m(2, 0)) / s};
+        }
+        T s = std::sqrt(T{1} + m(2, 2) - m(0, 0) - m(1, 1)) * T{2};
+        return {(m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, s * T{0.25}, (m(1, 0) - m(0, 1)) / s};
+    }
+
+    static quat from_mat(const mat<4, 4, T>& m) noexcept {
+        return from_mat(mat<3, 3, T>(layout::rowm,
+                                     m(0, 0), m(0, 1), m(0, 2),
+                                     m(1, 0), m(1, 1), m(1, 2),
+                                     m(2, 0), m(2, 1), m(2, 2)));
+    }
+
+    constexpr vec<3, T> xyz() const noexcept { return {x, y, z}; }
+
+    constexpr T dot(const quat& other) const noexcept {
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+    }
+
+    constexpr T len_squared() const noexcept { return dot(*this); }
+
+    T len() const noexcept { return std::sqrt(len_squared()); }
+
+    quat norm() const noexcept {
+        T l = len();
+        assert(l > T{0});
+        T inv = T{1} / l;
+        return {x * inv, y * inv, z * inv, w * inv};
+    }
+
+    constexpr quat conjugate() const noexcept { return {-x, -y, -z, w}; }
+
+    constexpr quat inverse() const noexcept {
+        T l = len_squared();
+        assert(l > T{0});
+        return {-x / l, -y / l, -z / l, w / l};
+    }
+
+    //NOTE: v' = v + 2w (q x v) + 2 q x (q x v), cheaper than building the matrix for one vector.
+    // Assumes a unit quaternion
+    constexpr vec<3, T> rotate(const vec<3, T>& v) const noexcept {
+        vec<3, T> q = xyz();
+        vec<3, T> t = q.cross(v) * T{2};
+        return v + t * w + q.cross(t);
+    }
+
+    constexpr mat<3, 3, T> to_mat3() const noexcept {
+        T xx = x * x, yy = y * y, zz = z * z;
+        T xy = x * y, xz = x * z, yz = y * z;
+        T wx = w * x, wy = w * y, wz = w * z;
+        return mat<3, 3, T>(layout::rowm,
+                            T{1} - T{2} * (yy + zz), T{2} * (xy - wz),        T{2} * (xz + wy),
+                            T{2} * (xy + wz),        T{1} - T{2} * (xx + zz), T{2} * (yz - wx),
+                            T{2} * (xz - wy),        T{2} * (yz + wx),        T{1} - T{2} * (xx + yy));
+    }
+
+    constexpr mat<4, 4, T> to_mat4() const noexcept {
+        T xx = x * x, yy = y * y, zz = z * z;
+        T xy = x * y, xz = x * z, yz = y * z;
+        T wx = w * x, wy = w * y, wz = w * z;
+        return mat<4, 4, T>(layout::rowm,
+                            T{1} - T{2} * (yy + zz), T{2} * (xy - wz),        T{2} * (xz + wy),        T{0},
+                            T{2} * (xy + wz),        T{1} - T{2} * (xx + zz), T{2} * (yz - wx),        T{0},
+                            T{2} * (xz - wy),        T{2} * (yz + wx),        T{1} - T{2} * (xx + yy), T{0},
+                            T{0},                    T{0},                    T{0},                    T{1});
+    }
+
+    //NOTE: inverse of from_euler, the middle angle stays in [-pi/2, pi/2]. It is the atan2 of r02
+    // against the rest of its column, asin(r02) loses most of the digits float has left near +-1.
+    // z is solved from Rx(x)^T R, so it matches whatever x is and the angles rebuild the rotation
+    // even where x and z are ill conditioned. Once cos(y) is rounding noise z is folded into x
+    vec<3, T> to_euler() const noexcept {
+        T r02 = T{2} * (x * z + w * y);
+        T r12 = T{2} * (y * z - w * x);
+        T r22 = T{1} - T{2} * (x * x + y * y);
+        T r10 = T{2} * (x * y + w * z);
+        T r11 = T{1} - T{2} * (x * x + z * z);
+        T r20 = T{2} * (x * z - w * y);
+        T r21 = T{2} * (y * z + w * x);
+
+        T cos_y = std::sqrt(r12 * r12 + r22 * r22);
+        T ax = cos_y <= epsilon<T> * T{16} ? std::atan2(r21, r11) : std::atan2(-r12, r22);
+        T ay = std::atan2(r02, cos_y);
+        T cx = std::cos(ax), sx = std::sin(ax);
+        T az = std::atan2(cx * r10 + sx * r20, cx * r11 + sx * r21);
+        return {ax, ay, az};
+    }
+
+    constexpr quat& operator*=(const quat& rhs) noexcept {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    constexpr quat& operator*=(T s) noexcept {
+        x *= s;
+        y *= s;
+        z *= s;
+        w *= s;
+        return *this;
+    }
+
+    constexpr quat& operator+=(const quat& rhs) noexcept {
+        x += rhs.x;
+        y += rhs.y;
+        z += rhs.z;
+        w += rhs.w;
+        return *this;
+    }
+
+    constexpr quat& operator-=(const quat& rhs) noexcept {
+        x -= rhs.x;
+        y -= rhs.y;
+        z -= rhs.z;
+        w -= rhs.w;
+        return *this;
+    }
+
+    friend constexpr quat operator*(const quat& a, const quat& b) noexcept {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+
+    friend constexpr vec<3, T> operator*(const quat& q, const vec<3, T>& v) noexcept { return q.rotate(v); }
+
+    friend constexpr quat operator*(quat q, T s) noexcept { return q *= s; }
+    friend constexpr quat operator*(T s, quat q) noexcept { return q *= s; }
+    friend constexpr quat operator+(quat a, const quat& b) noexcept { return a += b; }
+    friend constexpr quat operator-(quat a, const quat& b) noexcept { return a -= b; }
+    friend constexpr quat operator-(const quat& q) noexcept { return {-q.x, -q.y, -q.z, -q.w}; }
+
+    friend constexpr bool operator==(const quat& a, const quat& b) noexcept = default;
+};
+
+//NOTE: normalized linear interpolation along the shorter arc. Not constant speed, but for the
+// small steps of per frame animation it is indistinguishable from slerp and much cheaper
+template<floating_point T>
+quat<T> nlerp(const quat<T>& a, const quat<T>& b, T t) noexcept {
+    quat<T> end = a.dot(b) < T{0} ? -b : b;
+    return (a * (T{1} - t) + end * t).norm();
+}
+
+//NOTE: constant speed interpolation along the shorter arc, falls back to nlerp when the two are
+// close enough that sin(theta) loses precision
+template<floating_point T>
+quat<T> slerp(const quat<T>& a, const quat<T>& b, T t) noexcept {
+    T d = a.dot(b);
+    quat<T> end = b;
+    if (d < T{0}) {
+        d = -d;
+        end = -b;
+    }
+    if (d > T{1} - epsilon<T> * T{64}) {
+        return nlerp(a, end, t);
+    }
+    T theta = std::acos(d);
+    T inv_sin = T{1} / std::sin(theta);
+    return a * (std::sin((T{1} - t) * theta) * inv_sin) + end * (std::sin(t * theta) * inv_sin);
+}
+
+}
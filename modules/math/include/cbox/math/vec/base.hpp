@@ -2,6 +2,7 @@
 
 #include "../detail/arithmetic.hpp"
 #include "../common/functions.hpp"
+#include <cbox/core/bulk_copy.hpp>
 #include <array>
 #include <cassert>
 #include <cstddef>
@@ -175,4 +176,8 @@ private:
     std::array<T, N> data_{};
 };
 
+//NOTE: lets the serializer copy a vec as one block, vec2 to vec4 hold N packed values too
+template<std::size_t N, arithmetic T>
+inline constexpr bool enable_bulk_copy<vec<N, T>> = sizeof(vec<N, T>) == N * sizeof(T);
+
 }
@@ -0,0 +1,280 @@
+#include <cbox/math/batch/kernels.hpp>
+#include <cbox/core/cpu.hpp>
+#include <limits>
+
+//NOTE: one loop body per kernel, instantiated for a vector type inside functions that carry the
+// matching target attribute. Vector extensions keep the body readable and no vector ever crosses
+// a call, so the units compiled for the baseline ISA see no AVX types in signatures
+#if CBOX_CPU_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CBOX_BATCH_SIMD 1
+#define CBOX_BATCH_INLINE inline __attribute__((always_inline))
+#else
+#define CBOX_BATCH_SIMD 0
+#endif
+
+namespace cc {
+
+namespace {
+
+template<typename T>
+struct transform_args {
+    const T* m;
+    const T* x;
+    const T* y;
+    const T* z;
+    T* ox;
+    T* oy;
+    T* oz;
+    std::size_t n;
+};
+
+template<typename T>
+struct project_args {
+    const T* m;  // world to camera, null for project()
+    pinhole<T> k;
+    const T* x;
+    const T* y;
+    const T* z;
+    T* ou;
+    T* ov;
+    std::size_t n;
+};
+
+template<typename T>
+struct normalize_args {
+    pinhole<T> k;
+    const T* u;
+    const T* v;
+    T* ox;
+    T* oy;
+    std::size_t n;
+};
+
+template<typename T>
+inline constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+
+template<typename T>
+void transform_scalar(const transform_args<T>& a) {
+    const T* m = a.m;
+    for (std::size_t i = 0; i < a.n; ++i) {
+        T x = a.x[i], y = a.y[i], z = a.z[i];
+        a.ox[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+        a.oy[i] = m[1] * x + m[5] * y + m[9] * z + m[13];
+        a.oz[i] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    }
+}
+
+template<typename T>
+std::size_t project_scalar(const project_args<T>& a) {
+    const T* m = a.m;
+    std::size_t front = 0;
+    for (std::size_t i = 0; i < a.n; ++i) {
+        T x = a.x[i], y = a.y[i], z = a.z[i];
+        if (m != nullptr) {
+            T cx = m[0] * x + m[4] * y + m[8] * z + m[12];
+            T cy = m[1] * x + m[5] * y + m[9] * z + m[13];
+            T cz = m[2] * x + m[6] * y + m[10] * z + m[14];
+            x = cx;
+            y = cy;
+            z = cz;
+        }
+        if (z > T{0}) {
+            T inv = T{1} / z;
+            a.ou[i] = a.k.fx * x * inv + a.k.cx;
+            a.ov[i] = a.k.fy * y * inv + a.k.cy;
+            ++front;
+        } else {
+            a.ou[i] = nan<T>;
+            a.ov[i] = nan<T>;
+        }
+    }
+    return front;
+}
+
+template<typename T>
+void normalize_scalar(const normalize_args<T>& a) {
+    T ifx = T{1} / a.k.fx, ify = T{1} / a.k.fy;
+    for (std::size_t i = 0; i < a.n; ++i) {
+        a.ox[i] = (a.u[i] - a.k.cx) * ifx;
+        a.oy[i] = (a.v[i] - a.k.cy) * ify;
+    }
+}
+
+#if CBOX_BATCH_SIMD
+
+using f32x8 = float __attribute__((vector_size(32)));
+using f32x16 = float __attribute__((vector_size(64)));
+using f64x4 = double __attribute__((vector_size(32)));
+using f64x8 = double __attribute__((vector_size(64)));
+
+template<typename T> struct avx2_lanes;
+template<> struct avx2_lanes<float> { using type = f32x8; };
+template<> struct avx2_lanes<double> { using type = f64x4; };
+
+template<typename T> struct avx512_lanes;
+template<> struct avx512_lanes<float> { using type = f32x16; };
+template<> struct avx512_lanes<double> { using type = f64x8; };
+
+//NOTE: vectors go by reference, a 32 or 64 byte vector by value is an ABI change GCC warns about
+// in a unit compiled for the baseline ISA
+template<typename V, typename T>
+CBOX_BATCH_INLINE void load(V& v, const T* p) noexcept {
+    __builtin_memcpy(&v, p, sizeof(V));
+}
+
+template<typename V, typename T>
+CBOX_BATCH_INLINE void store(T* p, const V& v) noexcept {
+    __builtin_memcpy(p, &v, sizeof(V));
+}
+
+template<typename V, typename T>
+CBOX_BATCH_INLINE void transform_body(const transform_args<T>& a) noexcept {
+    constexpr std::size_t lanes = sizeof(V) / sizeof(T);
+    const T* m = a.m;
+    std::size_t i = 0;
+    for (; i + lanes <= a.n; i += lanes) {
+        V x, y, z;
+        load(x, a.x + i);
+        load(y, a.y + i);
+        load(z, a.z + i);
+        store(a.ox + i, x * m[0] + y * m[4] + z * m[8] + m[12]);
+        store(a.oy + i, x * m[1] + y * m[5] + z * m[9] + m[13]);
+        store(a.oz + i, x * m[2] + y * m[6] + z * m[10] + m[14]);
+    }
+    transform_scalar<T>({m, a.x + i, a.y + i, a.z + i, a.ox + i, a.oy + i, a.oz + i, a.n - i});
+}
+
+template<typename V, typename T>
+CBOX_BATCH_INLINE std::size_t project_body(const project_args<T>& a) noexcept {
+    constexpr std::size_t lanes = sizeof(V) / sizeof(T);
+    const T* m = a.m;
+    V invalid = V{} + nan<T>;
+    decltype(V{} > V{}) front{};
+
+    std::size_t i = 0;
+    for (; i + lanes <= a.n; i += lanes) {
+        V x, y, z;
+        load(x, a.x + i);
+        load(y, a.y + i);
+        load(z, a.z + i);
+        if (m != nullptr) {
+            V cx = x * m[0] + y * m[4] + z * m[8] + m[12];
+            V cy = x * m[1] + y * m[5] + z * m[9] + m[13];
+            V cz = x * m[2] + y * m[6] + z * m[10] + m[14];
+            x = cx;
+            y = cy;
+            z = cz;
+        }
+        auto visible = z > T{0};
+        V inv = T{1} / z;
+        store(a.ou + i, visible ? x * a.k.fx * inv + a.k.cx : invalid);
+        store(a.ov + i, visible ? y * a.k.fy * inv + a.k.cy : invalid);
+        front -= visible;
+    }
+
+    std::size_t count = 0;
+    for (std::size_t l = 0; l < lanes; ++l) {
+        count += static_cast<std::size_t>(front[l]);
+    }
+    return count + project_scalar<T>({m, a.k, a.x + i, a.y + i, a.z + i, a.ou + i, a.ov + i, a.n - i});
+}
+
+template<typename V, typename T>
+CBOX_BATCH_INLINE void normalize_body(const normalize_args<T>& a) noexcept {
+    constexpr std::size_t lanes = sizeof(V) / sizeof(T);
+    T ifx = T{1} / a.k.fx, ify = T{1} / a.k.fy;
+    std::size_t i = 0;
+    for (; i + lanes <= a.n; i += lanes) {
+        V u, v;
+        load(u, a.u + i);
+        load(v, a.v + i);
+        store(a.ox + i, (u - a.k.cx) * ifx);
+        store(a.oy + i, (v - a.k.cy) * ify);
+    }
+    normalize_scalar<T>({a.k, a.u + i, a.v + i, a.ox + i, a.oy + i, a.n - i});
+}
+
+template<typename T>
+CBOX_TARGET_AVX2 void transform_avx2(const transform_args<T>& a) {
+    transform_body<typename avx2_lanes<T>::type>(a);
+}
+
+template<typename T>
+CBOX_TARGET_AVX512 void transform_avx512(const transform_args<T>& a) {
+    transform_body<typename avx512_lanes<T>::type>(a);
+}
+
+template<typename T>
+CBOX_TARGET_AVX2 std::size_t project_avx2(const project_args<T>& a) {
+    return project_body<typename avx2_lanes<T>::type>(a);
+}
+
+template<typename T>
+CBOX_TARGET_AVX512 std::size_t project_avx512(const project_args<T>& a) {
+    return project_body<typename avx512_lanes<T>::type>(a);
+}
+
+template<typename T>
+CBOX_TARGET_AVX2 void normalize_avx2(const normalize_args<T>& a) {
+    normalize_body<typename avx2_lanes<T>::type>(a);
+}
+
+template<typename T>
+CBOX_TARGET_AVX512 void normalize_avx512(const normalize_args<T>& a) {
+    normalize_body<typename avx512_lanes<T>::type>(a);
+}
+
+#define CBOX_BATCH_VARIANTS(name) \
+    {.scalar = name##_scalar<T>, .avx2 = name##_avx2<T>, .avx512 = name##_avx512<T>}
+#else
+#define CBOX_BATCH_VARIANTS(name) {.scalar = name##_scalar<T>}
+#endif
+
+template<typename T>
+std::size_t project_dispatch(const project_args<T>& a) {
+    static cpu::dispatch<std::size_t(const project_args<T>&)> g_project(CBOX_BATCH_VARIANTS(project));
+    return g_project(a);
+}
+
+} // namespace
+
+template<floating_point T>
+void transform(const mat<4, 4, T>& m, const points3<T>& in, points3<T>& out) {
+    static cpu::dispatch<void(const transform_args<T>&)> g_transform(CBOX_BATCH_VARIANTS(transform));
+    out.resize(in.size());
+    g_transform({m.data(), in.data(0), in.data(1), in.data(2), out.data(0), out.data(1), out.data(2), in.size()});
+}
+
+template<floating_point T>
+std::size_t project(const pinhole<T>& k, const points3<T>& in, points2<T>& out) {
+    out.resize(in.size());
+    return project_dispatch<T>({nullptr, k, in.data(0), in.data(1), in.data(2), out.data(0), out.data(1), in.size()});
+}
+
+template<floating_point T>
+std::size_t reproject(const mat<4, 4, T>& world_to_camera, const pinhole<T>& k, const points3<T>& in,
+                      points2<T>& out) {
+    out.resize(in.size());
+    return project_dispatch<T>({world_to_camera.data(), k, in.data(0), in.data(1), in.data(2), out.data(0),
+                                out.data(1), in.size()});
+}
+
+template<floating_point T>
+void normalize(const pinhole<T>& k, const points2<T>& in, points2<T>& out) {
+    static cpu::dispatch<void(const normalize_args<T>&)> g_normalize(CBOX_BATCH_VARIANTS(normalize));
+    out.resize(in.size());
+    g_normalize({k, in.data(0), in.data(1), out.data(0), out.data(1), in.size()});
+}
+
+template void transform<float>(const mat<4, 4, float>&, const points3<float>&, points3<float>&);
+template void transform<double>(const mat<4, 4, double>&, const points3<double>&, points3<double>&);
+template std::size_t project<float>(const pinhole<float>&, const points3<float>&, points2<float>&);
+template std::size_t project<double>(const pinhole<double>&, const points3<double>&, points2<double>&);
+template std::size_t reproject<float>(const mat<4, 4, float>&, const pinhole<float>&, const points3<float>&,
+                                      points2<float>&);
+template std::size_t reproject<double>(const mat<4, 4, double>&, const pinhole<double>&, const points3<double>&,
+                                       points2<double>&);
+template void normalize<float>(const pinhole<float>&, const points2<float>&, points2<float>&);
+template void normalize<double>(const pinhole<double>&, const points2<double>&, points2<double>&);
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdio>
+
+//NOTE: assert that survives NDEBUG. A failed check is printed and the test keeps going, main
+// returns cc_test::exit_code() so ctest fails the test once any check did
+namespace cc_test {
+
+inline int& failures() noexcept {
+    static int count = 0;
+    return count;
+}
+
+//NOTE: not the count itself, exit statuses are taken modulo 256
+inline int exit_code() noexcept {
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace cc_test
+
+#define CC_CHECK(expr)                                                              \
+    do {                                                                            \
+        if (!(expr)) {                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            ++::cc_test::failures();                                                \
+        }                                                                           \
+    } while (0)
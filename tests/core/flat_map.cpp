@@ -0,0 +1,29 @@
+#include "check.hpp"
+#include <cbox/core/flat_map.hpp>
+#include <string>
+#include <string_view>
+
+int main() {
+    cc::flat_map<int, int> m{{3, 4}, {1, 2}, {5, 6}};
+    CC_CHECK(m.size() == 3);
+    CC_CHECK(m.begin()->first == 1);
+
+    auto next = m.erase(m.find(1));
+    CC_CHECK(next != m.end() && next->first == 3);
+    CC_CHECK(!m.contains(1));
+
+    const auto& cm = m;
+    m.erase(cm.find(5));
+    CC_CHECK(m.size() == 1);
+
+    CC_CHECK(m.erase(3) == 1);
+    CC_CHECK(m.erase(3) == 0);
+    CC_CHECK(m.empty());
+
+    cc::flat_map<std::string, int> s{{"a", 1}, {"b", 2}};
+    CC_CHECK(s.erase(std::string_view("a")) == 1);
+    s.erase(s.find("b"));
+    CC_CHECK(s.empty());
+
+    return cc_test::exit_code();
+}
@@ -0,0 +1,76 @@
+#include <cbox/math/decomp.hpp>
+#include <cstdint>
+
+//NOTE: the decompositions are constexpr, so this test checks their rank detection while it
+// compiles and main has nothing left to do. The matrices are random n x n with a last row that is
+// the sum of the first two. Each one is checked once as built and once singular: the rank of lu,
+// qr and svd and whether lu and qr solve must follow. Partial pivoting got some of these seeds
+// wrong. The trial counts stay well inside GCC's default constexpr operation limit, which a few
+// 12x12 trials already exceed
+namespace cc {
+
+namespace {
+
+template<floating_point T>
+struct uniform {
+    std::uint64_t state;
+
+    constexpr T operator()() noexcept {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<T>(state >> 11) * static_cast<T>(0x1p-53) * T{2} - T{1};
+    }
+};
+
+template<std::size_t N, floating_point T>
+constexpr bool rank_detected(std::uint64_t seed, bool singular) noexcept {
+    uniform<T> u{seed};
+    mat<N, N, T> a{};
+    for (std::size_t r = 0; r < N; ++r) {
+        for (std::size_t c = 0; c < N; ++c) {
+            a(r, c) = u();
+        }
+    }
+    if (singular) {
+        for (std::size_t c = 0; c < N; ++c) {
+            a(N - 1, c) = a(0, c) + a(1, c);
+        }
+    }
+
+    vec<N, T> b{};
+    for (std::size_t i = 0; i < N; ++i) {
+        b[i] = u();
+    }
+
+    std::size_t expected = singular ? N - 1 : N;
+    lu<N, T> l(a);
+    qr<N, N, T> q(a);
+    svd<N, N, T> s(a);
+    return l.rank() == expected && q.rank() == expected && s.rank() == expected &&
+           s.converged() && l.solve(b).has_value() != singular && q.solve(b).has_value() != singular;
+}
+
+template<std::size_t N, floating_point T>
+constexpr bool rank_detected(int trials) noexcept {
+    for (int t = 0; t < trials; ++t) {
+        std::uint64_t seed = N * 1000 + static_cast<std::uint64_t>(t);
+        if (!rank_detected<N, T>(seed, false) || !rank_detected<N, T>(seed, true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(rank_detected<3, f64>(32));
+static_assert(rank_detected<4, f64>(32));
+static_assert(rank_detected<6, f64>(8));
+static_assert(rank_detected<12, f64>(1));
+static_assert(rank_detected<3, f32>(16));
+static_assert(rank_detected<6, f32>(8));
+
+} // namespace
+
+} // namespace cc
+
+int main() {
+    return 0;
+}
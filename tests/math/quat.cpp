@@ -0,0 +1,47 @@
+#include "check.hpp"
+#include <cbox/math/math.hpp>
+#include <cmath>
+
+namespace {
+
+//NOTE: angle of the rotation taking a to b, from the vector part so small angles keep their digits
+double angle_between(const cc::quatf& a, const cc::quatf& b) {
+    cc::quatf r = a.conjugate() * b;
+    double v = std::sqrt(double{r.x} * r.x + double{r.y} * r.y + double{r.z} * r.z);
+    return 2.0 * std::atan2(v, std::fabs(double{r.w}));
+}
+
+double roundtrip_error(const cc::vec3f& angles) {
+    cc::quatf q = cc::quatf::from_euler(angles);
+    return angle_between(q, cc::quatf::from_euler(q.to_euler()));
+}
+
+} // namespace
+
+int main() {
+    CC_CHECK(roundtrip_error({2.30f, 1.5728f, -2.97f}) < 1e-5);
+
+    //NOTE: sweeps the middle angle through +-pi/2, where asin(r02) lost up to 2e-3 rad
+    const float half_pi = cc::pi<float> / 2.0f;
+    for (float sign : {1.0f, -1.0f}) {
+        for (int i = -200; i <= 200; ++i) {
+            float y = sign * half_pi + static_cast<float>(i) * 2e-5f;
+            for (float x : {-2.9f, -0.4f, 0.0f, 1.1f, 3.0f}) {
+                for (float z : {-3.1f, -1.0f, 0.0f, 0.6f, 2.5f}) {
+                    CC_CHECK(roundtrip_error({x, y, z}) < 1e-5);
+                }
+            }
+        }
+    }
+
+    cc::vec3f e = cc::quatf::from_euler({0.4f, -half_pi, 0.9f}).to_euler();
+    CC_CHECK(std::fabs(e.y + half_pi) < 1e-6f);
+    CC_CHECK(std::fabs(e.z) < 1e-6f);
+
+    cc::vec3f generic{0.3f, -0.8f, 2.1f};
+    cc::vec3f back = cc::quatf::from_euler(generic).to_euler();
+    CC_CHECK(std::fabs(back.x - generic.x) < 1e-5f && std::fabs(back.y - generic.y) < 1e-5f &&
+             std::fabs(back.z - generic.z) < 1e-5f);
+
+    return cc_test::exit_code();
+}